@@ -5,12 +5,13 @@ uniform sampler2D tex;
 uniform vec4 color;
 uniform float drawType;
 uniform float alpha;
+uniform vec3 imageColor;
 
 void main()
 {
     if (drawType >= 0.1)
     {
-        outColor = texelFetch(tex, ivec2(Texcoord.x, Texcoord.y), 0) * vec4(1.0, 1.0, 1.0, alpha);
+        outColor = texelFetch(tex, ivec2(Texcoord.x, Texcoord.y), 0) * vec4(imageColor, alpha);
     }
     else
     {
@@ -0,0 +1,257 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "actorindex.h"
+
+#include "being/actorsprite.h"
+
+#include "resources/map/mapconsts.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "debug.h"
+
+namespace
+{
+    // grid cell size is (1 << cellShift) tiles
+    const int cellShift = 3;
+    const unsigned int minHashBits = 8;
+
+    void eraseActor(ActorSpriteVector &actors,
+                    const ActorSprite *const actor)
+    {
+        const ActorSpriteVector::iterator it = std::find(
+            actors.begin(), actors.end(), actor);
+        if (it == actors.end())
+            return;
+        *it = actors.back();
+        actors.pop_back();
+    }
+}  // namespace
+
+ActorIndex::ActorIndex() :
+    mHash(1U << minHashBits),
+    mCells(1),
+    mHashBits(minHashBits),
+    mHashCount(0U),
+    mGridWidth(1),
+    mGridHeight(1)
+{
+}
+
+unsigned int ActorIndex::getHashBucket(const int id) const
+{
+    // fibonacci hashing, ids often allocated sequentially
+    return (static_cast<unsigned int>(id) * 2654435761U)
+        >> (32U - mHashBits);
+}
+
+int ActorIndex::getCell(const ActorSprite *const actor) const
+{
+    const Vector &pos = actor->getPosition();
+    int x = (static_cast<int>(pos.x) / mapTileSize) >> cellShift;
+    int y = (static_cast<int>(pos.y) / mapTileSize) >> cellShift;
+    if (x < 0)
+        x = 0;
+    else if (x >= mGridWidth)
+        x = mGridWidth - 1;
+    if (y < 0)
+        y = 0;
+    else if (y >= mGridHeight)
+        y = mGridHeight - 1;
+    return y * mGridWidth + x;
+}
+
+void ActorIndex::setMapSize(const int width, const int height)
+{
+    ActorSpriteVector actors;
+    FOR_EACH (std::vector<ActorSpriteVector>::const_iterator, it, mCells)
+        actors.insert(actors.end(), (*it).begin(), (*it).end());
+
+    mGridWidth = std::max(1, (width + (1 << cellShift) - 1) >> cellShift);
+    mGridHeight = std::max(1, (height + (1 << cellShift) - 1) >> cellShift);
+    mCells.clear();
+    mCells.resize(mGridWidth * mGridHeight);
+
+    FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
+        addToCell(*it, getCell(*it));
+}
+
+void ActorIndex::add(ActorSprite *const actor)
+{
+    if (!actor)
+        return;
+
+    remove(actor);
+    if (mHashCount >= mHash.size())
+        rehash(mHashBits + 1);
+    mHash[getHashBucket(actor->getId())].push_back(actor);
+    mHashCount ++;
+    addToCell(actor, getCell(actor));
+}
+
+void ActorIndex::remove(ActorSprite *const actor)
+{
+    if (!actor || actor->getIndexCell() < 0)
+        return;
+
+    ActorSpriteVector &bucket = mHash[getHashBucket(actor->getId())];
+    const size_t sz = bucket.size();
+    eraseActor(bucket, actor);
+    if (bucket.size() != sz)
+        mHashCount --;
+    removeFromCell(actor);
+}
+
+void ActorIndex::clear()
+{
+    FOR_EACH (std::vector<ActorSpriteVector>::iterator, it, mHash)
+        (*it).clear();
+    FOR_EACH (std::vector<ActorSpriteVector>::iterator, it, mCells)
+        (*it).clear();
+    mHashCount = 0U;
+}
+
+void ActorIndex::changeId(ActorSprite *const actor, const int newId)
+{
+    if (!actor || actor->getIndexCell() < 0)
+        return;
+
+    eraseActor(mHash[getHashBucket(actor->getId())], actor);
+    mHash[getHashBucket(newId)].push_back(actor);
+}
+
+void ActorIndex::updatePosition(ActorSprite *const actor)
+{
+    const int oldCell = actor->getIndexCell();
+    if (oldCell < 0)
+        return;
+    const int cell = getCell(actor);
+    if (cell == oldCell)
+        return;
+    eraseActor(mCells[oldCell], actor);
+    addToCell(actor, cell);
+}
+
+ActorSprite *ActorIndex::findById(const int id,
+                                  const bool floorItem) const
+{
+    const ActorSpriteVector &bucket = mHash[getHashBucket(id)];
+    FOR_EACH (ActorSpriteVector::const_iterator, it, bucket)
+    {
+        ActorSprite *const actor = *it;
+        if (actor->getId() == id &&
+            (actor->getType() == ActorType::FloorItem) == floorItem)
+        {
+            return actor;
+        }
+    }
+    return nullptr;
+}
+
+void ActorIndex::getActors(ActorSpriteVector &actors,
+                           const int x1, const int y1,
+                           const int x2, const int y2) const
+{
+    actors.clear();
+    // moving beings tile position can be one tile ahead of pixel position
+    const int cellX1 = std::max(0, (x1 - 1) >> cellShift);
+    const int cellY1 = std::max(0, (y1 - 1) >> cellShift);
+    const int cellX2 = std::min(mGridWidth - 1, (x2 + 1) >> cellShift);
+    const int cellY2 = std::min(mGridHeight - 1, (y2 + 1) >> cellShift);
+    for (int y = cellY1; y <= cellY2; y ++)
+    {
+        const int offset = y * mGridWidth;
+        for (int x = cellX1; x <= cellX2; x ++)
+        {
+            const ActorSpriteVector &cell = mCells[offset + x];
+            actors.insert(actors.end(), cell.begin(), cell.end());
+        }
+    }
+    std::sort(actors.begin(), actors.end(), std::less<ActorSprite*>());
+}
+
+bool ActorIndex::getActorsInRing(ActorSpriteVector &actors,
+                                 const int x, const int y,
+                                 const int ring) const
+{
+    actors.clear();
+    const int cellX = x >> cellShift;
+    const int cellY = y >> cellShift;
+    const int maxRing = std::max(std::max(cellX, mGridWidth - 1 - cellX),
+        std::max(cellY, mGridHeight - 1 - cellY));
+    if (ring > maxRing)
+        return false;
+
+    const int x1 = cellX - ring;
+    const int x2 = cellX + ring;
+    const int y1 = cellY - ring;
+    const int y2 = cellY + ring;
+    for (int cy = std::max(0, y1); cy <= std::min(mGridHeight - 1, y2); cy ++)
+    {
+        const int offset = cy * mGridWidth;
+        // only left and right cells of ring, except top and bottom rows
+        const int step = (cy == y1 || cy == y2) ? 1 : std::max(1, x2 - x1);
+        for (int cx = x1; cx <= x2; cx += step)
+        {
+            if (cx < 0 || cx >= mGridWidth)
+                continue;
+            const ActorSpriteVector &cell = mCells[offset + cx];
+            actors.insert(actors.end(), cell.begin(), cell.end());
+        }
+    }
+    return true;
+}
+
+int ActorIndex::getRingDistance(const int ring)
+{
+    // actor tile position can differ by one tile from its grid cell,
+    // and searched tile can differ by one tile from searching being
+    return (ring << cellShift) - 1;
+}
+
+void ActorIndex::addToCell(ActorSprite *const actor, const int cell)
+{
+    mCells[cell].push_back(actor);
+    actor->setIndexCell(cell);
+}
+
+void ActorIndex::removeFromCell(ActorSprite *const actor)
+{
+    const size_t cell = static_cast<size_t>(actor->getIndexCell());
+    if (cell < mCells.size())
+        eraseActor(mCells[cell], actor);
+    actor->setIndexCell(-1);
+}
+
+void ActorIndex::rehash(const unsigned int bits)
+{
+    std::vector<ActorSpriteVector> oldHash;
+    oldHash.swap(mHash);
+    mHashBits = bits;
+    mHash.resize(1U << bits);
+    FOR_EACH (std::vector<ActorSpriteVector>::const_iterator, it, oldHash)
+    {
+        const ActorSpriteVector &bucket = *it;
+        FOR_EACH (ActorSpriteVector::const_iterator, it2, bucket)
+            mHash[getHashBucket((*it2)->getId())].push_back(*it2);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ACTORINDEX_H
+#define ACTORINDEX_H
+
+#include <vector>
+
+#include "localconsts.h"
+
+class ActorSprite;
+
+typedef std::vector<ActorSprite*> ActorSpriteVector;
+
+/**
+ * Lookup structures for ActorManager: hash of actors by id and grid of
+ * actors bucketed by tile position.
+ */
+class ActorIndex final
+{
+    public:
+        ActorIndex();
+
+        A_DELETE_COPY(ActorIndex)
+
+        /**
+         * Rebuilds the grid for a map of the given size in tiles.
+         */
+        void setMapSize(const int width, const int height);
+
+        void add(ActorSprite *const actor);
+
+        void remove(ActorSprite *const actor);
+
+        /**
+         * Forgets all actors without touching them.
+         */
+        void clear();
+
+        /**
+         * Must be called before actor id is changed to newId.
+         */
+        void changeId(ActorSprite *const actor, const int newId);
+
+        /**
+         * Moves actor to grid cell matching its current position.
+         */
+        void updatePosition(ActorSprite *const actor);
+
+        /**
+         * Returns actor with given id. If floorItem is true, only floor
+         * items are returned, else only not floor items.
+         */
+        ActorSprite *findById(const int id,
+                              const bool floorItem) const A_WARN_UNUSED;
+
+        /**
+         * Puts all actors which may be located at tiles from x1,y1 to
+         * x2,y2 into actors, ordered same way as ActorSprites set.
+         * Actors are bucketed by pixel position, callers must check exact
+         * position themselves.
+         */
+        void getActors(ActorSpriteVector &actors,
+                       const int x1, const int y1,
+                       const int x2, const int y2) const;
+
+        /**
+         * Puts actors from grid cells at distance ring from cell of
+         * tile x,y into actors, in no particular order. Returns false if
+         * this and all bigger rings are outside of the grid.
+         */
+        bool getActorsInRing(ActorSpriteVector &actors,
+                             const int x, const int y,
+                             const int ring) const;
+
+        /**
+         * Minimal distance in tiles from tile x,y to actors not returned
+         * by getActorsInRing for rings up to ring.
+         */
+        static int getRingDistance(const int ring) A_WARN_UNUSED;
+
+    private:
+        unsigned int getHashBucket(const int id) const A_WARN_UNUSED;
+
+        int getCell(const ActorSprite *const actor) const A_WARN_UNUSED;
+
+        void addToCell(ActorSprite *const actor, const int cell);
+
+        void removeFromCell(ActorSprite *const actor);
+
+        void rehash(const unsigned int bits);
+
+        std::vector<ActorSpriteVector> mHash;
+        std::vector<ActorSpriteVector> mCells;
+        unsigned int mHashBits;
+        unsigned int mHashCount;
+        int mGridWidth;
+        int mGridHeight;
+};
+
+#endif  // ACTORINDEX_H
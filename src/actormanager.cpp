@@ -57,7 +57,10 @@
 
 #include "resources/db/itemdb.h"
 
+#include "resources/map/map.h"
+
 #include <algorithm>
+#include <functional>
 
 #include "debug.h"
 
@@ -96,44 +99,26 @@ class FindBeingFunctor final
         ActorType::Type type;
 } beingActorFinder;
 
-class FindBeingEqualFunctor final
+struct TargetCandidate final
 {
-    public:
-        bool operator() (const Being *const being) const
-        {
-            if (!being || !findBeing)
-                return false;
-            return being->getId() == findBeing->getId();
-        }
-
-        Being *findBeing;
-} beingEqualActorFinder;
+    Being *being;
+    int attackIndex;
+    int priorityIndex;
+    int tileDist;
+};
 
 class SortBeingFunctor final
 {
     public:
-        bool operator() (const Being *const being1,
-                         const Being *const being2) const
+        bool operator() (const TargetCandidate &candidate1,
+                         const TargetCandidate &candidate2) const
         {
-            if (!being1 || !being2)
-                return false;
+            const Being *const being1 = candidate1.being;
+            const Being *const being2 = candidate2.being;
+
+            if (candidate1.priorityIndex != candidate2.priorityIndex)
+                return candidate1.priorityIndex < candidate2.priorityIndex;
 
-            if (priorityBeings)
-            {
-                int w1 = defaultPriorityIndex;
-                int w2 = defaultPriorityIndex;
-                const StringIntMapCIter it1 = priorityBeings->find(
-                    being1->getName());
-                const StringIntMapCIter it2 = priorityBeings->find(
-                    being2->getName());
-                if (it1 != priorityBeings->end())
-                    w1 = (*it1).second;
-                if (it2 != priorityBeings->end())
-                    w2 = (*it2).second;
-
-                if (w1 != w2)
-                    return w1 < w2;
-            }
             if (being1->getDistance() != being2->getDistance())
             {
                 if (specialDistance && being1->getDistance() <= 2
@@ -151,38 +136,13 @@ class SortBeingFunctor final
                 return being1->getDistance() < being2->getDistance();
             }
 
-            const int d1 = abs(being1->getTileX() - x)
-                + abs(being1->getTileY() - y);
-            const int d2 = abs(being2->getTileX() - x)
-                + abs(being2->getTileY() - y);
-
-            if (d1 != d2)
-                return d1 < d2;
-            if (attackBeings)
-            {
-                int w1 = defaultAttackIndex;
-                int w2 = defaultAttackIndex;
-                const StringIntMapCIter it1 = attackBeings->find(
-                    being1->getName());
-                const StringIntMapCIter it2 = attackBeings->find(
-                    being2->getName());
-                if (it1 != attackBeings->end())
-                    w1 = (*it1).second;
-                if (it2 != attackBeings->end())
-                    w2 = (*it2).second;
-
-                if (w1 != w2)
-                    return w1 < w2;
-            }
+            if (candidate1.tileDist != candidate2.tileDist)
+                return candidate1.tileDist < candidate2.tileDist;
+            if (candidate1.attackIndex != candidate2.attackIndex)
+                return candidate1.attackIndex < candidate2.attackIndex;
 
             return (being1->getName() < being2->getName());
         }
-        StringIntMap *attackBeings;
-        StringIntMap *priorityBeings;
-        int x;
-        int y;
-        int defaultAttackIndex;
-        int defaultPriorityIndex;
         int attackRange;
         bool specialDistance;
 } beingActorSorter;
@@ -190,6 +150,11 @@ class SortBeingFunctor final
 ActorManager::ActorManager() :
     mActors(),
     mDeleteActors(),
+    mIndex(),
+    mTargetFilters(),
+    mTargetFilterIds(),
+    mDefaultTargetFilter(),
+    mMinPriorityIndex(0),
     mBlockedBeings(),
     mMap(nullptr),
     mSpellHeal1(serverConfig.getValue("spellHeal1", "#lum")),
@@ -223,6 +188,10 @@ ActorManager::~ActorManager()
 void ActorManager::setMap(Map *const map)
 {
     mMap = map;
+    if (map)
+        mIndex.setMapSize(map->getWidth(), map->getHeight());
+    else
+        mIndex.setMapSize(0, 0);
 
     if (localPlayer)
         localPlayer->setMap(map);
@@ -232,6 +201,7 @@ void ActorManager::setPlayer(LocalPlayer *const player)
 {
     localPlayer = player;
     mActors.insert(player);
+    mIndex.add(player);
     if (socialWindow)
         socialWindow->updateAttackFilter();
     if (socialWindow)
@@ -245,6 +215,7 @@ Being *ActorManager::createBeing(const int id,
     Being *const being = new Being(id, type, subtype, mMap);
 
     mActors.insert(being);
+    mIndex.add(being);
     if (type == ActorType::Player
         || type == ActorType::Npc
         || type == ActorType::Mercenary
@@ -293,6 +264,7 @@ FloorItem *ActorManager::createItem(const int id, const int itemId,
     if (!checkForPickup(floorItem))
         floorItem->disableHightlight();
     mActors.insert(floorItem);
+    mIndex.add(floorItem);
     return floorItem;
 }
 
@@ -310,6 +282,7 @@ void ActorManager::erase(ActorSprite *const actor)
         return;
 
     mActors.erase(actor);
+    mIndex.remove(actor);
 }
 
 void ActorManager::undelete(const ActorSprite *const actor)
@@ -329,17 +302,7 @@ void ActorManager::undelete(const ActorSprite *const actor)
 
 Being *ActorManager::findBeing(const int id) const
 {
-    for_actors
-    {
-        ActorSprite *const actor = *it;
-        if (actor->getId() == id &&
-            actor->getType() != ActorType::FloorItem)
-        {
-            return static_cast<Being*>(actor);
-        }
-    }
-
-    return nullptr;
+    return static_cast<Being*>(mIndex.findById(id, false));
 }
 
 Being *ActorManager::findBeing(const int x, const int y,
@@ -349,10 +312,13 @@ Being *ActorManager::findBeing(const int x, const int y,
     beingActorFinder.y = static_cast<uint16_t>(y);
     beingActorFinder.type = type;
 
-    const ActorSpritesConstIterator it = std::find_if(
-        mActors.begin(), mActors.end(), beingActorFinder);
+    // npc can be found from tile above it
+    ActorSpriteVector actors;
+    mIndex.getActors(actors, x, y, x, y + 1);
+    const ActorSpriteVector::const_iterator it = std::find_if(
+        actors.begin(), actors.end(), beingActorFinder);
 
-    return (it == mActors.end()) ? nullptr : static_cast<Being*>(*it);
+    return (it == actors.end()) ? nullptr : static_cast<Being*>(*it);
 }
 
 Being *ActorManager::findBeingByPixel(const int x, const int y,
@@ -364,13 +330,19 @@ Being *ActorManager::findBeingByPixel(const int x, const int y,
     const bool targetDead = mTargetDeadPlayers;
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
+    ActorSpriteVector actors;
+    mIndex.getActors(actors,
+        (x - mapTileSize) / mapTileSize,
+        (y - mapTileSize / 2) / mapTileSize,
+        (x + mapTileSize) / mapTileSize,
+        (y + mapTileSize * 2) / mapTileSize);
 
     if (mExtMouseTargeting)
     {
         Being *tempBeing = nullptr;
         bool noBeing(false);
 
-        for_actorsm
+        FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
         {
             if (!*it)
                 continue;
@@ -438,7 +410,7 @@ Being *ActorManager::findBeingByPixel(const int x, const int y,
     }
     else
     {
-        for_actorsm
+        FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
         {
             if (!*it)
                 continue;
@@ -482,8 +454,14 @@ void ActorManager::findBeingsByPixel(std::vector<ActorSprite*> &beings,
     const int uptol = mapTileSize;
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
-
-    for_actors
+    ActorSpriteVector actors;
+    mIndex.getActors(actors,
+        (x - xtol) / mapTileSize,
+        (y - mapTileSize / 2) / mapTileSize,
+        (x + xtol) / mapTileSize,
+        (y + uptol) / mapTileSize);
+
+    FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
     {
         if (!*it)
             continue;
@@ -522,7 +500,9 @@ Being *ActorManager::findPortalByTile(const int x, const int y) const
     if (!mMap)
         return nullptr;
 
-    for_actorsm
+    ActorSpriteVector actors;
+    mIndex.getActors(actors, x, y, x, y);
+    FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
     {
         if (!*it)
             continue;
@@ -541,24 +521,14 @@ Being *ActorManager::findPortalByTile(const int x, const int y) const
 
 FloorItem *ActorManager::findItem(const int id) const
 {
-    for_actorsm
-    {
-        if (!*it)
-            continue;
-
-        if ((*it)->getId() == id &&
-            (*it)->getType() == ActorType::FloorItem)
-        {
-            return static_cast<FloorItem*>(*it);
-        }
-    }
-
-    return nullptr;
+    return static_cast<FloorItem*>(mIndex.findById(id, true));
 }
 
 FloorItem *ActorManager::findItem(const int x, const int y) const
 {
-    for_actorsm
+    ActorSpriteVector actors;
+    mIndex.getActors(actors, x, y, x, y);
+    FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
     {
         if (!*it)
             continue;
@@ -582,9 +552,11 @@ bool ActorManager::pickUpAll(const int x1, const int y1,
 
     bool finded(false);
     const bool allowAll = mPickupItemsSet.find("") != mPickupItemsSet.end();
+    ActorSpriteVector actors;
+    mIndex.getActors(actors, x1, y1, x2, y2);
     if (!serverBuggy)
     {
-        for_actorsm
+        FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
         {
             if (!*it)
                 continue;
@@ -619,7 +591,7 @@ bool ActorManager::pickUpAll(const int x1, const int y1,
     {
         FloorItem *item = nullptr;
         unsigned cnt = 65535;
-        for_actorsm
+        FOR_EACH (ActorSpriteVector::const_iterator, it, actors)
         {
             if (!*it)
                 continue;
@@ -848,6 +820,7 @@ void ActorManager::logic()
     {
         ActorSprite *actor = *it;
         mActors.erase(actor);
+        mIndex.remove(actor);
         delete actor;
     }
 
@@ -866,15 +839,20 @@ void ActorManager::clear()
         localPlayer->setTarget(nullptr);
         localPlayer->unSetPickUpTarget();
         mActors.erase(localPlayer);
+        mIndex.remove(localPlayer);
     }
 
     for_actors
         delete *it;
     mActors.clear();
     mDeleteActors.clear();
+    mIndex.clear();
 
     if (localPlayer)
+    {
         mActors.insert(localPlayer);
+        mIndex.add(localPlayer);
+    }
 }
 
 Being *ActorManager::findNearestLivingBeing(const int x, const int y,
@@ -918,13 +896,6 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     if (!aroundBeing || !localPlayer)
         return nullptr;
 
-    std::set<std::string> attackMobs;
-    std::set<std::string> priorityMobs;
-    std::set<std::string> ignoreAttackMobs;
-    StringIntMap attackMobsMap;
-    StringIntMap priorityMobsMap;
-    int defaultAttackIndex = 10000;
-    int defaultPriorityIndex = 10000;
     const int attackRange = localPlayer->getAttackRange();
 
     bool specialDistance = false;
@@ -934,6 +905,7 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         specialDistance = true;
     }
 
+    const int maxTileDist = maxDist;
     maxDist = maxDist * maxDist;
 
     const bool cycleSelect = allowSort
@@ -947,31 +919,11 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
 
-    bool ignoreDefault = false;
-    if (filtered)
-    {
-        attackMobs = mAttackMobsSet;
-        priorityMobs = mPriorityAttackMobsSet;
-        ignoreAttackMobs = mIgnoreAttackMobsSet;
-        attackMobsMap = mAttackMobsMap;
-        priorityMobsMap = mPriorityAttackMobsMap;
-        beingActorSorter.attackBeings = &attackMobsMap;
-        beingActorSorter.priorityBeings = &priorityMobsMap;
-        beingActorSorter.specialDistance = specialDistance;
-        beingActorSorter.attackRange = attackRange;
-        if (ignoreAttackMobs.find("") != ignoreAttackMobs.end())
-            ignoreDefault = true;
-        StringIntMapCIter itr = attackMobsMap.find("");
-        if (itr != attackMobsMap.end())
-            defaultAttackIndex = (*itr).second;
-        itr = priorityMobsMap.find("");
-        if (itr != priorityMobsMap.end())
-            defaultPriorityIndex = (*itr).second;
-    }
+    ActorSpriteVector actors;
 
     if (cycleSelect)
     {
-        std::vector<Being*> sortedBeings;
+        std::vector<TargetCandidate> sortedBeings;
 
         FOR_EACH (ActorSprites::iterator, i, mActors)
         {
@@ -986,19 +938,12 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
 
             Being *const being = static_cast<Being*>(*i);
 
+            const TargetFilter *filter = nullptr;
             if (filtered)
             {
-                if (ignoreAttackMobs.find(being->getName())
-                    != ignoreAttackMobs.end())
-                {
-                    continue;
-                }
-                if (ignoreDefault && attackMobs.find(being->getName())
-                    == attackMobs.end() && priorityMobs.find(being->getName())
-                    == priorityMobs.end())
-                {
+                filter = &getTargetFilter(being);
+                if (filter->ignore)
                     continue;
-                }
             }
 
             if (being->getInfo()
@@ -1010,7 +955,16 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
             if (validateBeing(aroundBeing, being, type, nullptr, maxDist))
             {
                 if (being != excluded)
-                    sortedBeings.push_back(being);
+                {
+                    TargetCandidate candidate;
+                    candidate.being = being;
+                    candidate.attackIndex = filter ? filter->attackIndex : 0;
+                    candidate.priorityIndex = filter
+                        ? filter->priorityIndex : 0;
+                    candidate.tileDist = abs(being->getTileX() - x)
+                        + abs(being->getTileY() - y);
+                    sortedBeings.push_back(candidate);
+                }
             }
         }
 
@@ -1018,160 +972,121 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         if (sortedBeings.empty())
             return nullptr;
 
-        beingActorSorter.x = x;
-        beingActorSorter.y = y;
-        if (filtered)
-        {
-            beingActorSorter.attackBeings = &attackMobsMap;
-            beingActorSorter.defaultAttackIndex = defaultAttackIndex;
-            beingActorSorter.priorityBeings = &priorityMobsMap;
-            beingActorSorter.defaultPriorityIndex = defaultPriorityIndex;
-        }
-        else
-        {
-            beingActorSorter.attackBeings = nullptr;
-            beingActorSorter.priorityBeings = nullptr;
-        }
+        beingActorSorter.attackRange = attackRange;
+        beingActorSorter.specialDistance = specialDistance;
         std::sort(sortedBeings.begin(), sortedBeings.end(), beingActorSorter);
-        if (filtered)
-        {
-            beingActorSorter.attackBeings = nullptr;
-            beingActorSorter.priorityBeings = nullptr;
-        }
 
-        if (localPlayer->getTarget() == nullptr)
+        const Being *const target = localPlayer->getTarget();
+        if (target == nullptr)
         {
-            Being *const target = sortedBeings.at(0);
+            Being *const first = sortedBeings[0].being;
 
-            if (specialDistance && target->getType() == ActorType::Monster
-                && target->getDistance() <= 2)
+            if (specialDistance && first->getType() == ActorType::Monster
+                && first->getDistance() <= 2)
             {
                 return nullptr;
             }
             // if no selected being in vector, return first nearest being
-            return target;
+            return first;
         }
 
-        beingEqualActorFinder.findBeing = localPlayer->getTarget();
-        std::vector<Being*>::const_iterator i = std::find_if(
-            sortedBeings.begin(), sortedBeings.end(), beingEqualActorFinder);
-
-        if (i == sortedBeings.end() || ++i == sortedBeings.end())
+        const size_t sz = sortedBeings.size();
+        for (size_t f = 0; f < sz; f ++)
         {
-            // if no selected being in vector, return first nearest being
-            return sortedBeings.at(0);
+            if (sortedBeings[f].being->getId() == target->getId())
+            {
+                // we find next being after target
+                if (f + 1 < sz)
+                    return sortedBeings[f + 1].being;
+                break;
+            }
         }
-
-        // we find next being after target
-        return *i;
+        // if no selected being in vector, return first nearest being
+        return sortedBeings[0].being;
     }
     else
     {
+        // path length used as distance for reachable monsters
+        const bool pathDistance = mTargetOnlyReachable
+            && (type == ActorType::Monster || type == ActorType::Unknown);
+        const int maxSearchDist = pathDistance ? maxDist : maxTileDist;
         int dist = 0;
-        int index = defaultPriorityIndex;
+        int index = 0;
         Being *closestBeing = nullptr;
 
-        FOR_EACH (ActorSprites::iterator, i, mActors)
+        for (int ring = 0;
+             mIndex.getActorsInRing(actors, x, y, ring);
+             ring ++)
         {
-            if (!*i)
-                continue;
-
-            if ((*i)->getType() == ActorType::FloorItem
-                || (*i)->getType() == ActorType::Portal)
+            FOR_EACH (ActorSpriteVector::const_iterator, i, actors)
             {
-                continue;
-            }
-            Being *const being = static_cast<Being*>(*i);
-
-            if (filtered)
-            {
-                if (ignoreAttackMobs.find(being->getName())
-                    != ignoreAttackMobs.end())
+                if ((*i)->getType() == ActorType::FloorItem
+                    || (*i)->getType() == ActorType::Portal)
                 {
                     continue;
                 }
-                if (ignoreDefault && attackMobs.find(being->getName())
-                    == attackMobs.end() && priorityMobs.find(being->getName())
-                    == priorityMobs.end())
+                Being *const being = static_cast<Being*>(*i);
+
+                const TargetFilter *filter = nullptr;
+                if (filtered)
                 {
-                    continue;
+                    filter = &getTargetFilter(being);
+                    if (filter->ignore)
+                        continue;
                 }
-            }
 
-            if (being->getInfo()
-                && !(being->getInfo()->isTargetSelection() || modActive))
-            {
-                continue;
-            }
-
-            const bool valid = validateBeing(aroundBeing, being,
-                                             type, excluded, 50);
-            int d = being->getDistance();
-            if (being->getType() != ActorType::Monster
-                || !mTargetOnlyReachable)
-            {   // if distance not calculated, use old distance
-                d = (being->getTileX() - x) * (being->getTileX() - x)
-                    + (being->getTileY() - y) * (being->getTileY() - y);
-            }
-
-            if (!valid)
-                continue;
+                if (being->getInfo()
+                    && !(being->getInfo()->isTargetSelection() || modActive))
+                {
+                    continue;
+                }
 
-            if (specialDistance && being->getDistance() <= 2
-                && being->getType() == type)
-            {
-                continue;
-            }
+                const bool valid = validateBeing(aroundBeing, being,
+                                                 type, excluded, 50);
+                int d = being->getDistance();
+                if (being->getType() != ActorType::Monster
+                    || !mTargetOnlyReachable)
+                {   // if distance not calculated, use old distance
+                    d = (being->getTileX() - x) * (being->getTileX() - x)
+                        + (being->getTileY() - y) * (being->getTileY() - y);
+                }
 
-//            logger->log("being name:" + being->getName());
-//            logger->log("index:" + toString(index));
-//            logger->log("d:" + toString(d));
+                if (!valid || d > maxDist)
+                    continue;
 
-            if (!filtered && (d <= dist || !closestBeing))
-            {
-                dist = d;
-                closestBeing = being;
-            }
-            else if (filtered)
-            {
-                int w2 = defaultPriorityIndex;
-                if (closestBeing)
+                if (specialDistance && being->getDistance() <= 2
+                    && being->getType() == type)
                 {
-                    const StringIntMapCIter it2 =  priorityMobsMap.find(
-                        being->getName());
-                    if (it2 != priorityMobsMap.end())
-                        w2 = (*it2).second;
-
-                    if (w2 < index)
-                    {
-                        dist = d;
-                        closestBeing = being;
-                        index = w2;
-                        continue;
-                    }
-                    if (w2 == index && d <= dist)
-                    {
-                        dist = d;
-                        closestBeing = being;
-                        index = w2;
-                        continue;
-                    }
+                    continue;
                 }
 
-                if (!closestBeing)
+                // lower priority index first, then nearest. From equal
+                // beings select same as ActorSprites set iteration did.
+                const int w = filter ? filter->priorityIndex : 0;
+                if (!closestBeing
+                    || w < index
+                    || (w == index && (d < dist || (d == dist
+                    && std::less<Being*>()(closestBeing, being)))))
                 {
                     dist = d;
+                    index = w;
                     closestBeing = being;
-                    const StringIntMapCIter it1 = priorityMobsMap.find(
-                        being->getName());
-                    if (it1 != priorityMobsMap.end())
-                        index = (*it1).second;
-                    else
-                        index = defaultPriorityIndex;
                 }
             }
+
+            const int ringDist = ActorIndex::getRingDistance(ring);
+            if (ringDist > maxSearchDist)
+                break;
+            // beings in next rings can't be better than found one
+            if (closestBeing
+                && ringDist > 0
+                && (!filtered || index <= mMinPriorityIndex)
+                && (pathDistance ? ringDist : ringDist * ringDist) > dist)
+            {
+                break;
+            }
         }
-        return (maxDist >= dist) ? closestBeing : nullptr;
+        return closestBeing;
     }
 }
 
@@ -1657,11 +1572,13 @@ void ActorManager::addIgnorePickupItem(const std::string &name)
 void ActorManager::rebuildPriorityAttackMobs()
 {
     rebuildMobsList(PriorityAttackMob);
+    rebuildTargetFilters();
 }
 
 void ActorManager::rebuildAttackMobs()
 {
     rebuildMobsList(AttackMob);
+    rebuildTargetFilters();
 }
 
 void ActorManager::rebuildPickupItems()
@@ -1669,6 +1586,78 @@ void ActorManager::rebuildPickupItems()
     rebuildMobsList(PickupItem);
 }
 
+void ActorManager::rebuildTargetFilters()
+{
+    mTargetFilters.clear();
+    mTargetFilterIds.clear();
+    mDefaultTargetFilter = TargetFilter();
+    StringIntMapCIter itr = mAttackMobsMap.find("");
+    if (itr != mAttackMobsMap.end())
+        mDefaultTargetFilter.attackIndex = (*itr).second;
+    itr = mPriorityAttackMobsMap.find("");
+    if (itr != mPriorityAttackMobsMap.end())
+        mDefaultTargetFilter.priorityIndex = (*itr).second;
+    // "" in ignore list mean ignore all mobs not in attack lists
+    mDefaultTargetFilter.ignore = mIgnoreAttackMobsSet.find("")
+        != mIgnoreAttackMobsSet.end();
+    mMinPriorityIndex = mPriorityAttackMobsMap.empty()
+        ? mDefaultTargetFilter.priorityIndex : 0;
+
+    std::set<std::string> names = mAttackMobsSet;
+    names.insert(mPriorityAttackMobsSet.begin(),
+        mPriorityAttackMobsSet.end());
+    names.insert(mIgnoreAttackMobsSet.begin(), mIgnoreAttackMobsSet.end());
+
+    FOR_EACH (std::set<std::string>::const_iterator, it, names)
+    {
+        const std::string &name = *it;
+        TargetFilter &filter = mTargetFilters[name];
+        filter = mDefaultTargetFilter;
+        itr = mAttackMobsMap.find(name);
+        if (itr != mAttackMobsMap.end())
+            filter.attackIndex = (*itr).second;
+        itr = mPriorityAttackMobsMap.find(name);
+        if (itr != mPriorityAttackMobsMap.end())
+            filter.priorityIndex = (*itr).second;
+        if (mIgnoreAttackMobsSet.find(name) != mIgnoreAttackMobsSet.end())
+        {
+            filter.ignore = true;
+        }
+        else if (mAttackMobsSet.find(name) != mAttackMobsSet.end()
+                 || mPriorityAttackMobsSet.find(name)
+                 != mPriorityAttackMobsSet.end())
+        {
+            filter.ignore = false;
+        }
+    }
+}
+
+const TargetFilter &ActorManager::getTargetFilter(const std::string &name)
+                                                  const
+{
+    const TargetFiltersCIter it = mTargetFilters.find(name);
+    if (it == mTargetFilters.end())
+        return mDefaultTargetFilter;
+    return (*it).second;
+}
+
+const TargetFilter &ActorManager::getTargetFilter(const Being *const being)
+                                                  const
+{
+    const BeingInfo *const info = being->getInfo();
+    if (!info)
+        return getTargetFilter(being->getName());
+
+    const int id = being->getSubType();
+    const TargetFilterIdsCIter it = mTargetFilterIds.find(id);
+    if (it != mTargetFilterIds.end())
+        return *(*it).second;
+
+    const TargetFilter &filter = getTargetFilter(info->getName());
+    mTargetFilterIds[id] = &filter;
+    return filter;
+}
+
 int ActorManager::getIndexByName(const std::string &name,
                                  const StringIntMap &map)
 {
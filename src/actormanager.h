@@ -23,6 +23,7 @@
 #ifndef ACTORMANAGER_H
 #define ACTORMANAGER_H
 
+#include "actorindex.h"
 #include "flooritem.h"
 
 #include "listeners/configlistener.h"
@@ -40,6 +41,28 @@ typedef std::set<ActorSprite*> ActorSprites;
 typedef ActorSprites::iterator ActorSpritesIterator;
 typedef ActorSprites::const_iterator ActorSpritesConstIterator;
 
+/**
+ * Attack filter lists resolved for one mob name.
+ */
+struct TargetFilter final
+{
+    TargetFilter() :
+        attackIndex(10000),
+        priorityIndex(10000),
+        ignore(false)
+    {
+    }
+
+    int attackIndex;
+    int priorityIndex;
+    bool ignore;
+};
+
+typedef std::map<std::string, TargetFilter> TargetFilters;
+typedef TargetFilters::const_iterator TargetFiltersCIter;
+typedef std::map<int, const TargetFilter*> TargetFilterIds;
+typedef TargetFilterIds::const_iterator TargetFilterIdsCIter;
+
 class ActorManager final: public ConfigListener
 {
     public:
@@ -317,6 +340,18 @@ class ActorManager final: public ConfigListener
         void updateEffects(const std::map<int, int> &addEffects,
                            const std::set<int> &removeEffects) const;
 
+        /**
+         * Updates actor grid cell after actor position changed.
+         */
+        void updateActorPosition(ActorSprite *const actor)
+        { mIndex.updatePosition(actor); }
+
+        /**
+         * Called before actor id changed to newId.
+         */
+        void updateActorId(ActorSprite *const actor, const int newId)
+        { mIndex.changeId(actor, newId); }
+
     protected:
         bool validateBeing(const Being *const aroundBeing,
                            Being *const being,
@@ -332,12 +367,33 @@ class ActorManager final: public ConfigListener
                                       const bool allowSort)
                                       const A_WARN_UNUSED;
 
+        /**
+         * Resolves attack, priority and ignore mob lists into
+         * mTargetFilters.
+         */
+        void rebuildTargetFilters();
+
+        const TargetFilter &getTargetFilter(const std::string &name)
+                                            const A_WARN_UNUSED;
+
+        /**
+         * Returns filter for being type. Type resolved by name only once
+         * after lists changed, and then kept in mTargetFilterIds.
+         */
+        const TargetFilter &getTargetFilter(const Being *const being)
+                                            const A_WARN_UNUSED;
+
         void loadAttackList();
 
         void storeAttackList() const;
 
         ActorSprites mActors;
         ActorSprites mDeleteActors;
+        ActorIndex mIndex;
+        TargetFilters mTargetFilters;
+        mutable TargetFilterIds mTargetFilterIds;
+        TargetFilter mDefaultTargetFilter;
+        int mMinPriorityIndex;
         std::set<uint32_t> mBlockedBeings;
         Map *mMap;
         std::string mSpellHeal1;
@@ -22,6 +22,7 @@
 
 #include "animatedsprite.h"
 
+#include "resources/asyncresourceloader.h"
 #include "resources/resourcemanager.h"
 #include "resources/spriteaction.h"
 
@@ -35,6 +36,8 @@ AnimationDelayLoad::AnimationDelayLoad(const std::string &fileName,
     mSprite(sprite),
     mAction(SpriteAction::STAND)
 {
+    if (asyncResourceLoader)
+        asyncResourceLoader->addSprite(mFileName);
 }
 
 AnimationDelayLoad::~AnimationDelayLoad()
@@ -51,6 +54,11 @@ void AnimationDelayLoad::clearSprite()
     mSprite = nullptr;
 }
 
+bool AnimationDelayLoad::isReady() const
+{
+    return !asyncResourceLoader || asyncResourceLoader->isLoaded(mFileName);
+}
+
 void AnimationDelayLoad::load()
 {
     if (mSprite)
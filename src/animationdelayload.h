@@ -39,6 +39,11 @@ class AnimationDelayLoad final
 
         void clearSprite();
 
+        /**
+         * Returns true if resource loader thread finished preparing sprite.
+         */
+        bool isReady() const A_WARN_UNUSED;
+
         void load();
 
         void setAction(const std::string &action)
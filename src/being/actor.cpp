@@ -29,7 +29,7 @@ Actor::Actor() :
     mMap(nullptr),
     mPos(),
     mYDiff(0),
-    mMapActor()
+    mMapActor(-1)
 {
 }
 
@@ -25,6 +25,7 @@
 #include "vector.h"
 
 #include <list>
+#include <vector>
 
 #include "localconsts.h"
 
@@ -32,7 +33,7 @@ class Actor;
 class Graphics;
 class Map;
 
-typedef std::list<Actor*> Actors;
+typedef std::vector<Actor*> Actors;
 typedef Actors::const_iterator ActorsCIter;
 
 class Actor notfinal
@@ -135,7 +136,10 @@ class Actor notfinal
         int mYDiff;
 
     private:
-        Actors::iterator mMapActor;
+        friend class Map;
+
+        // index in map actors
+        int mMapActor;
 };
 
 #endif  // BEING_ACTOR_H
@@ -21,6 +21,7 @@
 
 #include "being/actorsprite.h"
 
+#include "actormanager.h"
 #include "animatedsprite.h"
 #include "configuration.h"
 #include "imagesprite.h"
@@ -64,6 +65,7 @@ ActorSprite::ActorSprite(const int id) :
     mStatusParticleEffects(&mStunParticleEffects, false),
     mChildParticleEffects(&mStatusParticleEffects, false),
     mId(id),
+    mIndexCell(-1),
     mStunMode(0),
     mUsedTargetCursor(nullptr),
     mActorSpriteListeners(),
@@ -107,6 +109,20 @@ void ActorSprite::draw1(Graphics *const graphics,
     }
 }
 
+void ActorSprite::setId(const int id)
+{
+    if (actorManager)
+        actorManager->updateActorId(this, id);
+    mId = id;
+}
+
+void ActorSprite::setPosition(const Vector &pos)
+{
+    Actor::setPosition(pos);
+    if (actorManager)
+        actorManager->updateActorPosition(this);
+}
+
 void ActorSprite::logic()
 {
     BLOCK_START("ActorSprite::logic")
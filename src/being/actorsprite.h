@@ -55,8 +55,18 @@ class ActorSprite notfinal : public CompoundSprite, public Actor
         int getId() const A_WARN_UNUSED
         { return mId; }
 
-        void setId(const int id)
-        { mId = id; }
+        void setId(const int id);
+
+        void setPosition(const Vector &pos) override;
+
+        /**
+         * Grid cell in ActorIndex, or -1 if actor is not indexed.
+         */
+        int getIndexCell() const A_WARN_UNUSED
+        { return mIndexCell; }
+
+        void setIndexCell(const int cell)
+        { mIndexCell = cell; }
 
         /**
          * Returns the type of the ActorSprite.
@@ -222,6 +232,7 @@ class ActorSprite notfinal : public CompoundSprite, public Actor
         ParticleVector mStatusParticleEffects;
         ParticleList mChildParticleEffects;
         int mId;
+        int mIndexCell;
         uint16_t mStunMode;             /**< Stun mode; zero if not stunned */
 
         /** Target cursor being used */
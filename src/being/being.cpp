@@ -222,7 +222,8 @@ Being::Being(const int id,
     mAway(false),
     mInactive(false),
     mNeedPosUpdate(true),
-    mPetAi(true)
+    mPetAi(true),
+    mPathPending(false)
 {
     for (int f = 0; f < 20; f ++)
     {
@@ -267,6 +268,9 @@ Being::~Being()
     config.removeListener("visiblenames", this);
     CHECKLISTENERS
 
+    if (mMap)
+        mMap->cancelPath(this);
+
     delete [] mSpriteRemap;
     mSpriteRemap = nullptr;
     delete [] mSpriteHide;
@@ -430,7 +434,7 @@ TargetCursorSize::Size Being::getTargetCursorSize() const
 
 void Being::setPosition(const Vector &pos)
 {
-    Actor::setPosition(pos);
+    ActorSprite::setPosition(pos);
 
     updateCoords();
 
@@ -447,16 +451,54 @@ void Being::setDestination(const int dstX, const int dstY)
     if (!mMap)
         return;
 
-    setPath(mMap->findPath(mX, mY, dstX, dstY, getBlockWalkMask()));
+    if (dstX == mX && dstY == mY)
+    {
+        // stop without waiting path finder
+        setPath(Path());
+        return;
+    }
+    if (abs(dstX - mX) <= 1 && abs(dstY - mY) <= 1)
+    {
+        // single step used by keyboard walking, callers check path at once
+        setPath(mMap->findPath(mX, mY, dstX, dstY, getBlockWalkMask()));
+        return;
+    }
+    mMap->findPathAsync(this, mX, mY, dstX, dstY, getBlockWalkMask());
+    mPathPending = true;
+}
+
+void Being::pathFound(const Path &path,
+                      const int startX, const int startY,
+                      const int destX, const int destY)
+{
+    mPathPending = false;
+    if (startX != mX || startY != mY)
+    {
+        // being moved while path was searched, path is from old tile
+        setDestination(destX, destY);
+        return;
+    }
+    setPath(path);
+}
+
+void Being::cancelPathRequest()
+{
+    if (!mPathPending)
+        return;
+    if (mMap)
+        mMap->cancelPath(this);
+    mPathPending = false;
 }
 
 void Being::clearPath()
 {
+    cancelPathRequest();
     mPath.clear();
 }
 
 void Being::setPath(const Path &path)
 {
+    cancelPathRequest();
     mPath = path;
     if (mPath.empty())
         return;
@@ -1671,7 +1713,8 @@ void Being::petLogic()
         }
         if (mX != dstX || mY != dstY)
         {
-            setPath(mMap->findPath(mX, mY, dstX, dstY, blockWalkMask));
+            mMap->findPathAsync(this, mX, mY, dstX, dstY, blockWalkMask);
+            mPathPending = true;
             return;
         }
     }
@@ -3466,6 +3509,7 @@ void Being::setTileCoords(const int x, const int y)
 
 void Being::setMap(Map *const map)
 {
+    cancelPathRequest();
     ActorSprite::setMap(map);
     if (mMap)
     {
@@ -35,6 +35,7 @@
 #include "enums/being/gender.h"
 
 #include "listeners/configlistener.h"
+#include "listeners/pathlistener.h"
 
 #include "localconsts.h"
 
@@ -83,7 +84,8 @@ struct NextSoundInfo final
 };
 
 class Being notfinal : public ActorSprite,
-                       public ConfigListener
+                       public ConfigListener,
+                       public PathListener
 {
     public:
         friend class ActorManager;
@@ -155,7 +157,9 @@ class Being notfinal : public ActorSprite,
         { return getOffset(BeingDirection::UP, BeingDirection::DOWN); }
 
         /**
-         * Creates a path for the being from current position to ex and ey
+         * Requests a path for the being from current position to ex and ey.
+         * Path to near tile is set at once, other paths are set when map
+         * path finder delivers them.
          */
         void setDestination(const int dstX, const int dstY);
 
@@ -558,6 +562,17 @@ class Being notfinal : public ActorSprite,
 
         virtual void optionChanged(const std::string &value) override;
 
+        void pathFound(const Path &path,
+                       const int startX, const int startY,
+                       const int destX, const int destY) override;
+
+        /**
+         * Returns true if path requested from map path finder is not
+         * delivered yet.
+         */
+        bool isPathPending() const A_WARN_UNUSED
+        { return mPathPending; }
+
         void flashName(const int time);
 
         int getDamageTaken() const A_WARN_UNUSED
@@ -867,6 +882,11 @@ class Being notfinal : public ActorSprite,
          */
         void setPath(const Path &path);
 
+        /**
+         * Drops not delivered path request of this being.
+         */
+        void cancelPathRequest();
+
         int getSortPixelY() const override A_WARN_UNUSED
         { return static_cast<int>(mPos.y) - mYDiff - mSortOffsetY; }
 //        { return static_cast<int>(mPos.y) - mYDiff - mSortOffsetY + 16; }
@@ -1112,6 +1132,7 @@ class Being notfinal : public ActorSprite,
         bool mInactive;
         bool mNeedPosUpdate;
         bool mPetAi;
+        bool mPathPending;
 };
 
 extern std::list<BeingCacheEntry*> beingInfoCache;
@@ -614,7 +614,7 @@ void LocalPlayer::startWalking(const unsigned char dir)
         return;
 
     mPickUpTarget = nullptr;
-    if (mAction == BeingAction::MOVE && !mPath.empty())
+    if (mAction == BeingAction::MOVE && (!mPath.empty() || isPathPending()))
     {
         // Just finish the current action, otherwise we get out of sync
         Being::setDestination(mX, mY);
@@ -92,8 +92,12 @@
 #include "net/partyhandler.h"
 
 #include "particle/particle.h"
+#include "particle/particleeffect.h"
 
+#include "resources/dyecache.h"
+#include "resources/dyekernels.h"
 #include "resources/imagehelper.h"
+#include "resources/mapcache.h"
 #include "resources/resourcemanager.h"
 #include "resources/spritereference.h"
 
@@ -120,6 +124,7 @@
 #include "utils/fuzzer.h"
 #include "utils/gettext.h"
 #include "utils/gettexthelper.h"
+#include "utils/mappedarchive.h"
 #ifdef ANDROID
 #include "utils/paths.h"
 #endif
@@ -263,6 +268,7 @@ void Client::gameInit()
 #endif
     ConfigManager::backupConfig("config.xml");
     ConfigManager::initConfiguration();
+    MappedArchives::init(config.getBoolValue("useMappedArchives"));
     Net::loadIgnorePackets();
     paths.setDefaultValues(getPathsDefaults());
     initFeatures();
@@ -304,6 +310,14 @@ void Client::gameInit()
     logger->log("Start configPath: " + config.getConfigPath());
 
     Dirs::initScreenshotDir();
+    if (config.getBoolValue("enableDyeCache"))
+    {
+        DyeCache::init(settings.localDataDir + dirSeparator + "dyecache",
+            config.getBoolValue("dyeCacheCompression"),
+            config.getIntValue("dyeCacheSize"));
+    }
+    if (config.getBoolValue("enableMapCache"))
+        MapCache::init(settings.localDataDir + dirSeparator + "mapcache");
 
     // Initialize SDL
     logger->log1("Initializing SDL...");
@@ -336,6 +350,7 @@ void Client::gameInit()
     ConfigManager::checkConfigVersion();
     logVars();
     Cpu::detect();
+    DyeKernels::init();
 #if defined(USE_OPENGL) 
 #if !defined(ANDROID) && !defined(__APPLE__) && !defined(__native_client__)
     if (!settings.options.safeMode && settings.options.test.empty()
@@ -660,9 +675,11 @@ void Client::gameClear()
         logger->log1("Quitting6");
 
     ActorSprite::unload();
+    ParticleEffect::clearCache();
 
     touchManager.clear();
     ResourceManager::deleteInstance();
+    MappedArchives::clear();
 
     if (logger)
         logger->log1("Quitting8");
@@ -1009,6 +1026,7 @@ int Client::gameExec()
                             + dirSeparator + settings.updatesDir + "/local/");
                     }
 
+                    ParticleEffect::clearCache();
                     resman->clearCache();
 
                     loginData.clearUpdateHost();
@@ -242,6 +242,7 @@ DefaultsData* getConfigDefaults()
     AddDEF("useLocalTime", false);
     AddDEF("enableAdvert", true);
     AddDEF("enableMapReduce", true);
+    AddDEF("useJumpPointSearch", true);
     AddDEF("showPlayersStatus", true);
     AddDEF("beingopacity", false);
     AddDEF("adjustPerfomance", true);
@@ -311,6 +312,8 @@ DefaultsData* getConfigDefaults()
 #else
     AddDEF("useAtlases", true);
 #endif
+    AddDEF("enableAtlasCache", true);
+    AddDEF("enableGlyphAtlas", true);
     AddDEF("useTextureSampler", false);
     AddDEF("ministatussaved", 0);
     AddDEF("allowscreensaver", false);
@@ -353,6 +356,14 @@ DefaultsData* getConfigDefaults()
     AddDEF("moveNames", false);
     AddDEF("uselonglivesprites", false);
     AddDEF("uselonglivesounds", true);
+    AddDEF("orphanedResourcesMemory", 128);
+    AddDEF("orphanedResourcesVideoMemory", 128);
+    AddDEF("enableDyeCache", true);
+    AddDEF("dyeCacheCompression", true);
+    AddDEF("dyeCacheSize", 128);
+    AddDEF("enableMapCache", true);
+    AddDEF("parallelMapLoading", true);
+    AddDEF("useMappedArchives", true);
     AddDEF("screenDensity", 0);
     AddDEF("cfgver", 12);
     AddDEF("enableDebugLog", false);
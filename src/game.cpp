@@ -45,6 +45,7 @@
 #include "being/playerinfo.h"
 
 #include "particle/particle.h"
+#include "particle/particleeffect.h"
 
 #include "input/inputmanager.h"
 #include "input/joystick.h"
@@ -103,6 +104,7 @@
 #include "net/packetcounters.h"
 #include "net/serverfeatures.h"
 
+#include "resources/asyncresourceloader.h"
 #include "resources/delayedmanager.h"
 #include "resources/imagewriter.h"
 #include "resources/mapreader.h"
@@ -397,8 +399,11 @@ Game::Game() :
         top->add(viewport);
     viewport->requestMoveToBottom();
 
-    AnimatedSprite::setEnableCache(mainGraphics->getOpenGL()
-        && config.getBoolValue("enableDelayedAnimations"));
+    const bool delayedAnimations = mainGraphics->getOpenGL()
+        && config.getBoolValue("enableDelayedAnimations");
+    AnimatedSprite::setEnableCache(delayedAnimations);
+    if (delayedAnimations)
+        asyncResourceLoader = new AsyncResourceLoader;
 
     CompoundSprite::setEnableDelay(
         config.getBoolValue("enableCompoundSpriteDelay"));
@@ -445,6 +450,7 @@ Game::~Game()
     destroyGuiWindows();
 
     AnimatedSprite::setEnableCache(false);
+    delete2(asyncResourceLoader)
 
     delete2(actorManager)
     if (client->getState() != STATE_CHANGE_MAP)
@@ -1023,6 +1029,8 @@ void Game::changeMap(const std::string &mapPath)
 
     if (particleEngine)
         particleEngine->clear();
+    // all particles deleted, so cached effects not used anymore
+    ParticleEffect::clearCache();
 
     mMapName = mapPath;
 
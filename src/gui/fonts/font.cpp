@@ -66,6 +66,7 @@
 
 #include "gui/fonts/font.h"
 
+#include "configuration.h"
 #include "logger.h"
 
 #include "gui/fonts/textchunk.h"
@@ -90,6 +91,7 @@ const unsigned int CACHE_SIZE_SMALL3 = 170;
 const unsigned int CLEAN_TIME = 7;
 
 bool Font::mSoftMode(false);
+bool Font::mGlyphAtlas(false);
 
 extern char *strBuf;
 
@@ -101,11 +103,19 @@ Font::Font(std::string filename,
     mFont(nullptr),
     mCreateCounter(0),
     mDeleteCounter(0),
-    mCleanTime(cur_time + CLEAN_TIME)
+    mCleanTime(cur_time + CLEAN_TIME),
+    mMetrics(),
+    mGlyphCache()
 {
     if (fontCounter == 0)
     {
-        mSoftMode = imageHelper->useOpenGL() == RENDER_SOFTWARE;
+        const RenderType mode = imageHelper->useOpenGL();
+        mSoftMode = mode == RENDER_SOFTWARE;
+        // only renderers what batch images by texture benefit from atlases
+        mGlyphAtlas = (mode == RENDER_NORMAL_OPENGL
+            || mode == RENDER_GLES_OPENGL
+            || mode == RENDER_MODERN_OPENGL)
+            && config.getBoolValue("enableGlyphAtlas");
         if (TTF_Init() == -1)
         {
             logger->error("Unable to initialize SDL_ttf: " +
@@ -200,6 +210,8 @@ void Font::clear()
 {
     for (size_t f = 0; f < CACHES_NUMBER; f ++)
         mCache[f].clear();
+    mMetrics.clear();
+    mGlyphCache.clear();
 }
 
 void Font::drawString(Graphics *const graphics,
@@ -226,6 +238,14 @@ void Font::drawString(Graphics *const graphics,
      */
     col.a = 255;
 
+    if (useGlyphs())
+    {
+        mGlyphCache.drawString(g, mFont, mMetrics, text,
+            x, y, col, col2, alpha);
+        BLOCK_END("Font::drawString")
+        return;
+    }
+
     const unsigned char chr = text[0];
     TextChunkList *const cache = &mCache[chr];
 
@@ -287,27 +307,7 @@ int Font::getWidth(const std::string &text) const
     if (text.empty())
         return 0;
 
-    const unsigned char chr = text[0];
-    TextChunkList *const cache = &mCache[chr];
-
-    std::map<std::string, TextChunk*> &search = cache->searchWidth;
-    std::map<std::string, TextChunk*>::iterator i = search.find(text);
-    if (i != search.end())
-    {
-        TextChunk *const chunk = (*i).second;
-        cache->moveToFirst(chunk);
-        const Image *const image = chunk->img;
-        if (image)
-            return image->getWidth();
-        else
-            return 0;
-    }
-
-    // if string was not drawed
-    int w, h;
-    getSafeUtf8String(text, strBuf);
-    TTF_SizeUTF8(mFont, strBuf, &w, &h);
-    return w;
+    return mMetrics.getWidth(mFont, text);
 }
 
 int Font::getHeight() const
@@ -359,14 +359,7 @@ void Font::doClean()
 
 int Font::getStringIndexAt(const std::string& text, const int x) const
 {
-    const size_t sz = text.size();
-    for (size_t i = 0; i < sz; ++i)
-    {
-        if (getWidth(text.substr(0, i)) > x)
-            return static_cast<int>(i);
-    }
-
-    return static_cast<int>(sz);
+    return mMetrics.getStringIndexAt(mFont, text, x);
 }
 
 const TextChunkList *Font::getCache() const
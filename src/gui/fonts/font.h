@@ -67,6 +67,8 @@
 #ifndef GUI_FONTS_FONT_H
 #define GUI_FONTS_FONT_H
 
+#include "gui/fonts/fontmetrics.h"
+#include "gui/fonts/glyphcache.h"
 #include "gui/fonts/textchunklist.h"
 
 #include <SDL_ttf.h>
@@ -127,9 +129,14 @@ class Font final
 
         static bool mSoftMode;
 
+        static bool mGlyphAtlas;
+
     private:
         static TTF_Font *openFont(const char *const name, const int size);
 
+        bool useGlyphs() const A_WARN_UNUSED
+        { return mGlyphAtlas && GlyphCache::isFitting(mFont); }
+
         TTF_Font *mFont;
         unsigned mCreateCounter;
         unsigned mDeleteCounter;
@@ -137,6 +144,12 @@ class Font final
         // Word surfaces cache
         int mCleanTime;
         mutable TextChunkList mCache[CACHES_NUMBER];
+
+        // Glyph advances for text measuring
+        FontMetrics mMetrics;
+
+        // Glyph atlases, used instead of word surfaces if mGlyphAtlas set
+        GlyphCache mGlyphCache;
 };
 
 #ifdef UNITTESTS
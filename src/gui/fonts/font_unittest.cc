@@ -23,6 +23,7 @@
 #include "gui/theme.h"
 
 #include "gui/fonts/font.h"
+#include "gui/fonts/fontmetrics.h"
 #include "gui/fonts/textchunk.h"
 #include "gui/fonts/textchunksmall.h"
 
@@ -38,7 +39,6 @@ TEST(TextChunkList, empty)
     EXPECT_EQ(nullptr, list.start);
     EXPECT_EQ(nullptr, list.end);
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, add1)
@@ -59,9 +59,6 @@ TEST(TextChunkList, add1)
     EXPECT_EQ(1, list.search.size());
     EXPECT_EQ(chunk, (*list.search.find(TextChunkSmall(
         chunk->text, chunk->color, chunk->color2))).second);
-
-    EXPECT_EQ(1, list.searchWidth.size());
-    EXPECT_EQ(chunk, (*list.searchWidth.find(chunk->text)).second);
 }
 
 TEST(TextChunkList, add2)
@@ -89,9 +86,6 @@ TEST(TextChunkList, add2)
         chunk1->text, chunk1->color, chunk1->color2))).second);
     EXPECT_EQ(chunk2, (*list.search.find(TextChunkSmall(
         chunk2->text, chunk2->color, chunk2->color2))).second);
-
-    EXPECT_EQ(1, list.searchWidth.size());
-    EXPECT_EQ(chunk1, (*list.searchWidth.find(chunk1->text)).second);
 }
 
 TEST(TextChunkList, addRemoveBack1)
@@ -108,7 +102,6 @@ TEST(TextChunkList, addRemoveBack1)
     EXPECT_EQ(nullptr, list.start);
     EXPECT_EQ(nullptr, list.end);
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, addRemoveBack2)
@@ -133,9 +126,6 @@ TEST(TextChunkList, addRemoveBack2)
     EXPECT_EQ(1, list.search.size());
     EXPECT_EQ(chunk1, (*list.search.find(TextChunkSmall(
         chunk1->text, chunk1->color, chunk1->color2))).second);
-
-    EXPECT_EQ(1, list.searchWidth.size());
-    EXPECT_EQ(chunk1, (*list.searchWidth.find(chunk1->text)).second);
 }
 
 TEST(TextChunkList, addRemoveBack3)
@@ -156,7 +146,6 @@ TEST(TextChunkList, addRemoveBack3)
     EXPECT_EQ(nullptr, list.end);
 
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, addRemoveBack4)
@@ -185,8 +174,6 @@ TEST(TextChunkList, addRemoveBack4)
     EXPECT_EQ(1, list.search.size());
     EXPECT_EQ(chunk1, (*list.search.find(TextChunkSmall(
         chunk1->text, chunk1->color, chunk1->color2))).second);
-
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, moveToFirst1)
@@ -297,7 +284,6 @@ TEST(TextChunkList, clear1)
     EXPECT_EQ(nullptr, list.end);
     EXPECT_EQ(chunksLeft, textChunkCnt);
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, clear2)
@@ -322,7 +308,6 @@ TEST(TextChunkList, clear2)
     EXPECT_EQ(nullptr, list.end);
     EXPECT_EQ(chunksLeft, textChunkCnt);
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, clear3)
@@ -343,17 +328,14 @@ TEST(TextChunkList, clear3)
     list.moveToFirst(chunk1);
     EXPECT_EQ(chunksLeft + 3, textChunkCnt);
     EXPECT_EQ(3, list.search.size());
-    EXPECT_EQ(1, list.searchWidth.size());
 
     list.removeBack();
     EXPECT_EQ(chunksLeft + 2, textChunkCnt);
     EXPECT_EQ(2, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 
     list.clear();
     EXPECT_EQ(chunksLeft, textChunkCnt);
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, clear4)
@@ -374,17 +356,14 @@ TEST(TextChunkList, clear4)
     list.moveToFirst(chunk2);
     EXPECT_EQ(chunksLeft + 3, textChunkCnt);
     EXPECT_EQ(3, list.search.size());
-    EXPECT_EQ(2, list.searchWidth.size());
 
     list.removeBack(2);
     EXPECT_EQ(chunksLeft + 1, textChunkCnt);
     EXPECT_EQ(1, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 
     list.clear();
     EXPECT_EQ(chunksLeft, textChunkCnt);
     EXPECT_EQ(0, list.search.size());
-    EXPECT_EQ(0, list.searchWidth.size());
 }
 
 TEST(TextChunkList, sort1)
@@ -460,3 +439,89 @@ TEST(TextChunkList, sort7)
     EXPECT_EQ(true, item1 < item2);
     EXPECT_EQ(false, item2 < item1);
 }
+
+TEST(FontMetrics, readChar)
+{
+    char buf[GLYPH_BUF_SIZE];
+    uint32_t chr = 0;
+    const std::string str = "a\xc3\xa9\xe2\x82\xac\xc3";
+    EXPECT_EQ(1, FontMetrics::readChar(str, 0, buf, chr));
+    EXPECT_EQ(0x61U, chr);
+    EXPECT_EQ("a", std::string(buf));
+    EXPECT_EQ(2, FontMetrics::readChar(str, 1, buf, chr));
+    EXPECT_EQ(0xe9U, chr);
+    EXPECT_EQ("\xc3\xa9", std::string(buf));
+    EXPECT_EQ(3, FontMetrics::readChar(str, 3, buf, chr));
+    EXPECT_EQ(0x20acU, chr);
+    EXPECT_EQ("\xe2\x82\xac", std::string(buf));
+    EXPECT_EQ(1, FontMetrics::readChar(str, 6, buf, chr));
+    EXPECT_EQ(0xc3U, chr);
+}
+
+TEST(FontMetrics, getWidth)
+{
+    ASSERT_EQ(0, TTF_Init());
+    TTF_Font *const font = TTF_OpenFont("/usr/share/fonts/truetype/"
+        "ttf-dejavu/DejaVuSans-Oblique.ttf", 18);
+    ASSERT_NE(static_cast<TTF_Font*>(nullptr), font);
+    FontMetrics metrics;
+    EXPECT_EQ(0, metrics.getWidth(font, ""));
+
+    const std::string chars = "aijfWT1 .@";
+    for (size_t f = 0; f < chars.size(); f ++)
+    {
+        const std::string str = chars.substr(f, 1);
+        int w = 0;
+        int h = 0;
+        TTF_SizeUTF8(font, str.c_str(), &w, &h);
+        EXPECT_EQ(w, metrics.getWidth(font, str));
+        // cached metrics
+        EXPECT_EQ(w, metrics.getWidth(font, str));
+    }
+
+    TTF_SetFontStyle(font, TTF_STYLE_BOLD);
+    metrics.clear();
+    const std::string boldChars = ". -";
+    for (size_t f = 0; f < boldChars.size(); f ++)
+    {
+        const std::string str = boldChars.substr(f, 1);
+        int w = 0;
+        int h = 0;
+        TTF_SizeUTF8(font, str.c_str(), &w, &h);
+        EXPECT_EQ(w, metrics.getWidth(font, str));
+    }
+    TTF_CloseFont(font);
+    TTF_Quit();
+}
+
+TEST(FontMetrics, getStringIndexAt)
+{
+    ASSERT_EQ(0, TTF_Init());
+    TTF_Font *const font = TTF_OpenFont("/usr/share/fonts/truetype/"
+        "ttf-dejavu/DejaVuSans-Oblique.ttf", 18);
+    ASSERT_NE(static_cast<TTF_Font*>(nullptr), font);
+    FontMetrics metrics;
+    const std::string str = "jTest \xc3\xa9l\xc3\xa9ment";
+    const int width = metrics.getWidth(font, str);
+    EXPECT_EQ(0, metrics.getStringIndexAt(font, str, -1));
+    EXPECT_EQ(static_cast<int>(str.size()),
+        metrics.getStringIndexAt(font, str, width));
+    for (int x = 0; x < width; x ++)
+    {
+        int idx = static_cast<int>(str.size());
+        for (size_t f = 0; f < str.size(); f ++)
+        {
+            // skip utf8 continuation bytes
+            if ((str[f] & 0xC0) == 0x80)
+                continue;
+            if (metrics.getWidth(font, str.substr(0, f)) > x)
+            {
+                idx = static_cast<int>(f);
+                break;
+            }
+        }
+        EXPECT_EQ(idx, metrics.getStringIndexAt(font, str, x));
+    }
+    TTF_CloseFont(font);
+    TTF_Quit();
+}
@@ -0,0 +1,232 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gui/fonts/fontmetrics.h"
+
+#include <limits>
+
+#include "debug.h"
+
+// kerning of chars pair available only in new SDL_ttf
+#if SDL_TTF_MAJOR_VERSION > 2 || (SDL_TTF_MAJOR_VERSION == 2 \
+    && (SDL_TTF_MINOR_VERSION > 0 || SDL_TTF_PATCHLEVEL >= 14))
+#define FONT_KERNING
+#endif
+
+FontMetrics::FontMetrics() :
+    mGlyphs(),
+    mKernings(),
+    mOverhang(-1)
+{
+    clear();
+}
+
+void FontMetrics::clear()
+{
+    for (int f = 0; f < 128; f ++)
+        mAsciiGlyphs[f].advance = -1;
+    mGlyphs.clear();
+    mKernings.clear();
+    mOverhang = -1;
+}
+
+int FontMetrics::readChar(const std::string &text,
+                          const size_t pos,
+                          char *const buf,
+                          uint32_t &chr)
+{
+    const unsigned char c = static_cast<unsigned char>(text[pos]);
+    int len = 1;
+    chr = c;
+    if (c >= 0xF0)
+    {
+        len = 4;
+        chr = c & 0x07;
+    }
+    else if (c >= 0xE0)
+    {
+        len = 3;
+        chr = c & 0x0F;
+    }
+    else if (c >= 0xC0)
+    {
+        len = 2;
+        chr = c & 0x1F;
+    }
+    if (pos + len > text.size())
+    {
+        len = 1;
+        chr = c;
+    }
+    for (int f = 1; f < len; f ++)
+    {
+        chr = (chr << 6) | (static_cast<unsigned char>(
+            text[pos + f]) & 0x3F);
+    }
+    memset(buf, 0, GLYPH_BUF_SIZE);
+    memcpy(buf, text.data() + pos, len);
+    return len;
+}
+
+int FontMetrics::calcOverhang(TTF_Font *const font)
+{
+    if (!(TTF_GetFontStyle(font) & TTF_STYLE_BOLD))
+        return 0;
+
+    // SDL_ttf adds overhang after each glyph if bold emulated,
+    // but glyph metrics not include it
+    int advance = 0;
+    int width1 = 0;
+    int width2 = 0;
+    int height;
+    if (TTF_GlyphMetrics(font, '.', nullptr, nullptr, nullptr, nullptr,
+        &advance) != 0
+        || TTF_SizeUTF8(font, ".", &width1, &height) != 0
+        || TTF_SizeUTF8(font, "..", &width2, &height) != 0)
+    {
+        return 0;
+    }
+    const int overhang = width2 - width1 - advance;
+    return overhang > 0 ? overhang : 0;
+}
+
+void FontMetrics::loadGlyph(TTF_Font *const font,
+                            const char *const str,
+                            const uint32_t chr,
+                            GlyphMetrics &glyph) const
+{
+    if (chr > 0xFFFFU || TTF_GlyphMetrics(font, static_cast<Uint16>(chr),
+        &glyph.minX, &glyph.maxX, nullptr, nullptr, &glyph.advance) != 0)
+    {
+        // no metrics outside of basic plane, measure as string
+        int height;
+        TTF_SizeUTF8(font, str, &glyph.advance, &height);
+        glyph.minX = 0;
+        glyph.maxX = glyph.advance;
+        return;
+    }
+    if (mOverhang < 0)
+        mOverhang = calcOverhang(font);
+    // maxx from metrics already have overhang
+    glyph.advance += mOverhang;
+}
+
+const GlyphMetrics &FontMetrics::getGlyph(TTF_Font *const font,
+                                          const char *const str,
+                                          const uint32_t chr) const
+{
+    if (chr < 128)
+    {
+        GlyphMetrics &glyph = mAsciiGlyphs[chr];
+        if (glyph.advance < 0)
+            loadGlyph(font, str, chr, glyph);
+        return glyph;
+    }
+
+    const std::map<uint32_t, GlyphMetrics>::iterator it = mGlyphs.find(chr);
+    if (it != mGlyphs.end())
+        return (*it).second;
+    GlyphMetrics &glyph = mGlyphs[chr];
+    loadGlyph(font, str, chr, glyph);
+    return glyph;
+}
+
+#ifdef FONT_KERNING
+int FontMetrics::getKerning(TTF_Font *const font,
+                            const uint32_t prev,
+                            const uint32_t chr) const
+{
+    if (!prev || prev > 0xFFFFU || chr > 0xFFFFU)
+        return 0;
+
+    const uint32_t key = (prev << 16) | chr;
+    const std::map<uint32_t, int>::const_iterator it = mKernings.find(key);
+    if (it != mKernings.end())
+        return (*it).second;
+    const int kerning = TTF_GetFontKerning(font)
+        ? TTF_GetFontKerningSizeGlyphs(font, static_cast<Uint16>(prev),
+        static_cast<Uint16>(chr)) : 0;
+    mKernings[key] = kerning;
+    return kerning;
+}
+#else  // FONT_KERNING
+int FontMetrics::getKerning(TTF_Font *const font A_UNUSED,
+                            const uint32_t prev A_UNUSED,
+                            const uint32_t chr A_UNUSED) const
+{
+    return 0;
+}
+#endif  // FONT_KERNING
+
+size_t FontMetrics::measure(TTF_Font *const font,
+                            const std::string &text,
+                            const int maxWidth,
+                            int &width) const
+{
+    char buf[GLYPH_BUF_SIZE];
+    const size_t sz = text.size();
+    size_t pos = 0;
+    uint32_t prev = 0;
+    int x = 0;
+    int minX = 0;
+    int maxX = 0;
+    width = 0;
+    while (pos < sz)
+    {
+        if (width > maxWidth)
+            return pos;
+
+        uint32_t chr;
+        const int len = readChar(text, pos, buf, chr);
+        const GlyphMetrics &glyph = getGlyph(font, buf, chr);
+        x += getKerning(font, prev, chr);
+        // SDL_ttf moves string right if first glyph have negative minx
+        if (!pos && glyph.minX < 0)
+            x = -glyph.minX;
+        const int left = x + glyph.minX;
+        if (left < minX)
+            minX = left;
+        const int right = x + (glyph.maxX > glyph.advance
+            ? glyph.maxX : glyph.advance);
+        if (right > maxX)
+            maxX = right;
+        x += glyph.advance;
+        width = maxX - minX;
+        prev = chr;
+        pos += len;
+    }
+    return sz;
+}
+
+int FontMetrics::getWidth(TTF_Font *const font,
+                          const std::string &text) const
+{
+    int width;
+    measure(font, text, std::numeric_limits<int>::max(), width);
+    return width;
+}
+
+int FontMetrics::getStringIndexAt(TTF_Font *const font,
+                                  const std::string &text,
+                                  const int x) const
+{
+    int width;
+    return static_cast<int>(measure(font, text, x, width));
+}
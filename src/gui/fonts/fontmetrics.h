@@ -0,0 +1,106 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUI_FONTS_FONTMETRICS_H
+#define GUI_FONTS_FONTMETRICS_H
+
+#include <map>
+#include <string>
+
+#include <SDL_ttf.h>
+
+#include "localconsts.h"
+
+// buffer for one zero terminated utf8 char
+const int GLYPH_BUF_SIZE = 8;
+
+struct GlyphMetrics final
+{
+    int advance;
+    int minX;
+    int maxX;
+};
+
+/**
+ * Cached glyph advances and kerning of one font. Measures strings in one
+ * pass, same way as TTF_SizeUTF8 does.
+ */
+class FontMetrics final
+{
+    public:
+        FontMetrics();
+
+        A_DELETE_COPY(FontMetrics)
+
+        int getWidth(TTF_Font *const font,
+                     const std::string &text) const A_WARN_UNUSED;
+
+        /**
+         * Returns index of first char what have text before it wider than
+         * x, or text size.
+         */
+        int getStringIndexAt(TTF_Font *const font,
+                             const std::string &text,
+                             const int x) const A_WARN_UNUSED;
+
+        /**
+         * Returns metrics of char chr, str is same char in utf8.
+         */
+        const GlyphMetrics &getGlyph(TTF_Font *const font,
+                                     const char *const str,
+                                     const uint32_t chr) const A_WARN_UNUSED;
+
+        int getKerning(TTF_Font *const font,
+                       const uint32_t prev,
+                       const uint32_t chr) const A_WARN_UNUSED;
+
+        void clear();
+
+        /**
+         * Reads one utf8 char from text at pos to zero padded buf.
+         * Returns char size, broken sequence read as single byte.
+         */
+        static int readChar(const std::string &text,
+                            const size_t pos,
+                            char *const buf,
+                            uint32_t &chr);
+
+    private:
+        size_t measure(TTF_Font *const font,
+                       const std::string &text,
+                       const int maxWidth,
+                       int &width) const;
+
+        void loadGlyph(TTF_Font *const font,
+                       const char *const str,
+                       const uint32_t chr,
+                       GlyphMetrics &glyph) const;
+
+        static int calcOverhang(TTF_Font *const font) A_WARN_UNUSED;
+
+        // ascii glyphs, advance -1 if not loaded
+        mutable GlyphMetrics mAsciiGlyphs[128];
+        mutable std::map<uint32_t, GlyphMetrics> mGlyphs;
+        mutable std::map<uint32_t, int> mKernings;
+        // extra advance of emulated bold, -1 if not calculated
+        mutable int mOverhang;
+};
+
+#endif  // GUI_FONTS_FONTMETRICS_H
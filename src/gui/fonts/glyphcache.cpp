@@ -0,0 +1,310 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gui/fonts/glyphcache.h"
+
+#include "gui/fonts/fontmetrics.h"
+
+#include "render/graphics.h"
+
+#include "resources/image.h"
+#include "resources/imagehelper.h"
+#include "resources/surfaceimagehelper.h"
+
+#include "utils/delete2.h"
+#include "utils/sdlcheckutils.h"
+
+#include "debug.h"
+
+namespace
+{
+    const int OUTLINE_SIZE = 1;
+    const int PAGE_SIZE = 512;
+    const int MAX_PAGES = 4;
+
+    const Color white(255, 255, 255);
+}  // namespace
+
+GlyphCache::GlyphCache() :
+    mGlyphs(),
+    mPages(),
+    mPage(-1),
+    mUseCounter(0U)
+{
+}
+
+GlyphCache::~GlyphCache()
+{
+    clear();
+}
+
+bool GlyphCache::isFitting(TTF_Font *const font)
+{
+    return font && TTF_FontHeight(font) * 4 <= PAGE_SIZE;
+}
+
+void GlyphCache::drawString(Graphics *const graphics,
+                            TTF_Font *const font,
+                            const FontMetrics &metrics,
+                            const std::string &text,
+                            const int x, const int y,
+                            const Color &color,
+                            const Color &color2,
+                            const float alpha)
+{
+    BLOCK_START("GlyphCache::drawString")
+    mUseCounter ++;
+    // same as in TextChunk, outline of whole string under text
+    if (color.r != color2.r || color.g != color2.g || color.b != color2.b)
+    {
+        graphics->setImageColor(color2);
+        drawGlyphs(graphics, font, metrics, text, x, y, alpha, true);
+    }
+    graphics->setImageColor(color);
+    drawGlyphs(graphics, font, metrics, text, x, y, alpha, false);
+    graphics->setImageColor(white);
+    BLOCK_END("GlyphCache::drawString")
+}
+
+void GlyphCache::drawGlyphs(Graphics *const graphics,
+                            TTF_Font *const font,
+                            const FontMetrics &metrics,
+                            const std::string &text,
+                            int x, const int y,
+                            const float alpha,
+                            const bool outline)
+{
+    char buf[GLYPH_BUF_SIZE];
+    const size_t sz = text.size();
+    size_t pos = 0;
+    uint32_t prev = 0;
+    while (pos < sz)
+    {
+        uint32_t chr;
+        const int len = FontMetrics::readChar(text, pos, buf, chr);
+        const GlyphMetrics &metric = metrics.getGlyph(font, buf, chr);
+        x += metrics.getKerning(font, prev, chr);
+        // same as in rendered strings, first glyph not go left from x
+        if (!pos && metric.minX < 0)
+            x -= metric.minX;
+        const GlyphItem *const glyph = getGlyph(font, buf, chr,
+            metric.minX, outline);
+        Image *const image = glyph->image;
+        if (image)
+        {
+            image->setAlpha(alpha);
+            graphics->drawImage(image, x + glyph->offsetX, y);
+        }
+        x += metric.advance;
+        prev = chr;
+        pos += len;
+    }
+}
+
+const GlyphCache::GlyphItem *GlyphCache::getGlyph(TTF_Font *const font,
+                                                  const char *const str,
+                                                  const uint32_t chr,
+                                                  const int minX,
+                                                  const bool outline)
+{
+    const uint32_t key = (chr << 1) | (outline ? 1U : 0U);
+    const GlyphMapIter it = mGlyphs.find(key);
+    if (it != mGlyphs.end())
+    {
+        GlyphItem &glyph = (*it).second;
+        if (glyph.page >= 0)
+            mPages[glyph.page].lastUse = mUseCounter;
+        return &glyph;
+    }
+
+    GlyphItem glyph;
+    // glyph with negative minx rendered moved right
+    glyph.offsetX = minX < 0 ? minX : 0;
+    if (outline)
+        glyph.offsetX -= OUTLINE_SIZE;
+
+    SDL_Surface *const surface = renderGlyph(font, str, outline);
+    if (surface)
+    {
+        addImage(surface, glyph);
+        MSDL_FreeSurface(surface);
+    }
+    return &(mGlyphs[key] = glyph);
+}
+
+SDL_Surface *GlyphCache::renderGlyph(TTF_Font *const font,
+                                     const char *const str,
+                                     const bool outline)
+{
+    SDL_Color sdlCol;
+    sdlCol.b = 255;
+    sdlCol.r = 255;
+    sdlCol.g = 255;
+#ifdef USE_SDL2
+    sdlCol.a = 255;
+#else
+    sdlCol.unused = 0;
+#endif
+
+    SDL_Surface *const surface = MTTF_RenderUTF8_Blended(
+        font, str, sdlCol);
+    if (!surface || !outline)
+        return surface;
+
+    // outline only, same shifts as in TextChunk with space on sides
+    SDL_Surface *const background = imageHelper->create32BitSurface(
+        surface->w + OUTLINE_SIZE * 2, surface->h);
+    if (!background)
+    {
+        MSDL_FreeSurface(surface);
+        return nullptr;
+    }
+    SDL_Rect rect =
+    {
+        0,
+        0,
+        static_cast<Uint16>(surface->w),
+        static_cast<Uint16>(surface->h)
+    };
+    SurfaceImageHelper::combineSurface(surface, nullptr,
+        background, &rect);
+    rect.x = OUTLINE_SIZE * 2;
+    SurfaceImageHelper::combineSurface(surface, nullptr,
+        background, &rect);
+    rect.x = OUTLINE_SIZE;
+    rect.y = -OUTLINE_SIZE;
+    SurfaceImageHelper::combineSurface(surface, nullptr,
+        background, &rect);
+    rect.y = OUTLINE_SIZE;
+    SurfaceImageHelper::combineSurface(surface, nullptr,
+        background, &rect);
+    MSDL_FreeSurface(surface);
+    return background;
+}
+
+bool GlyphCache::addImage(SDL_Surface *const surface,
+                          GlyphItem &glyph)
+{
+    const int width = surface->w;
+    const int height = surface->h;
+    if (width > PAGE_SIZE || height > PAGE_SIZE)
+        return false;
+
+    const int pageIndex = getPage(width, height);
+    if (pageIndex < 0)
+        return false;
+
+    GlyphPage &page = mPages[pageIndex];
+    imageHelper->copySurfaceToImage(page.image, page.x, page.y, surface);
+    Image *const image = page.image->getSubImage(page.x, page.y,
+        width, height);
+    if (!image)
+        return false;
+    image->setNotCount(true);
+    page.x += width + 1;
+    if (height > page.rowHeight)
+        page.rowHeight = height;
+    page.lastUse = mUseCounter;
+    glyph.image = image;
+    glyph.page = pageIndex;
+    return true;
+}
+
+int GlyphCache::getPage(const int width, const int height)
+{
+    if (mPage >= 0)
+    {
+        GlyphPage &page = mPages[mPage];
+        if (page.x + width > PAGE_SIZE)
+        {
+            page.x = 0;
+            page.y += page.rowHeight + 1;
+            page.rowHeight = 0;
+        }
+        if (page.y + height <= PAGE_SIZE)
+            return mPage;
+    }
+
+    if (static_cast<int>(mPages.size()) < MAX_PAGES)
+    {
+        mPages.push_back(GlyphPage());
+        mPage = static_cast<int>(mPages.size()) - 1;
+    }
+    else
+    {
+        // all pages full, replace least recently used one
+        int oldest = 0;
+        for (int f = 1; f < MAX_PAGES; f ++)
+        {
+            if (mPages[f].lastUse < mPages[oldest].lastUse)
+                oldest = f;
+        }
+        mPage = oldest;
+    }
+    if (!resetPage(mPage))
+    {
+        mPage = -1;
+        return -1;
+    }
+    return mPage;
+}
+
+bool GlyphCache::resetPage(const int pageIndex)
+{
+    GlyphMapIter it = mGlyphs.begin();
+    while (it != mGlyphs.end())
+    {
+        if ((*it).second.page == pageIndex)
+        {
+            delete (*it).second.image;
+            mGlyphs.erase(it++);
+        }
+        else
+        {
+            ++ it;
+        }
+    }
+
+    GlyphPage &page = mPages[pageIndex];
+    delete2(page.image);
+    page = GlyphPage();
+    SDL_Surface *const surface = imageHelper->create32BitSurface(
+        PAGE_SIZE, PAGE_SIZE);
+    if (!surface)
+        return false;
+    page.image = imageHelper->load(surface);
+    MSDL_FreeSurface(surface);
+    if (!page.image)
+        return false;
+    page.image->setNotCount(true);
+    page.lastUse = mUseCounter;
+    return true;
+}
+
+void GlyphCache::clear()
+{
+    FOR_EACH (GlyphMapIter, it, mGlyphs)
+        delete (*it).second.image;
+    mGlyphs.clear();
+    FOR_EACH (std::vector<GlyphPage>::iterator, it, mPages)
+        delete (*it).image;
+    mPages.clear();
+    mPage = -1;
+}
@@ -0,0 +1,142 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUI_FONTS_GLYPHCACHE_H
+#define GUI_FONTS_GLYPHCACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <SDL_ttf.h>
+
+#include "localconsts.h"
+
+class Color;
+class FontMetrics;
+class Graphics;
+class Image;
+
+struct SDL_Surface;
+
+/**
+ * Glyphs of one font, rendered once in white into shared atlas pages.
+ * Strings drawn as sub images of pages with text colors set as image
+ * color, what renderers with image batching merge into few draw calls.
+ * If all pages are full, least recently used page is replaced.
+ */
+class GlyphCache final
+{
+    public:
+        GlyphCache();
+
+        A_DELETE_COPY(GlyphCache)
+
+        ~GlyphCache();
+
+        /**
+         * Draws text at glyph positions from metrics.
+         */
+        void drawString(Graphics *const graphics,
+                        TTF_Font *const font,
+                        const FontMetrics &metrics,
+                        const std::string &text,
+                        const int x, const int y,
+                        const Color &color,
+                        const Color &color2,
+                        const float alpha);
+
+        void clear();
+
+        /**
+         * Returns true if glyphs of this font fit in atlas pages.
+         */
+        static bool isFitting(TTF_Font *const font) A_WARN_UNUSED;
+
+    private:
+        struct GlyphItem final
+        {
+            GlyphItem() :
+                image(nullptr),
+                page(-1),
+                offsetX(0)
+            {
+            }
+
+            Image *image;
+            int page;
+            int offsetX;
+        };
+
+        struct GlyphPage final
+        {
+            GlyphPage() :
+                image(nullptr),
+                x(0),
+                y(0),
+                rowHeight(0),
+                lastUse(0U)
+            {
+            }
+
+            Image *image;
+            int x;
+            int y;
+            int rowHeight;
+            unsigned lastUse;
+        };
+
+        // glyph or outline of glyph, outline flag in lowest bit
+        typedef std::map<uint32_t, GlyphItem> GlyphMap;
+        typedef GlyphMap::iterator GlyphMapIter;
+
+        void drawGlyphs(Graphics *const graphics,
+                        TTF_Font *const font,
+                        const FontMetrics &metrics,
+                        const std::string &text,
+                        int x, const int y,
+                        const float alpha,
+                        const bool outline);
+
+        const GlyphItem *getGlyph(TTF_Font *const font,
+                                  const char *const str,
+                                  const uint32_t chr,
+                                  const int minX,
+                                  const bool outline);
+
+        static SDL_Surface *renderGlyph(TTF_Font *const font,
+                                        const char *const str,
+                                        const bool outline) A_WARN_UNUSED;
+
+        bool addImage(SDL_Surface *const surface,
+                      GlyphItem &glyph);
+
+        int getPage(const int width, const int height) A_WARN_UNUSED;
+
+        bool resetPage(const int page);
+
+        GlyphMap mGlyphs;
+        std::vector<GlyphPage> mPages;
+        // page where new glyphs added
+        int mPage;
+        unsigned mUseCounter;
+};
+
+#endif  // GUI_FONTS_GLYPHCACHE_H
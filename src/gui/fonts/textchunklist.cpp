@@ -28,8 +28,7 @@ TextChunkList::TextChunkList() :
     start(nullptr),
     end(nullptr),
     size(0),
-    search(),
-    searchWidth()
+    search()
 {
 }
 
@@ -46,7 +45,6 @@ void TextChunkList::insertFirst(TextChunk *const item)
     start = item;
     size ++;
     search[TextChunkSmall(item->text, item->color, item->color2)] = item;
-    searchWidth[item->text] = item;
 }
 
 void TextChunkList::moveToFirst(TextChunk *const item)
@@ -82,7 +80,6 @@ void TextChunkList::removeBack()
             start = nullptr;
         search.erase(TextChunkSmall(oldEnd->text,
             oldEnd->color, oldEnd->color2));
-        searchWidth.erase(oldEnd->text);
         delete oldEnd;
         size --;
     }
@@ -98,7 +95,6 @@ void TextChunkList::removeBack(int n)
         item = item->prev;
         search.erase(TextChunkSmall(oldEnd->text,
             oldEnd->color, oldEnd->color2));
-        searchWidth.erase(oldEnd->text);
         delete oldEnd;
         size --;
     }
@@ -117,7 +113,6 @@ void TextChunkList::removeBack(int n)
 void TextChunkList::clear()
 {
     search.clear();
-    searchWidth.clear();
     TextChunk *item = start;
     while (item)
     {
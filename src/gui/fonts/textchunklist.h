@@ -50,7 +50,6 @@ class TextChunkList final
         TextChunk *end;
         uint32_t size;
         std::map<TextChunkSmall, TextChunk*> search;
-        std::map<std::string, TextChunk*> searchWidth;
 };
 
 #endif  // GUI_FONTS_TEXTCHUNKLIST_H
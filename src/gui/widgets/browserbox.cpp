@@ -41,6 +41,7 @@
 
 #include "resources/db/itemdb.h"
 
+#include "utils/dtor.h"
 #include "utils/stringutils.h"
 #include "utils/timer.h"
 #include "utils/translation/podict.h"
@@ -77,7 +78,7 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     MouseListener(),
     mTextRows(),
     mTextRowLinksCount(),
-    mLineParts(),
+    mRowLayouts(),
     mLinks(),
     mLinkHandler(nullptr),
     mSkin(nullptr),
@@ -93,6 +94,7 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     mNewLinePadding(15),
     mItemPadding(0),
     mDataWidth(0),
+    mLayoutWidth(-1),
     mHighlightColor(getThemeColor(Theme::HIGHLIGHT)),
     mHyperLinkColor(getThemeColor(Theme::HYPERLINK)),
     mOpaque(opaque),
@@ -168,6 +170,8 @@ BrowserBox::~BrowserBox()
         mSkin = nullptr;
     }
 
+    delete_all(mRowLayouts);
+
     mInstances --;
     if (mInstances == 0)
     {
@@ -313,11 +317,13 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
     {
         mTextRows.push_front(newRow);
         mTextRowLinksCount.push_front(linksCount);
+        mRowLayouts.push_front(new BrowserRow);
     }
     else
     {
         mTextRows.push_back(newRow);
         mTextRowLinksCount.push_back(linksCount);
+        mRowLayouts.push_back(new BrowserRow);
     }
 
     // discard older rows when a row limit has been set
@@ -328,6 +334,8 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
             mTextRows.pop_front();
             int cnt = mTextRowLinksCount.front();
             mTextRowLinksCount.pop_front();
+            delete mRowLayouts.front();
+            mRowLayouts.pop_front();
 
             while (cnt && !mLinks.empty())
             {
@@ -354,61 +362,8 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
             setWidth(w);
     }
 
-    const int fontHeight = font->getHeight();
-    if (mMode == AUTO_WRAP)
-    {
-        unsigned int y = 0;
-        unsigned int nextChar;
-        const char *const hyphen = "~";
-        const int hyphenWidth = font->getWidth(hyphen);
-        unsigned x = 0;
-
-        FOR_EACH (TextRowCIter, i, mTextRows)
-        {
-            std::string tempRow = *i;
-            for (unsigned int j = 0, sz = static_cast<unsigned int>(
-                 tempRow.size()); j < sz; j++)
-            {
-                const std::string character = tempRow.substr(j, 1);
-                x += font->getWidth(character);
-                nextChar = j + 1;
-
-                // Wraping between words (at blank spaces)
-                if (nextChar < sz && tempRow.at(nextChar) == ' ')
-                {
-                    int nextSpacePos = static_cast<int>(
-                        tempRow.find(" ", (nextChar + 1)));
-                    if (nextSpacePos <= 0)
-                        nextSpacePos = static_cast<int>(sz) - 1;
-
-                    const unsigned nextWordWidth = font->getWidth(
-                        tempRow.substr(nextChar,
-                        (nextSpacePos - nextChar)));
-
-                    if ((x + nextWordWidth + 10)
-                        > static_cast<unsigned>(getWidth()))
-                    {
-                        x = mNewLinePadding;  // Ident in new line
-                        y += 1;
-                        j ++;
-                    }
-                }
-                // Wrapping looong lines (brutal force)
-                else if ((x + 2 * hyphenWidth)
-                         > static_cast<unsigned>(getWidth()))
-                {
-                    x = mNewLinePadding;  // Ident in new line
-                    y += 1;
-                }
-            }
-        }
-
-        setHeight(fontHeight * (static_cast<int>(mTextRows.size()) + y));
-    }
-    else
-    {
-        setHeight(fontHeight * static_cast<int>(mTextRows.size()));
-    }
+    // real height set from row layouts in updateHeight
+    setHeight(font->getHeight() * static_cast<int>(mTextRows.size()));
     mUpdateTime = 0;
     updateHeight();
 }
@@ -426,12 +381,15 @@ void BrowserBox::addImage(const std::string &path)
 
     mTextRows.push_back("~~~" + path);
     mTextRowLinksCount.push_back(0);
+    mRowLayouts.push_back(new BrowserRow);
 }
 
 void BrowserBox::clearRows()
 {
     mTextRows.clear();
     mTextRowLinksCount.clear();
+    delete_all(mRowLayouts);
+    mRowLayouts.clear();
     mLinks.clear();
     setWidth(0);
     setHeight(0);
@@ -516,24 +474,36 @@ void BrowserBox::draw(Graphics *graphics)
 
     Font *const font = getFont();
 
-    FOR_EACH (LinePartCIter, i, mLineParts)
+    FOR_EACH (BrowserRowCIter, it, mRowLayouts)
     {
-        const LinePart &part = *i;
-        if (part.mY + 50 < mYStart)
+        const BrowserRow *const layout = *it;
+        const int rowY = layout->y;
+        if (rowY + layout->yAdvance + 50 < mYStart)
             continue;
-        if (part.mY > yEnd)
-            break;
-        if (!part.mType)
-        {
-            graphics->setColorAll(part.mColor, part.mColor2);
-            if (part.mBold)
-                boldFont->drawString(graphics, part.mText, part.mX, part.mY);
-            else
-                font->drawString(graphics, part.mText, part.mX, part.mY);
-        }
-        else if (part.mImage)
+
+        FOR_EACH (LinePartCIter, i, layout->parts)
         {
-            graphics->drawImage(part.mImage, part.mX, part.mY);
+            const LinePart &part = *i;
+            const int y = rowY + part.mY;
+            if (y + 50 < mYStart)
+                continue;
+            if (y > yEnd)
+            {
+                BLOCK_END("BrowserBox::draw")
+                return;
+            }
+            if (!part.mType)
+            {
+                graphics->setColorAll(part.mColor, part.mColor2);
+                if (part.mBold)
+                    boldFont->drawString(graphics, part.mText, part.mX, y);
+                else
+                    font->drawString(graphics, part.mText, part.mX, y);
+            }
+            else if (part.mImage)
+            {
+                graphics->drawImage(part.mImage, part.mX, y);
+            }
         }
     }
 
@@ -542,342 +512,392 @@ void BrowserBox::draw(Graphics *graphics)
 
 int BrowserBox::calcHeight()
 {
-    unsigned int y = mPadding;
-    int wrappedLines = 0;
-    int moreHeight = 0;
     int maxWidth = getWidth() - mPadding;
-    int link = 0;
-    bool bold = false;
-    unsigned int wWidth = maxWidth;
-
     if (maxWidth < 0)
         return 1;
 
+    const unsigned int wWidth = maxWidth;
+    const Font *const font = getFont();
+    const int fontHeight = font->getHeight() + 2 * mItemPadding;
+    // rows wrapped again only if width changed
+    const bool relayout = mLayoutWidth != maxWidth;
+    mLayoutWidth = maxWidth;
+
+    Color selColor[2] = {mForegroundColor, mForegroundColor2};
+    int y = mPadding;
+    int height = 0;
+    size_t link = 0;
+    const size_t linksSize = mLinks.size();
+    TextRowCIter rowIt = mTextRows.begin();
+
+    FOR_EACH (BrowserRowIter, it, mRowLayouts)
+    {
+        BrowserRow *const layout = *it;
+        // colors left from previous row used in this row
+        if (relayout
+            || !layout->valid
+            || layout->startColor[0] != selColor[0]
+            || layout->startColor[1] != selColor[1])
+        {
+            layoutRow(*rowIt, layout, selColor, wWidth);
+        }
+        ++ rowIt;
+        selColor[0] = layout->endColor[0];
+        selColor[1] = layout->endColor[1];
+        layout->y = y;
+
+        FOR_EACH (std::vector<BrowserRowLink>::iterator, it2, layout->links)
+        {
+            if (link >= linksSize)
+                break;
+            BrowserRowLink &rowLink = *it2;
+            BrowserLink &bLink = mLinks[link];
+            if (rowLink.width < 0)
+                rowLink.width = font->getWidth(bLink.caption) + 1;
+            bLink.x1 = rowLink.x;
+            bLink.y1 = y + rowLink.y;
+            bLink.x2 = bLink.x1 + rowLink.width;
+            bLink.y2 = bLink.y1 + fontHeight - 1;
+            link ++;
+        }
+
+        y += layout->yAdvance;
+        height += layout->height;
+        if (layout->imageWidth > maxWidth)
+            maxWidth = layout->imageWidth + 2;
+        if (layout->dataWidth > mDataWidth)
+            mDataWidth = layout->dataWidth;
+    }
+    if (static_cast<signed>(wWidth) != maxWidth)
+        setWidth(maxWidth);
+
+    return height + 2 * mPadding;
+}
+
+void BrowserBox::layoutRow(const std::string &row,
+                           BrowserRow *const layout,
+                           const Color *const startColor,
+                           const unsigned int wWidth)
+{
+    unsigned int x = mPadding;
+    unsigned int y = 0;
+    bool wrapped = false;
+    bool bold = false;
+    int objects = 0;
+
     const Font *const font = getFont();
     const int fontHeight = font->getHeight() + 2 * mItemPadding;
     const int fontWidthMinus = font->getWidth("-");
     const char *const hyphen = "~";
     const int hyphenWidth = font->getWidth(hyphen);
 
-    Color selColor[2] = {mForegroundColor, mForegroundColor2};
+    Color selColor[2] = {startColor[0], startColor[1]};
     const Color textColor[2] = {mForegroundColor, mForegroundColor2};
     ResourceManager *const resman = ResourceManager::getInstance();
 
-    mLineParts.clear();
-
-    FOR_EACH (TextRowCIter, i, mTextRows)
+    layout->parts.clear();
+    layout->links.clear();
+    layout->startColor[0] = startColor[0];
+    layout->startColor[1] = startColor[1];
+    layout->endColor[0] = startColor[0];
+    layout->endColor[1] = startColor[1];
+    layout->yAdvance = 0;
+    layout->height = fontHeight;
+    layout->imageWidth = 0;
+    layout->dataWidth = 0;
+    layout->valid = true;
+
+    // Check for separator lines
+    if (row.find("---", 0) == 0)
     {
-        unsigned int x = mPadding;
-        const std::string row = *(i);
-        bool wrapped = false;
-        int objects = 0;
-
-        // Check for separator lines
-        if (row.find("---", 0) == 0)
+        const int dashWidth = fontWidthMinus;
+        for (x = mPadding; x < wWidth; x ++)
         {
-            const int dashWidth = fontWidthMinus;
-            for (x = mPadding; x < wWidth; x ++)
-            {
-                mLineParts.push_back(LinePart(x, y + mItemPadding,
-                    selColor[0], selColor[1], "-", false));
-                x += dashWidth - 2;
-            }
-
-            y += fontHeight;
-            continue;
+            layout->parts.push_back(LinePart(x, y + mItemPadding,
+                selColor[0], selColor[1], "-", false));
+            x += dashWidth - 2;
         }
-        else if (mEnableImages && row.find("~~~", 0) == 0)
+
+        layout->yAdvance = fontHeight;
+        return;
+    }
+    else if (mEnableImages && row.find("~~~", 0) == 0)
+    {
+        std::string str = row.substr(3);
+        const size_t sz = str.size();
+        if (sz > 2 && str.substr(sz - 1) == "~")
+            str = str.substr(0, sz - 1);
+        Image *const img = resman->getImage(str);
+        if (img)
         {
-            std::string str = row.substr(3);
-            const size_t sz = str.size();
-            if (sz > 2 && str.substr(sz - 1) == "~")
-                str = str.substr(0, sz - 1);
-            Image *const img = resman->getImage(str);
-            if (img)
-            {
-                img->incRef();
-                mLineParts.push_back(LinePart(x, y + mItemPadding,
-                    selColor[0], selColor[1], img));
-                y += img->getHeight() + 2;
-                moreHeight += img->getHeight();
-                if (img->getWidth() > maxWidth)
-                    maxWidth = img->getWidth() + 2;
-            }
-            continue;
+            img->incRef();
+            layout->parts.push_back(LinePart(x, y + mItemPadding,
+                selColor[0], selColor[1], img));
+            layout->yAdvance = img->getHeight() + 2;
+            layout->height += img->getHeight();
+            layout->imageWidth = img->getWidth();
         }
+        return;
+    }
 
-        Color prevColor[2];
-        prevColor[0] = selColor[0];
-        prevColor[1] = selColor[1];
-        bold = false;
+    Color prevColor[2];
+    prevColor[0] = selColor[0];
+    prevColor[1] = selColor[1];
 
-        for (size_t start = 0, end = std::string::npos;
-             start != std::string::npos;
-             start = end, end = std::string::npos)
-        {
-            bool processed(false);
+    for (size_t start = 0, end = std::string::npos;
+         start != std::string::npos;
+         start = end, end = std::string::npos)
+    {
+        bool processed(false);
 
-            // Wrapped line continuation shall be indented
-            if (wrapped)
-            {
-                y += fontHeight;
-                x = mNewLinePadding + mPadding;
-                wrapped = false;
-            }
+        // Wrapped line continuation shall be indented
+        if (wrapped)
+        {
+            y += fontHeight;
+            x = mNewLinePadding + mPadding;
+            wrapped = false;
+        }
 
-            size_t idx1 = end;
-            size_t idx2 = end;
+        size_t idx1 = end;
+        size_t idx2 = end;
 
-            // "Tokenize" the string at control sequences
-            if (mUseLinksAndUserColors)
-                idx1 = row.find("##", start + 1);
-            if (idx1 < idx2)
-                end = idx1;
-            else
-                end = idx2;
+        // "Tokenize" the string at control sequences
+        if (mUseLinksAndUserColors)
+            idx1 = row.find("##", start + 1);
+        if (idx1 < idx2)
+            end = idx1;
+        else
+            end = idx2;
 
-            if (start == 0 || mUseLinksAndUserColors)
+        if (start == 0 || mUseLinksAndUserColors)
+        {
+            // Check for color change in format "##x", x = [L,P,0..9]
+            if (row.find("##", start) == start && row.size() > start + 2)
             {
-                // Check for color change in format "##x", x = [L,P,0..9]
-                if (row.find("##", start) == start && row.size() > start + 2)
-                {
-                    const signed char c = row.at(start + 2);
+                const signed char c = row.at(start + 2);
 
-                    bool valid(false);
-                    const Color col[2] =
-                    {
-                        getThemeCharColor(c, valid),
-                        getThemeCharColor(static_cast<signed char>(
-                            c | 0x80), valid)
-                    };
+                bool valid(false);
+                const Color col[2] =
+                {
+                    getThemeCharColor(c, valid),
+                    getThemeCharColor(static_cast<signed char>(
+                        c | 0x80), valid)
+                };
 
-                    if (c == '>')
-                    {
-                        selColor[0] = prevColor[0];
-                        selColor[1] = prevColor[1];
-                    }
-                    else if (c == '<')
-                    {
-                        prevColor[0] = selColor[0];
-                        prevColor[1] = selColor[1];
-                        selColor[0] = col[0];
-                        selColor[1] = col[1];
-                    }
-                    else if (c == 'B')
-                    {
-                        bold = true;
-                    }
-                    else if (c == 'b')
-                    {
-                        bold = false;
-                    }
-                    else if (valid)
+                if (c == '>')
+                {
+                    selColor[0] = prevColor[0];
+                    selColor[1] = prevColor[1];
+                }
+                else if (c == '<')
+                {
+                    prevColor[0] = selColor[0];
+                    prevColor[1] = selColor[1];
+                    selColor[0] = col[0];
+                    selColor[1] = col[1];
+                }
+                else if (c == 'B')
+                {
+                    bold = true;
+                }
+                else if (c == 'b')
+                {
+                    bold = false;
+                }
+                else if (valid)
+                {
+                    selColor[0] = col[0];
+                    selColor[1] = col[1];
+                }
+                else
+                {
+                    switch (c)
                     {
-                        selColor[0] = col[0];
-                        selColor[1] = col[1];
-                    }
-                    else
-                    {
-                        switch (c)
-                        {
-                            case '0':
-                                selColor[0] = mColors[0][BLACK];
-                                selColor[1] = mColors[1][BLACK];
-                                break;
-                            case '1':
-                                selColor[0] = mColors[0][RED];
-                                selColor[1] = mColors[1][RED];
-                                break;
-                            case '2':
-                                selColor[0] = mColors[0][GREEN];
-                                selColor[1] = mColors[1][GREEN];
-                                break;
-                            case '3':
-                                selColor[0] = mColors[0][BLUE];
-                                selColor[1] = mColors[1][BLUE];
-                                break;
-                            case '4':
-                                selColor[0] = mColors[0][ORANGE];
-                                selColor[1] = mColors[1][ORANGE];
-                                break;
-                            case '5':
-                                selColor[0] = mColors[0][YELLOW];
-                                selColor[1] = mColors[1][YELLOW];
-                                break;
-                            case '6':
-                                selColor[0] = mColors[0][PINK];
-                                selColor[1] = mColors[1][PINK];
-                                break;
-                            case '7':
-                                selColor[0] = mColors[0][PURPLE];
-                                selColor[1] = mColors[1][PURPLE];
-                                break;
-                            case '8':
-                                selColor[0] = mColors[0][GRAY];
-                                selColor[1] = mColors[1][GRAY];
-                                break;
-                            case '9':
-                                selColor[0] = mColors[0][BROWN];
-                                selColor[1] = mColors[1][BROWN];
-                                break;
-                            default:
-                                selColor[0] = textColor[0];
-                                selColor[1] = textColor[1];
-                                break;
-                        }
+                        case '0':
+                            selColor[0] = mColors[0][BLACK];
+                            selColor[1] = mColors[1][BLACK];
+                            break;
+                        case '1':
+                            selColor[0] = mColors[0][RED];
+                            selColor[1] = mColors[1][RED];
+                            break;
+                        case '2':
+                            selColor[0] = mColors[0][GREEN];
+                            selColor[1] = mColors[1][GREEN];
+                            break;
+                        case '3':
+                            selColor[0] = mColors[0][BLUE];
+                            selColor[1] = mColors[1][BLUE];
+                            break;
+                        case '4':
+                            selColor[0] = mColors[0][ORANGE];
+                            selColor[1] = mColors[1][ORANGE];
+                            break;
+                        case '5':
+                            selColor[0] = mColors[0][YELLOW];
+                            selColor[1] = mColors[1][YELLOW];
+                            break;
+                        case '6':
+                            selColor[0] = mColors[0][PINK];
+                            selColor[1] = mColors[1][PINK];
+                            break;
+                        case '7':
+                            selColor[0] = mColors[0][PURPLE];
+                            selColor[1] = mColors[1][PURPLE];
+                            break;
+                        case '8':
+                            selColor[0] = mColors[0][GRAY];
+                            selColor[1] = mColors[1][GRAY];
+                            break;
+                        case '9':
+                            selColor[0] = mColors[0][BROWN];
+                            selColor[1] = mColors[1][BROWN];
+                            break;
+                        default:
+                            selColor[0] = textColor[0];
+                            selColor[1] = textColor[1];
+                            break;
                     }
+                }
 
-                    if (c == '<' && link < static_cast<signed>(mLinks.size()))
-                    {
-                        const int size =
-                            font->getWidth(mLinks[link].caption) + 1;
-
-                        mLinks[link].x1 = x;
-                        mLinks[link].y1 = y;
-                        mLinks[link].x2 = mLinks[link].x1 + size;
-                        mLinks[link].y2 = y + fontHeight - 1;
-                        link++;
-                    }
+                if (c == '<')
+                    layout->links.push_back(BrowserRowLink(x, y));
 
-                    processed = true;
-                    start += 3;
-                    if (start == row.size())
-                        break;
-                }
+                processed = true;
+                start += 3;
+                if (start == row.size())
+                    break;
             }
-            if (mUseEmotes)
-                idx2 = row.find("%%", start + 1);
-            if (idx1 < idx2)
-                end = idx1;
-            else
-                end = idx2;
-            if (mUseEmotes)
+        }
+        if (mUseEmotes)
+            idx2 = row.find("%%", start + 1);
+        if (idx1 < idx2)
+            end = idx1;
+        else
+            end = idx2;
+        if (mUseEmotes)
+        {
+            // check for emote icons
+            if (row.size() > start + 2 && row.substr(start, 2) == "%%")
             {
-                // check for emote icons
-                if (row.size() > start + 2 && row.substr(start, 2) == "%%")
+                if (objects < 5)
                 {
-                    if (objects < 5)
+                    const int cid = row.at(start + 2) - '0';
+                    if (cid >= 0)
                     {
-                        const int cid = row.at(start + 2) - '0';
-                        if (cid >= 0)
+                        if (mEmotes)
                         {
-                            if (mEmotes)
+                            const size_t sz = mEmotes->size();
+                            if (static_cast<size_t>(cid) < sz)
                             {
-                                const size_t sz = mEmotes->size();
-                                if (static_cast<size_t>(cid) < sz)
+                                Image *const img = mEmotes->get(cid);
+                                if (img)
                                 {
-                                    Image *const img = mEmotes->get(cid);
-                                    if (img)
-                                    {
-                                        mLineParts.push_back(LinePart(
-                                            x, y + mItemPadding,
-                                            selColor[0], selColor[1], img));
-                                        x += 18;
-                                    }
+                                    layout->parts.push_back(LinePart(
+                                        x, y + mItemPadding,
+                                        selColor[0], selColor[1], img));
+                                    x += 18;
                                 }
                             }
                         }
-                        objects ++;
-                        processed = true;
                     }
+                    objects ++;
+                    processed = true;
+                }
 
-                    start += 3;
-                    if (start == row.size())
-                    {
-                        if (x > mDataWidth)
-                            mDataWidth = x;
-                        break;
-                    }
+                start += 3;
+                if (start == row.size())
+                {
+                    if (x > layout->dataWidth)
+                        layout->dataWidth = x;
+                    break;
                 }
             }
-            const size_t len = (end == std::string::npos) ? end : end - start;
+        }
+        const size_t len = (end == std::string::npos) ? end : end - start;
 
-            if (start >= row.length())
-                break;
+        if (start >= row.length())
+            break;
 
-            std::string part = row.substr(start, len);
-            int width = 0;
-            if (bold)
-                width = boldFont->getWidth(part);
-            else
-                width = font->getWidth(part);
+        std::string part = row.substr(start, len);
+        int width = 0;
+        if (bold)
+            width = boldFont->getWidth(part);
+        else
+            width = font->getWidth(part);
+
+        // Auto wrap mode
+        if (mMode == AUTO_WRAP && wWidth > 0 && width > 0
+            && (x + width + 10) > wWidth)
+        {
+            bool forced = false;
 
-            // Auto wrap mode
-            if (mMode == AUTO_WRAP && wWidth > 0 && width > 0
-                && (x + width + 10) > wWidth)
+            /* FIXME: This code layout makes it easy to crash remote
+               clients by talking garbage. Forged long utf-8 characters
+               will cause either a buffer underflow in substr or an
+               infinite loop in the main loop. */
+            do
             {
-                bool forced = false;
+                if (!forced)
+                    end = row.rfind(' ', end);
 
-                /* FIXME: This code layout makes it easy to crash remote
-                   clients by talking garbage. Forged long utf-8 characters
-                   will cause either a buffer underflow in substr or an
-                   infinite loop in the main loop. */
-                do
+                // Check if we have to (stupidly) force-wrap
+                if (end == std::string::npos || end <= start)
                 {
-                    if (!forced)
-                        end = row.rfind(' ', end);
-
-                    // Check if we have to (stupidly) force-wrap
-                    if (end == std::string::npos || end <= start)
-                    {
-                        forced = true;
-                        end = row.size();
-                        x += hyphenWidth;  // Account for the wrap-notifier
-                        continue;
-                    }
-
-                    // Skip to the start of the current character
-                    while ((row[end] & 192) == 128)
-                        end--;
-                    end--;  // And then to the last byte of the previous one
-
-                    part = row.substr(start, end - start + 1);
-                    if (bold)
-                        width = boldFont->getWidth(part);
-                    else
-                        width = font->getWidth(part);
+                    forced = true;
+                    end = row.size();
+                    x += hyphenWidth;  // Account for the wrap-notifier
+                    continue;
                 }
-                while (end > start && width > 0 && (x + width + 10) > wWidth);
 
-                if (forced)
-                {
-                    x -= hyphenWidth;  // Remove the wrap-notifier accounting
-                    mLineParts.push_back(LinePart(
-                        wWidth - hyphenWidth, y + mItemPadding,
-                        selColor[0], selColor[1], hyphen, bold));
-                    end++;  // Skip to the next character
-                }
+                // Skip to the start of the current character
+                while ((row[end] & 192) == 128)
+                    end--;
+                end--;  // And then to the last byte of the previous one
+
+                part = row.substr(start, end - start + 1);
+                if (bold)
+                    width = boldFont->getWidth(part);
                 else
-                {
-                    end += 2;  // Skip to after the space
-                }
+                    width = font->getWidth(part);
+            }
+            while (end > start && width > 0 && (x + width + 10) > wWidth);
 
-                wrapped = true;
-                wrappedLines++;
+            if (forced)
+            {
+                x -= hyphenWidth;  // Remove the wrap-notifier accounting
+                layout->parts.push_back(LinePart(
+                    wWidth - hyphenWidth, y + mItemPadding,
+                    selColor[0], selColor[1], hyphen, bold));
+                end++;  // Skip to the next character
+            }
+            else
+            {
+                end += 2;  // Skip to after the space
             }
 
-            mLineParts.push_back(LinePart(x, y + mItemPadding,
-                selColor[0], selColor[1], part.c_str(), bold));
+            wrapped = true;
+            layout->height += fontHeight;
+        }
 
-            if (bold)
-                width = boldFont->getWidth(part);
-            else
-                width = font->getWidth(part);
+        layout->parts.push_back(LinePart(x, y + mItemPadding,
+            selColor[0], selColor[1], part.c_str(), bold));
 
-            if (mMode == AUTO_WRAP && (width == 0 && !processed))
-                break;
+        if (bold)
+            width = boldFont->getWidth(part);
+        else
+            width = font->getWidth(part);
 
-            x += width;
-            if (x > mDataWidth)
-                mDataWidth = x;
-        }
-        y += fontHeight;
-    }
-    if (static_cast<signed>(wWidth) != maxWidth)
-        setWidth(maxWidth);
+        if (mMode == AUTO_WRAP && (width == 0 && !processed))
+            break;
 
-    return (static_cast<int>(mTextRows.size()) + wrappedLines)
-        * fontHeight + moreHeight + 2 * mPadding;
+        x += width;
+        if (x > layout->dataWidth)
+            layout->dataWidth = x;
+    }
+    layout->yAdvance = y + fontHeight;
+    layout->endColor[0] = selColor[0];
+    layout->endColor[1] = selColor[1];
 }
 
 void BrowserBox::updateHeight()
@@ -892,6 +912,11 @@ void BrowserBox::updateHeight()
     }
 }
 
+void BrowserBox::fontChanged()
+{
+    mLayoutWidth = -1;
+}
+
 std::string BrowserBox::getTextAtPos(const int x, const int y) const
 {
     int textX = 0;
@@ -905,22 +930,27 @@ std::string BrowserBox::getTextAtPos(const int x, const int y) const
     std::string str;
     int lastY = 0;
 
-    FOR_EACH (LinePartCIter, i, mLineParts)
+    FOR_EACH (BrowserRowCIter, it, mRowLayouts)
     {
-        const LinePart &part = *i;
-        if (part.mY + 50 < mYStart)
-            continue;
-        if (part.mY > textY)
-            break;
-
-        if (part.mY > lastY)
-        {
-            str = part.mText;
-            lastY = part.mY;
-        }
-        else
+        const BrowserRow *const layout = *it;
+        FOR_EACH (LinePartCIter, i, layout->parts)
         {
-            str.append(part.mText);
+            const LinePart &part = *i;
+            const int partY = layout->y + part.mY;
+            if (partY + 50 < mYStart)
+                continue;
+            if (partY > textY)
+                return str;
+
+            if (partY > lastY)
+            {
+                str = part.mText;
+                lastY = partY;
+            }
+            else
+            {
+                str.append(part.mText);
+            }
         }
     }
 
@@ -932,6 +962,7 @@ void BrowserBox::setForegroundColorAll(const Color &color1,
 {
     mForegroundColor = color1;
     mForegroundColor2 = color2;
+    mLayoutWidth = -1;
 }
 
 void BrowserBox::moveSelectionUp()
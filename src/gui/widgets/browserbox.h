@@ -53,6 +53,53 @@ struct BrowserLink final
     std::string caption;
 };
 
+struct BrowserRowLink final
+{
+    BrowserRowLink(const int x0, const int y0) :
+        x(x0),
+        y(y0),
+        width(-1)
+    {
+    }
+
+    int x;
+    int y;
+    // caption width, -1 if not calculated yet
+    int width;
+};
+
+/**
+ * Cached layout of one row. Line parts and links have y relative to row.
+ */
+struct BrowserRow final
+{
+    BrowserRow() :
+        parts(),
+        links(),
+        y(0),
+        yAdvance(0),
+        height(0),
+        imageWidth(0),
+        dataWidth(0),
+        valid(false)
+    {
+    }
+
+    A_DELETE_COPY(BrowserRow)
+
+    std::vector<LinePart> parts;
+    std::vector<BrowserRowLink> links;
+    // colors at row start and after row, next row starts with them
+    Color startColor[2];
+    Color endColor[2];
+    int y;
+    int yAdvance;
+    int height;
+    int imageWidth;
+    unsigned int dataWidth;
+    bool valid;
+};
+
 /**
  * A simple browser box able to handle links and forward events to the
  * parent conteiner.
@@ -125,6 +172,8 @@ class BrowserBox final : public Widget,
 
         void updateHeight();
 
+        void fontChanged() override final;
+
         /**
          * BrowserBox modes.
          */
@@ -202,6 +251,11 @@ class BrowserBox final : public Widget,
     private:
         int calcHeight() A_WARN_UNUSED;
 
+        void layoutRow(const std::string &row,
+                       BrowserRow *const layout,
+                       const Color *const startColor,
+                       const unsigned int wWidth);
+
         typedef TextRows::iterator TextRowIterator;
         typedef TextRows::const_iterator TextRowCIter;
         TextRows mTextRows;
@@ -210,7 +264,12 @@ class BrowserBox final : public Widget,
         typedef std::vector<LinePart> LinePartList;
         typedef LinePartList::iterator LinePartIterator;
         typedef LinePartList::const_iterator LinePartCIter;
-        LinePartList mLineParts;
+
+        // layouts of mTextRows, in same order
+        typedef std::list<BrowserRow*> BrowserRows;
+        typedef BrowserRows::iterator BrowserRowIter;
+        typedef BrowserRows::const_iterator BrowserRowCIter;
+        BrowserRows mRowLayouts;
 
         typedef std::vector<BrowserLink> Links;
         typedef Links::iterator LinkIterator;
@@ -230,6 +289,8 @@ class BrowserBox final : public Widget,
         int mNewLinePadding;
         int mItemPadding;
         unsigned int mDataWidth;
+        // wrap width of row layouts, -1 if layouts invalid
+        int mLayoutWidth;
 
         Color mHighlightColor;
         Color mHyperLinkColor;
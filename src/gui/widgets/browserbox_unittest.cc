@@ -28,24 +28,47 @@
 
 #include "resources/sdlimagehelper.h"
 
+#include "utils/stringutils.h"
+
 #include "gtest/gtest.h"
 
 #include <physfs.h>
 
+#include <ctime>
+
 #include "debug.h"
 
 extern const char *dirSeparator;
 
+namespace
+{
+    void initBrowserBoxTest()
+    {
+        PHYSFS_init("manaplus");
+        dirSeparator = "/";
+        client = new Client;
+        logger = new Logger();
+        imageHelper = new SDLImageHelper();
+        theme = new Theme;
+        Widget::setGlobalFont(new Font("/usr/share/fonts/truetype/"
+            "ttf-dejavu/DejaVuSans-Oblique.ttf", 18));
+    }
+
+    void addTestRows(BrowserBox *const box, const int count)
+    {
+        for (int f = 0; f < count; f ++)
+        {
+            box->addRow(strprintf("##%dPlayer%d: some chat text with few "
+                "words, what need wrapping %d", f % 10, f % 7, f));
+            if (f % 5 == 0)
+                box->addRow("longwordwithoutanyspacesforcedtowrap");
+        }
+    }
+}  // namespace
+
 TEST(browserbox, test1)
 {
-    PHYSFS_init("manaplus");
-    dirSeparator = "/";
-    client = new Client;
-    logger = new Logger();
-    imageHelper = new SDLImageHelper();
-    theme = new Theme;
-    Widget::setGlobalFont(new Font("/usr/share/fonts/truetype/"
-        "ttf-dejavu/DejaVuSans-Oblique.ttf", 18));
+    initBrowserBoxTest();
     BrowserBox *box = new BrowserBox(nullptr, BrowserBox::AUTO_WRAP, true, "");
     box->setWidth(100);
     std::string row = "test";
@@ -145,3 +168,60 @@ TEST(browserbox, test1)
     delete client;
     client = nullptr;
 }
+
+TEST(browserbox, layoutCache)
+{
+    initBrowserBoxTest();
+    BrowserBox *box = new BrowserBox(nullptr, BrowserBox::AUTO_WRAP, true, "");
+    box->setWidth(100);
+    addTestRows(box, 20);
+    const int height = box->getHeight();
+    EXPECT_LT(21 * box->getFont()->getHeight(), height);
+
+    // all rows wrapped again after width change
+    box->setWidth(400);
+    box->updateHeight();
+    EXPECT_GT(height, box->getHeight());
+    box->setWidth(100);
+    box->updateHeight();
+    EXPECT_EQ(height, box->getHeight());
+
+    // same layout if rows added at once
+    BrowserBox *box2 = new BrowserBox(nullptr, BrowserBox::AUTO_WRAP,
+        true, "");
+    box2->setWidth(400);
+    addTestRows(box2, 20);
+    box2->setWidth(100);
+    box2->updateHeight();
+    EXPECT_EQ(height, box2->getHeight());
+
+    box->clearRows();
+    EXPECT_FALSE(box->hasRows());
+
+    delete box;
+    delete box2;
+    delete client;
+    client = nullptr;
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(browserbox, DISABLED_addRowsBenchmark)
+{
+    initBrowserBoxTest();
+    BrowserBox *box = new BrowserBox(nullptr, BrowserBox::AUTO_WRAP, true, "");
+    box->setWidth(300);
+    clock_t start = clock();
+    addTestRows(box, 10000);
+    logger->log("BrowserBox add 10000 rows: %f ms",
+        static_cast<double>(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+
+    start = clock();
+    box->setWidth(200);
+    box->updateHeight();
+    logger->log("BrowserBox wrap 12000 rows: %f ms",
+        static_cast<double>(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+
+    delete box;
+    delete client;
+    client = nullptr;
+}
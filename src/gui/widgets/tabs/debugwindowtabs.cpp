@@ -27,6 +27,8 @@
 #include "being/localplayer.h"
 
 #include "particle/particle.h"
+#include "particle/particleeffect.h"
+#include "particle/particlepool.h"
 
 #include "gui/viewport.h"
 
@@ -38,6 +40,8 @@
 #include "resources/imagehelper.h"
 #endif
 
+#include "resources/resourcemanager.h"
+
 #include "resources/map/map.h"
 
 #include "net/packetcounters.h"
@@ -62,9 +66,20 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
     mParticleCountLabel(new Label(this, strprintf("%s %d",
         // TRANSLATORS: debug window label
         _("Particle count:"), 88888))),
+    mParticleCacheLabel(new Label(this, strprintf(
+        // TRANSLATORS: debug window label
+        _("Particle effects: %d cached, %d hits, %d misses"),
+        8888, 88888, 88888))),
+    mParticlePoolLabel(new Label(this, strprintf(
+        // TRANSLATORS: debug window label
+        _("Particle pool: %d used, %d free"), 88888, 88888))),
     mMapActorCountLabel(new Label(this, strprintf("%s %d",
         // TRANSLATORS: debug window label
         _("Map actors count:"), 88888))),
+    mResourcesMemoryLabel(new Label(this, strprintf(
+        // TRANSLATORS: debug window label
+        _("Resources: %d KiB (%d KiB unused), textures: %d KiB "
+        "(%d KiB unused)"), 8888888, 8888888, 8888888, 8888888))),
     // TRANSLATORS: debug window label
     mXYLabel(new Label(this, strprintf("%s (?,?)", _("Player Position:")))),
     mTexturesLabel(nullptr),
@@ -132,11 +147,14 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
     place(0, 5, mXYLabel, 2);
     place(0, 6, mTileMouseLabel, 2);
     place(0, 7, mParticleCountLabel, 2);
-    place(0, 8, mMapActorCountLabel, 2);
+    place(0, 8, mParticleCacheLabel, 2);
+    place(0, 9, mParticlePoolLabel, 2);
+    place(0, 10, mMapActorCountLabel, 2);
+    place(0, 11, mResourcesMemoryLabel, 2);
 #ifdef USE_OPENGL
 #if defined (DEBUG_OPENGL_LEAKS) || defined(DEBUG_DRAW_CALLS) \
     || defined(DEBUG_BIND_TEXTURE)
-    int n = 9;
+    int n = 12;
 #endif
 #ifdef DEBUG_OPENGL_LEAKS
     mTexturesLabel = new Label(this, strprintf("%s %s",
@@ -202,11 +220,36 @@ void MapDebugTab::logic()
             // TRANSLATORS: debug window label
             mParticleCountLabel->setCaption(strprintf(_("Particle count: %d"),
                 Particle::particleCount));
+            mParticleCacheLabel->setCaption(strprintf(
+                // TRANSLATORS: debug window label
+                _("Particle effects: %d cached, %d hits, %d misses"),
+                ParticleEffect::getCacheSize(),
+                ParticleEffect::cacheHits,
+                ParticleEffect::cacheMisses));
+            mParticlePoolLabel->setCaption(strprintf(
+                // TRANSLATORS: debug window label
+                _("Particle pool: %d used, %d free"),
+                ParticlePool::getUsedCount(),
+                ParticlePool::getFreeCount()));
 
             mMapActorCountLabel->setCaption(
                 // TRANSLATORS: debug window label
                 strprintf("%s %d", _("Map actors count:"),
                 map->getActorsCount()));
+
+            const ResourceManager *const resman
+                = ResourceManager::getInstance();
+            size_t memory = 0;
+            size_t videoMemory = 0;
+            resman->calcMemoryUsage(memory, videoMemory);
+            mResourcesMemoryLabel->setCaption(strprintf(
+                // TRANSLATORS: debug window label
+                _("Resources: %d KiB (%d KiB unused), textures: %d KiB "
+                "(%d KiB unused)"),
+                static_cast<int>(memory / 1024),
+                static_cast<int>(resman->getOrphanedMemory() / 1024),
+                static_cast<int>(videoMemory / 1024),
+                static_cast<int>(resman->getOrphanedVideoMemory() / 1024)));
 #ifdef USE_OPENGL
 #ifdef DEBUG_OPENGL_LEAKS
             mTexturesLabel->setCaption(strprintf("%s %d",
@@ -250,6 +293,8 @@ void MapDebugTab::logic()
 
     mMapActorCountLabel->adjustSize();
     mParticleCountLabel->adjustSize();
+    mParticleCacheLabel->adjustSize();
+    mParticlePoolLabel->adjustSize();
 
     mFPSLabel->setCaption(strprintf(mFPSText.c_str(), fps));
     // TRANSLATORS: debug window label, logic per second
@@ -64,7 +64,10 @@ class MapDebugTab final : public DebugTab
         Label *mMinimapLabel;
         Label *mTileMouseLabel;
         Label *mParticleCountLabel;
+        Label *mParticleCacheLabel;
+        Label *mParticlePoolLabel;
         Label *mMapActorCountLabel;
+        Label *mResourcesMemoryLabel;
         Label *mXYLabel;
         Label *mTexturesLabel;
         int mUpdateTime;
@@ -80,6 +80,10 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
         "enableMapReduce", this, "enableMapReduceEvent");
 #endif
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Use fast pathfinding (jump point search)"), "",
+        "useJumpPointSearch", this, "useJumpPointSearchEvent");
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Enable compound sprite delay (Software)"), "",
         "enableCompoundSpriteDelay", this, "enableCompoundSpriteDelayEvent");
@@ -88,6 +92,31 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
     new SetupItemCheckBox(_("Enable delayed images load (OpenGL)"), "",
         "enableDelayedAnimations", this, "enableDelayedAnimationsEvent");
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache dyed images on disk"), "",
+        "enableDyeCache", this, "enableDyeCacheEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Compress dyed images cache"), "",
+        "dyeCacheCompression", this, "dyeCacheCompressionEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Dyed images cache size (MiB)"), "",
+        "dyeCacheSize", this, "dyeCacheSizeEvent", 1, 4096);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache compiled maps on disk"), "",
+        "enableMapCache", this, "enableMapCacheEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Decode map layers in parallel"), "",
+        "parallelMapLoading", this, "parallelMapLoadingEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Read uncompressed files from archives "
+        "without copy"), "", "useMappedArchives", this,
+        "useMappedArchivesEvent");
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Enable texture sampler (OpenGL)"), "",
         "useTextureSampler", this, "useTextureSamplerEvent");
@@ -146,6 +175,14 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
     new SetupItemCheckBox(_("Enable texture atlases (OpenGL)"), "",
         "useAtlases", this, "useAtlasesEvent");
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache texture atlases on disk (OpenGL)"), "",
+        "enableAtlasCache", this, "enableAtlasCacheEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Draw text from glyph atlases (OpenGL)"), "",
+        "enableGlyphAtlas", this, "enableGlyphAtlasEvent");
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Cache all sprites per map (can use "
         "additional memory)"), "", "uselonglivesprites", this,
@@ -156,6 +193,16 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
         "", "uselonglivesounds", this,
         "uselonglivesoundsEvent");
 
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Max memory for unused resources "
+        "(MiB, 0 - unlimited)"), "", "orphanedResourcesMemory", this,
+        "orphanedResourcesMemoryEvent", 0, 4096);
+
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Max texture memory for unused resources "
+        "(MiB, 0 - unlimited)"), "", "orphanedResourcesVideoMemory", this,
+        "orphanedResourcesVideoMemoryEvent", 0, 4096);
+
     // TRANSLATORS: settings group
     new SetupItemLabel(_("Critical options (DO NOT change if you don't "
         "know what you're doing)"), "", this);
@@ -0,0 +1,51 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LISTENERS_PATHLISTENER_H
+#define LISTENERS_PATHLISTENER_H
+
+#include "position.h"
+
+#include "localconsts.h"
+
+/**
+ * The listener interface for receiving paths requested with
+ * Map::findPathAsync.
+ */
+class PathListener notfinal
+{
+    public:
+        /**
+         * Destructor.
+         */
+        virtual ~PathListener()
+        { }
+
+        /**
+         * Called from game loop when requested path search is finished.
+         * Empty path means destination is not reachable.
+         * Start and destination are tiles from request.
+         */
+        virtual void pathFound(const Path &path,
+                               const int startX, const int startY,
+                               const int destX, const int destY) = 0;
+};
+
+#endif  // LISTENERS_PATHLISTENER_H
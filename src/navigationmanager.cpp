@@ -26,8 +26,8 @@
 
 #include "debug.h"
 
-static const int blockWalkMask = (BlockMask::WALL | BlockMask::AIR
-    | BlockMask::WATER);
+const unsigned char NavigationManager::blockWalkMask = static_cast<
+    unsigned char>(BlockMask::WALL | BlockMask::AIR | BlockMask::WATER);
 
 namespace
 {
@@ -161,5 +161,27 @@ void NavigationManager::fillNum(int x, int y,
                     data[ptr] = -num;
             }
         }
+        // Map::findPath can do diagonal step if corners is not walls
+        for (int dy = -1; dy <= 1; dy += 2)
+        {
+            const int y2 = y + dy;
+            if (y2 < 0 || y2 >= height)
+                continue;
+            for (int dx = -1; dx <= 1; dx += 2)
+            {
+                const int x2 = x + dx;
+                if (x2 < 0 || x2 >= width)
+                    continue;
+                ptr = x2 + width * y2;
+                if (data[ptr] > 0
+                    || (tiles[ptr].blockmask & blockWalkMask)
+                    || ((tiles[x2 + width * y].blockmask
+                    | tiles[x + width * y2].blockmask) & BlockMask::WALL))
+                {
+                    continue;
+                }
+                cells.push_back(Cell(x2, y2));
+            }
+        }
     }
 }
@@ -41,6 +41,9 @@ class NavigationManager final
         static Resource *loadWalkLayer(const Map *const map);
 #endif
 
+        // walk layer regions built for this mask
+        static const unsigned char blockWalkMask;
+
     private:
         static bool findWalkableTile(int &x1, int &y1,
                                      const int width, const int height,
@@ -55,6 +55,7 @@ Network::Network() :
     mServer(),
     mInBuffer(new char[BUFFER_SIZE]),
     mOutBuffer(new char[BUFFER_SIZE]),
+    mInPos(0),
     mInSize(0),
     mOutSize(0),
     mToSkip(0),
@@ -109,6 +110,7 @@ bool Network::connect(const ServerInfo &server)
 
     // Reset to sane values
     mOutSize = 0;
+    mInPos = 0;
     mInSize = 0;
     mToSkip = 0;
 
@@ -178,15 +180,24 @@ void Network::skip(const int len)
         return;
     }
 
-    if (mInSize >= mToSkip)
+    if (mInSize > mToSkip)
     {
+        mInPos += mToSkip;
         mInSize -= mToSkip;
-        memmove(mInBuffer, mInBuffer + static_cast<size_t>(mToSkip), mInSize);
         mToSkip = 0;
+        // move data to buffer start only after half of buffer consumed,
+        // so each byte copied at most once in average.
+        if (mInPos >= BUFFER_SIZE / 2)
+        {
+            memmove(mInBuffer, mInBuffer + static_cast<size_t>(mInPos),
+                mInSize);
+            mInPos = 0;
+        }
     }
     else
     {
         mToSkip -= mInSize;
+        mInPos = 0;
         mInSize = 0;
     }
     SDL_mutexV(mMutexIn);
@@ -265,7 +276,8 @@ void Network::receive()
             {
                 // Receive data from the socket
                 SDL_mutexP(mMutexIn);
-                if (mInSize > BUFFER_LIMIT)
+                const unsigned int inEnd = mInPos + mInSize;
+                if (inEnd > BUFFER_LIMIT)
                 {
                     SDL_mutexV(mMutexIn);
                     SDL_Delay(100);
@@ -273,8 +285,8 @@ void Network::receive()
                 }
 
                 const int ret = TcpNet::recv(mSocket,
-                    mInBuffer + static_cast<size_t>(mInSize),
-                    BUFFER_SIZE - mInSize);
+                    mInBuffer + static_cast<size_t>(inEnd),
+                    BUFFER_SIZE - inEnd);
 
                 if (!ret)
                 {
@@ -294,17 +306,18 @@ void Network::receive()
                     mInSize += ret;
                     if (mToSkip)
                     {
-                        if (mInSize >= mToSkip)
+                        // nothing was dispatched from buffer,
+                        // so cursor can be moved here.
+                        if (mInSize > mToSkip)
                         {
+                            mInPos += mToSkip;
                             mInSize -= mToSkip;
-                            memmove(mInBuffer,
-                                mInBuffer + static_cast<size_t>(mToSkip),
-                                mInSize);
                             mToSkip = 0;
                         }
                         else
                         {
                             mToSkip -= mInSize;
+                            mInPos = 0;
                             mInSize = 0;
                         }
                     }
@@ -341,10 +354,10 @@ uint16_t Network::readWord(const int pos) const
 {
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
     return SDL_Swap16(*reinterpret_cast<uint16_t*>(
-        mInBuffer + static_cast<size_t>(pos)));
+        mInBuffer + static_cast<size_t>(mInPos + pos)));
 #else
     return (*reinterpret_cast<uint16_t*>(
-        mInBuffer + static_cast<size_t>(pos)));
+        mInBuffer + static_cast<size_t>(mInPos + pos)));
 #endif
 }
 
@@ -93,6 +93,8 @@ class Network notfinal
 
         char *mInBuffer;
         char *mOutBuffer;
+        // offset of first not dispatched byte in mInBuffer
+        unsigned int mInPos;
         unsigned int mInSize;
         unsigned int mOutSize;
 
@@ -110,7 +110,7 @@ void Network::dispatchMessages()
         if (len == -1)
             len = readWord(2);
 
-        MessageIn msg(mInBuffer, len);
+        MessageIn msg(mInBuffer + static_cast<size_t>(mInPos), len);
         msg.postInit();
         SDL_mutexV(mMutexIn);
         BLOCK_END("Network::dispatchMessages 2")
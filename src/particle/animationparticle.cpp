@@ -22,37 +22,29 @@
 
 #include "particle/animationparticle.h"
 
-#include "simpleanimation.h"
-
-#include "utils/delete2.h"
-
 #include "debug.h"
 
-AnimationParticle::AnimationParticle(Animation *const animation) :
+AnimationParticle::AnimationParticle(const Animation &animation) :
     ImageParticle(nullptr),
-    mAnimation(new SimpleAnimation(animation))
+    mAnimation(animation)
 {
 }
 
 AnimationParticle::AnimationParticle(XmlNodePtrConst animationNode,
                                      const std::string& dyePalettes) :
     ImageParticle(nullptr),
-    mAnimation(new SimpleAnimation(animationNode, dyePalettes))
+    mAnimation(animationNode, dyePalettes)
 {
 }
 
 AnimationParticle::~AnimationParticle()
 {
-    delete2(mAnimation);
     mImage = nullptr;
 }
 
 bool AnimationParticle::update()
 {
-    if (mAnimation)
-    {
-        mAnimation->update(10);  // particle engine is updated every 10ms
-        mImage = mAnimation->getCurrentImage();
-    }
+    mAnimation.update(10);  // particle engine is updated every 10ms
+    mImage = mAnimation.getCurrentImage();
     return Particle::update();
 }
@@ -23,17 +23,22 @@
 #ifndef PARTICLE_ANIMATIONPARTICLE_H
 #define PARTICLE_ANIMATIONPARTICLE_H
 
+#include "simpleanimation.h"
+
 #include "particle/imageparticle.h"
 
 #include "utils/xml.h"
 
 class Animation;
-class SimpleAnimation;
 
 class AnimationParticle final : public ImageParticle
 {
     public:
-        explicit AnimationParticle(Animation *const animation);
+        /**
+         * Plays animation owned by emitter or cached effect,
+         * which must outlive the particle.
+         */
+        explicit AnimationParticle(const Animation &animation);
 
         explicit AnimationParticle(XmlNodePtrConst animationNode,
                                    const std::string& dyePalettes
@@ -46,7 +51,7 @@ class AnimationParticle final : public ImageParticle
         bool update() override final;
 
     private:
-        SimpleAnimation *mAnimation; /**< Used animation for this particle */
+        SimpleAnimation mAnimation; /**< Used animation for this particle */
 };
 
 #endif  // PARTICLE_ANIMATIONPARTICLE_H
@@ -23,25 +23,24 @@
 #include "particle/particle.h"
 
 #include "configuration.h"
-#include "resources/dye.h"
 #include "logger.h"
+#include "simpleanimation.h"
 
 #include "particle/animationparticle.h"
+#include "particle/particleeffect.h"
 #include "particle/particleemitter.h"
+#include "particle/particlephysics.h"
 #include "particle/rotationalparticle.h"
 #include "particle/textparticle.h"
 
-#include "resources/resourcemanager.h"
+#include "resources/animation.h"
 
 #include "utils/dtor.h"
-#include "utils/mathutils.h"
 
 #include "debug.h"
 
 Particle *particleEngine = nullptr;
 
-static const float SIN45 = 0.707106781F;
-
 class Graphics;
 class Image;
 
@@ -52,6 +51,12 @@ int Particle::emitterSkip = 1;
 bool Particle::enabled = true;
 const float Particle::PARTICLE_SKY = 800.0F;
 
+namespace
+{
+    // reused by all particles for avoid allocations each tick
+    ParticlePhysicsBatch mPhysicsBatch;
+}  // namespace
+
 Particle::Particle() :
     Actor(),
     mAlpha(1.0F),
@@ -95,6 +100,7 @@ void Particle::setupEngine()
         Particle::emitterSkip = 1;
     Particle::enabled = config.getBoolValue("particleeffects");
     disableAutoDelete();
+    ParticlePhysics::init();
     logger->log1("Particle engine set up");
 }
 
@@ -107,113 +113,6 @@ bool Particle::update()
     if (!mMap)
         return false;
 
-    if (mLifetimeLeft == 0 && mAlive == ALIVE)
-        mAlive = DEAD_TIMEOUT;
-
-    const Vector oldPos = mPos;
-
-    if (mAlive == ALIVE)
-    {
-        // calculate particle movement
-        if (mMomentum != 1.0F)
-            mVelocity *= mMomentum;
-
-        if (mTarget && mAcceleration != 0.0F)
-        {
-            Vector dist = mPos - mTarget->mPos;
-            dist.x *= SIN45;
-            float invHypotenuse;
-
-            switch (Particle::fastPhysics)
-            {
-                case 1:
-                    invHypotenuse = fastInvSqrt(
-                        dist.x * dist.x + dist.y * dist.y + dist.z * dist.z);
-                    break;
-                case 2:
-                    if (!dist.x)
-                    {
-                        invHypotenuse = 0;
-                        break;
-                    }
-
-                    invHypotenuse = 2.0F / (static_cast<float>(fabs(dist.x))
-                                    + static_cast<float>(fabs(dist.y))
-                                    + static_cast<float>(fabs(dist.z)));
-                    break;
-                default:
-                    invHypotenuse = 1.0F / static_cast<float>(sqrt(
-                        dist.x * dist.x + dist.y * dist.y + dist.z * dist.z));
-                    break;
-            }
-
-            if (invHypotenuse)
-            {
-                if (mInvDieDistance > 0.0F && invHypotenuse > mInvDieDistance)
-                    mAlive = DEAD_IMPACT;
-                const float accFactor = invHypotenuse * mAcceleration;
-                mVelocity -= dist * accFactor;
-            }
-        }
-
-        if (mRandomness > 0)
-        {
-            mVelocity.x += static_cast<float>((rand() % mRandomness - rand()
-                           % mRandomness)) / 1000.0F;
-            mVelocity.y += static_cast<float>((rand() % mRandomness - rand()
-                           % mRandomness)) / 1000.0F;
-            mVelocity.z += static_cast<float>((rand() % mRandomness - rand()
-                           % mRandomness)) / 1000.0F;
-        }
-
-        mVelocity.z -= mGravity;
-
-        // Update position
-        mPos.x += mVelocity.x;
-        mPos.y += mVelocity.y * SIN45;
-        mPos.z += mVelocity.z * SIN45;
-
-        // Update other stuff
-        if (mLifetimeLeft > 0)
-            mLifetimeLeft--;
-
-        mLifetimePast++;
-
-        if (mPos.z < 0.0F)
-        {
-            if (mBounce > 0.0F)
-            {
-                mPos.z *= -mBounce;
-                mVelocity *= mBounce;
-                mVelocity.z = -mVelocity.z;
-            }
-            else
-            {
-                mAlive = DEAD_FLOOR;
-            }
-        }
-        else if (mPos.z > PARTICLE_SKY)
-        {
-            mAlive = DEAD_SKY;
-        }
-
-        // Update child emitters
-        if (Particle::emitterSkip && (mLifetimePast - 1)
-            % Particle::emitterSkip == 0)
-        {
-            FOR_EACH (EmitterConstIterator, e, mChildEmitters)
-            {
-                Particles newParticles = (*e)->createParticles(mLifetimePast);
-                FOR_EACH (ParticleConstIterator, it, newParticles)
-                {
-                    Particle *const p = *it;
-                    p->moveBy(mPos);
-                    mChildParticles.push_back(p);
-                }
-            }
-        }
-    }
-
     // create death effect when the particle died
     if (mAlive != ALIVE && mAlive != DEAD_LONG_AGO)
     {
@@ -228,33 +127,142 @@ bool Particle::update()
         mAlive = DEAD_LONG_AGO;
     }
 
-    const Vector change = mPos - oldPos;
+    updateChildrenPhysics();
 
-    // Update child particles
+    // Update child particles and compact alive ones to array start.
+    // Size is checked each step because death effects can add particles.
+    size_t alive = 0;
+    for (size_t f = 0; f < mChildParticles.size(); f ++)
+    {
+        Particle *const particle = mChildParticles[f];
+        if (particle->update())
+            mChildParticles[alive ++] = particle;
+        else
+            delete particle;
+    }
+    mChildParticles.resize(alive);
+    if (mAlive != ALIVE && mChildParticles.empty() && mAutoDelete)
+        return false;
+
+    return true;
+}
 
-    for (ParticleIterator p = mChildParticles.begin(),
-         p2 = mChildParticles.end(); p != p2; )
+void Particle::updateChildrenPhysics()
+{
+    // batch is free again when children update own children
+    ParticlePhysicsBatch &batch = mPhysicsBatch;
+    batch.resize(mChildParticles.size());
+    size_t sz = 0;
+    FOR_EACH (ParticleConstIterator, it, mChildParticles)
     {
-        Particle *const particle = *p;
-        // move particle with its parent if desired
-        if (particle->mFollow)
-            particle->moveBy(change);
+        Particle *const particle = *it;
+        if (!particle->mMap)
+            continue;
+        if (particle->mLifetimeLeft == 0 && particle->mAlive == ALIVE)
+            particle->mAlive = DEAD_TIMEOUT;
+        if (particle->mAlive != ALIVE)
+            continue;
 
-        // update particle
-        if (particle->update())
+        batch.posX[sz] = particle->mPos.x;
+        batch.posY[sz] = particle->mPos.y;
+        batch.posZ[sz] = particle->mPos.z;
+        batch.velX[sz] = particle->mVelocity.x;
+        batch.velY[sz] = particle->mVelocity.y;
+        batch.velZ[sz] = particle->mVelocity.z;
+        const Particle *const target = particle->mTarget;
+        if (target)
         {
-            ++p;
+            batch.targetX[sz] = target->mPos.x;
+            batch.targetY[sz] = target->mPos.y;
+            batch.targetZ[sz] = target->mPos.z;
+            batch.acceleration[sz] = particle->mAcceleration;
         }
         else
         {
-            delete particle;
-            p = mChildParticles.erase(p);
+            batch.targetX[sz] = 0.0F;
+            batch.targetY[sz] = 0.0F;
+            batch.targetZ[sz] = 0.0F;
+            batch.acceleration[sz] = 0.0F;
         }
+        batch.invDieDistance[sz] = particle->mInvDieDistance;
+        batch.momentum[sz] = particle->mMomentum;
+        batch.gravity[sz] = particle->mGravity;
+        batch.bounce[sz] = particle->mBounce;
+        const int randomness = particle->mRandomness;
+        if (randomness > 0)
+        {
+            batch.randomX[sz] = static_cast<float>((rand() % randomness
+                - rand() % randomness)) / 1000.0F;
+            batch.randomY[sz] = static_cast<float>((rand() % randomness
+                - rand() % randomness)) / 1000.0F;
+            batch.randomZ[sz] = static_cast<float>((rand() % randomness
+                - rand() % randomness)) / 1000.0F;
+        }
+        else
+        {
+            batch.randomX[sz] = 0.0F;
+            batch.randomY[sz] = 0.0F;
+            batch.randomZ[sz] = 0.0F;
+        }
+        sz ++;
     }
-    if (mAlive != ALIVE && mChildParticles.empty() && mAutoDelete)
-        return false;
+    if (!sz)
+        return;
+    batch.size = sz;
 
-    return true;
+    ParticlePhysics::update(batch, Particle::fastPhysics);
+
+    // same particles order as in gather loop above
+    size_t f = 0;
+    FOR_EACH (ParticleConstIterator, it, mChildParticles)
+    {
+        Particle *const particle = *it;
+        if (!particle->mMap || particle->mAlive != ALIVE)
+            continue;
+
+        const Vector pos(batch.posX[f], batch.posY[f], batch.posZ[f]);
+        const Vector change = pos - particle->mPos;
+        particle->mPos = pos;
+        particle->mVelocity.x = batch.velX[f];
+        particle->mVelocity.y = batch.velY[f];
+        particle->mVelocity.z = batch.velZ[f];
+        // move children with particle if desired
+        FOR_EACH (ParticleConstIterator, it2, particle->mChildParticles)
+        {
+            Particle *const child = *it2;
+            if (child->mFollow)
+                child->moveBy(change);
+        }
+
+        // Update other stuff
+        if (particle->mLifetimeLeft > 0)
+            particle->mLifetimeLeft--;
+        particle->mLifetimePast++;
+        particle->updateEmitters();
+
+        const int32_t status = batch.status[f];
+        if (status != ALIVE)
+            particle->mAlive = static_cast<AliveStatus>(status);
+        f ++;
+    }
+}
+
+void Particle::updateEmitters()
+{
+    if (!Particle::emitterSkip || (mLifetimePast - 1)
+        % Particle::emitterSkip != 0)
+    {
+        return;
+    }
+
+    FOR_EACH (EmitterConstIterator, e, mChildEmitters)
+    {
+        const size_t oldSize = mChildParticles.size();
+        (*e)->createParticles(mLifetimePast, mChildParticles);
+        const size_t newSize = mChildParticles.size();
+        for (size_t f = oldSize; f < newSize; f ++)
+            mChildParticles[f]->moveBy(mPos);
+    }
 }
 
 void Particle::moveBy(const Vector &change)
@@ -285,134 +293,60 @@ Particle *Particle::addEffect(const std::string &particleEffectFile,
                               const int pixelX, const int pixelY,
                               const int rotation)
 {
-    Particle *newParticle = nullptr;
-
-    const size_t pos = particleEffectFile.find('|');
-    const std::string dyePalettes = (pos != std::string::npos)
-        ? particleEffectFile.substr(pos + 1) : "";
-    XML::Document doc(particleEffectFile.substr(0, pos), true, false);
-    const XmlNodePtrConst rootNode = doc.rootNode();
-
-    if (!rootNode || !xmlNameEqual(rootNode, "effect"))
-    {
-        logger->log("Error loading particle: %s", particleEffectFile.c_str());
+    const ParticleEffect *const effect = ParticleEffect::get(
+        particleEffectFile, rotation);
+    if (!effect)
         return nullptr;
-    }
-
-    ResourceManager *const resman = ResourceManager::getInstance();
 
-    // Parse particles
-    for_each_xml_child_node(effectChildNode, rootNode)
+    Particle *newParticle = nullptr;
+    const ParticleTemplates &particles = effect->getParticles();
+    FOR_EACH (ParticleTemplatesCIter, it, particles)
     {
-        // We're only interested in particles
-        if (!xmlNameEqual(effectChildNode, "particle"))
-            continue;
+        const ParticleTemplate *const tmpl = *it;
+        const Animation *const animation = tmpl->animation
+            ? tmpl->animation->getAnimation() : nullptr;
 
         // Determine the exact particle type
-        XmlNodePtr node;
-
-        // Animation
-        if ((node = XML::findFirstChildByName(effectChildNode, "animation")))
+        if (tmpl->type == ParticleTemplate::ANIMATION && animation)
         {
-            newParticle = new AnimationParticle(node, dyePalettes);
-            newParticle->setMap(mMap);
+            newParticle = new AnimationParticle(*animation);
         }
-        // Rotational
-        else if ((node = XML::findFirstChildByName(
-                 effectChildNode, "rotation")))
+        else if (tmpl->type == ParticleTemplate::ROTATION && animation)
         {
-            newParticle = new RotationalParticle(node, dyePalettes);
-            newParticle->setMap(mMap);
+            newParticle = new RotationalParticle(*animation);
         }
-        // Image
-        else if ((node = XML::findFirstChildByName(effectChildNode, "image")))
+        else if (tmpl->type == ParticleTemplate::IMAGE)
         {
-            std::string imageSrc;
-            if (node->xmlChildrenNode)
-            {
-                imageSrc = reinterpret_cast<const char*>(
-                    node->xmlChildrenNode->content);
-            }
-            if (!imageSrc.empty() && !dyePalettes.empty())
-                Dye::instantiate(imageSrc, dyePalettes);
-            Image *const img = resman->getImage(imageSrc);
-
-            newParticle = new ImageParticle(img);
-            newParticle->setMap(mMap);
+            newParticle = new ImageParticle(tmpl->image);
         }
-        // Other
         else
         {
             newParticle = new Particle();
-            newParticle->setMap(mMap);
         }
+        newParticle->setMap(mMap);
 
-        // Read and set the basic properties of the particle
-        const float offsetX = static_cast<float>(XML::getFloatProperty(
-            effectChildNode, "position-x", 0));
-        const float offsetY = static_cast<float>(XML::getFloatProperty(
-            effectChildNode, "position-y", 0));
-        const float offsetZ = static_cast<float>(XML::getFloatProperty(
-            effectChildNode, "position-z", 0));
-        const Vector position(mPos.x + static_cast<float>(pixelX) + offsetX,
-            mPos.y + static_cast<float>(pixelY) + offsetY,
-            mPos.z + offsetZ);
+        // Set the basic properties of the particle
+        const Vector position(mPos.x + static_cast<float>(pixelX)
+            + tmpl->offsetX,
+            mPos.y + static_cast<float>(pixelY) + tmpl->offsetY,
+            mPos.z + tmpl->offsetZ);
         newParticle->moveTo(position);
+        newParticle->setLifetime(tmpl->lifetime);
+        newParticle->setAllowSizeAdjust(tmpl->sizeAdjustable);
 
-        const int lifetime = XML::getProperty(effectChildNode, "lifetime", -1);
-        newParticle->setLifetime(lifetime);
-        const bool resizeable = "false" != XML::getProperty(effectChildNode,
-            "size-adjustable", "false");
-
-        newParticle->setAllowSizeAdjust(resizeable);
-
-        // Look for additional emitters for this particle
-        for_each_xml_child_node(emitterNode, effectChildNode)
+        FOR_EACH (std::vector<ParticleEmitter*>::const_iterator, e,
+                  tmpl->emitters)
+        {
+            ParticleEmitter *const newEmitter = new ParticleEmitter(**e);
+            newEmitter->setTarget(newParticle);
+            newEmitter->setMap(mMap);
+            newEmitter->resetOutputPause();
+            newParticle->addEmitter(newEmitter);
+        }
+        if (!tmpl->deathEffect.empty())
         {
-            if (xmlNameEqual(emitterNode, "emitter"))
-            {
-                ParticleEmitter *const newEmitter = new ParticleEmitter(
-                    emitterNode, newParticle, mMap, rotation, dyePalettes);
-                newParticle->addEmitter(newEmitter);
-            }
-            else if (xmlNameEqual(emitterNode, "deatheffect"))
-            {
-                std::string deathEffect;
-                if (node->xmlChildrenNode)
-                {
-                    deathEffect = reinterpret_cast<const char*>(
-                        emitterNode->xmlChildrenNode->content);
-                }
-
-                char deathEffectConditions = 0x00;
-                if (XML::getBoolProperty(emitterNode, "on-floor", true))
-                {
-                    deathEffectConditions += static_cast<signed char>(
-                        Particle::DEAD_FLOOR);
-                }
-                if (XML::getBoolProperty(emitterNode, "on-sky", true))
-                {
-                    deathEffectConditions += static_cast<signed char>(
-                        Particle::DEAD_SKY);
-                }
-                if (XML::getBoolProperty(emitterNode, "on-other", false))
-                {
-                    deathEffectConditions += static_cast<signed char>(
-                        Particle::DEAD_OTHER);
-                }
-                if (XML::getBoolProperty(emitterNode, "on-impact", true))
-                {
-                    deathEffectConditions += static_cast<signed char>(
-                        Particle::DEAD_IMPACT);
-                }
-                if (XML::getBoolProperty(emitterNode, "on-timeout", true))
-                {
-                    deathEffectConditions += static_cast<signed char>(
-                        Particle::DEAD_TIMEOUT);
-                }
-                newParticle->setDeathEffect(
-                    deathEffect, deathEffectConditions);
-            }
+            newParticle->setDeathEffect(tmpl->deathEffect,
+                tmpl->deathEffectConditions);
         }
 
         mChildParticles.push_back(newParticle);
@@ -25,6 +25,10 @@
 
 #include "being/actor.h"
 
+#include "particle/particlepool.h"
+
+#include <vector>
+
 #include "localconsts.h"
 
 class Color;
@@ -32,10 +36,10 @@ class Font;
 class Particle;
 class ParticleEmitter;
 
-typedef std::list<Particle *> Particles;
+typedef std::vector<Particle *> Particles;
 typedef Particles::iterator ParticleIterator;
 typedef Particles::const_iterator ParticleConstIterator;
-typedef std::list<ParticleEmitter *> Emitters;
+typedef std::vector<ParticleEmitter *> Emitters;
 typedef Emitters::iterator EmitterIterator;
 typedef Emitters::const_iterator EmitterConstIterator;
 
@@ -73,6 +77,17 @@ class Particle notfinal : public Actor
          */
         virtual ~Particle();
 
+#ifndef ENABLE_MEM_DEBUG
+        /**
+         * Particles of all types allocated from ParticlePool.
+         */
+        static void *operator new(const size_t size)
+        { return ParticlePool::allocate(size); }
+
+        static void operator delete(void *const ptr, const size_t size)
+        { ParticlePool::release(ptr, size); }
+#endif
+
         /**
          * Deletes all child particles and emitters.
          */
@@ -303,6 +318,14 @@ class Particle notfinal : public Actor
         // Is the particle supposed to be drawn and updated?
         AliveStatus mAlive;
     private:
+        /**
+         * Moves alive child particles one tick with ParticlePhysics and
+         * runs their emitters.
+         */
+        void updateChildrenPhysics();
+
+        void updateEmitters();
+
         // List of child emitters.
         Emitters mChildEmitters;
 
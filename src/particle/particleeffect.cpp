@@ -0,0 +1,223 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "particle/particleeffect.h"
+
+#include "logger.h"
+#include "simpleanimation.h"
+
+#include "particle/particle.h"
+#include "particle/particleemitter.h"
+
+#include "resources/dye.h"
+#include "resources/image.h"
+#include "resources/resourcemanager.h"
+
+#include "utils/delete2.h"
+#include "utils/dtor.h"
+#include "utils/stringutils.h"
+
+#include <map>
+
+#include "debug.h"
+
+typedef std::map<std::string, ParticleEffect*> ParticleEffects;
+typedef ParticleEffects::iterator ParticleEffectsIter;
+
+namespace
+{
+    ParticleEffects mEffects;
+}  // namespace
+
+int ParticleEffect::cacheHits = 0;
+int ParticleEffect::cacheMisses = 0;
+
+ParticleEffect::ParticleEffect() :
+    mParticles()
+{
+}
+
+ParticleEffect::~ParticleEffect()
+{
+    FOR_EACH (ParticleTemplatesCIter, it, mParticles)
+    {
+        ParticleTemplate *const particle = *it;
+        delete_all(particle->emitters);
+        particle->emitters.clear();
+        delete2(particle->animation);
+        if (particle->image)
+        {
+            particle->image->decRef();
+            particle->image = nullptr;
+        }
+        delete particle;
+    }
+    mParticles.clear();
+}
+
+const ParticleEffect *ParticleEffect::get(const std::string &effectFile,
+                                          const int rotation)
+{
+    const std::string key = rotation ? strprintf("%s#%d",
+        effectFile.c_str(), rotation) : effectFile;
+    const ParticleEffectsIter it = mEffects.find(key);
+    if (it != mEffects.end())
+    {
+        cacheHits ++;
+        return (*it).second;
+    }
+
+    cacheMisses ++;
+    ParticleEffect *effect = new ParticleEffect;
+    if (!effect->load(effectFile, rotation))
+        delete2(effect);
+    // broken effects also cached, for avoid parsing them again
+    mEffects[key] = effect;
+    return effect;
+}
+
+void ParticleEffect::clearCache()
+{
+    FOR_EACH (ParticleEffectsIter, it, mEffects)
+        delete (*it).second;
+    mEffects.clear();
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+int ParticleEffect::getCacheSize()
+{
+    return static_cast<int>(mEffects.size());
+}
+
+bool ParticleEffect::load(const std::string &effectFile,
+                          const int rotation)
+{
+    const size_t pos = effectFile.find('|');
+    const std::string dyePalettes = (pos != std::string::npos)
+        ? effectFile.substr(pos + 1) : "";
+    XML::Document doc(effectFile.substr(0, pos), true, false);
+    const XmlNodePtrConst rootNode = doc.rootNode();
+
+    if (!rootNode || !xmlNameEqual(rootNode, "effect"))
+    {
+        logger->log("Error loading particle: %s", effectFile.c_str());
+        return false;
+    }
+
+    ResourceManager *const resman = ResourceManager::getInstance();
+
+    for_each_xml_child_node(effectChildNode, rootNode)
+    {
+        // We're only interested in particles
+        if (!xmlNameEqual(effectChildNode, "particle"))
+            continue;
+
+        ParticleTemplate *const particle = new ParticleTemplate;
+        mParticles.push_back(particle);
+
+        // Determine the exact particle type
+        XmlNodePtr node;
+
+        if ((node = XML::findFirstChildByName(effectChildNode, "animation")))
+        {
+            particle->type = ParticleTemplate::ANIMATION;
+            particle->animation = new SimpleAnimation(node, dyePalettes);
+        }
+        else if ((node = XML::findFirstChildByName(
+                 effectChildNode, "rotation")))
+        {
+            particle->type = ParticleTemplate::ROTATION;
+            particle->animation = new SimpleAnimation(node, dyePalettes);
+        }
+        else if ((node = XML::findFirstChildByName(effectChildNode, "image")))
+        {
+            std::string imageSrc;
+            if (node->xmlChildrenNode)
+            {
+                imageSrc = reinterpret_cast<const char*>(
+                    node->xmlChildrenNode->content);
+            }
+            if (!imageSrc.empty() && !dyePalettes.empty())
+                Dye::instantiate(imageSrc, dyePalettes);
+            particle->type = ParticleTemplate::IMAGE;
+            particle->image = resman->getImage(imageSrc);
+        }
+
+        particle->offsetX = static_cast<float>(XML::getFloatProperty(
+            effectChildNode, "position-x", 0));
+        particle->offsetY = static_cast<float>(XML::getFloatProperty(
+            effectChildNode, "position-y", 0));
+        particle->offsetZ = static_cast<float>(XML::getFloatProperty(
+            effectChildNode, "position-z", 0));
+        particle->lifetime = XML::getProperty(
+            effectChildNode, "lifetime", -1);
+        particle->sizeAdjustable = "false" != XML::getProperty(
+            effectChildNode, "size-adjustable", "false");
+
+        // Look for additional emitters for this particle
+        for_each_xml_child_node(emitterNode, effectChildNode)
+        {
+            if (xmlNameEqual(emitterNode, "emitter"))
+            {
+                // target and map will be set on instantiation
+                particle->emitters.push_back(new ParticleEmitter(
+                    emitterNode, nullptr, nullptr, rotation, dyePalettes));
+            }
+            else if (xmlNameEqual(emitterNode, "deatheffect"))
+            {
+                if (emitterNode->xmlChildrenNode)
+                {
+                    particle->deathEffect = reinterpret_cast<const char*>(
+                        emitterNode->xmlChildrenNode->content);
+                }
+
+                signed char deathEffectConditions = 0x00;
+                if (XML::getBoolProperty(emitterNode, "on-floor", true))
+                {
+                    deathEffectConditions += static_cast<signed char>(
+                        Particle::DEAD_FLOOR);
+                }
+                if (XML::getBoolProperty(emitterNode, "on-sky", true))
+                {
+                    deathEffectConditions += static_cast<signed char>(
+                        Particle::DEAD_SKY);
+                }
+                if (XML::getBoolProperty(emitterNode, "on-other", false))
+                {
+                    deathEffectConditions += static_cast<signed char>(
+                        Particle::DEAD_OTHER);
+                }
+                if (XML::getBoolProperty(emitterNode, "on-impact", true))
+                {
+                    deathEffectConditions += static_cast<signed char>(
+                        Particle::DEAD_IMPACT);
+                }
+                if (XML::getBoolProperty(emitterNode, "on-timeout", true))
+                {
+                    deathEffectConditions += static_cast<signed char>(
+                        Particle::DEAD_TIMEOUT);
+                }
+                particle->deathEffectConditions = deathEffectConditions;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARTICLE_PARTICLEEFFECT_H
+#define PARTICLE_PARTICLEEFFECT_H
+
+#include "particle/particletemplate.h"
+
+#include "localconsts.h"
+
+/**
+ * Particle effect file parsed once and kept in memory. New particles are
+ * instantiated from the stored templates without touching XML again.
+ */
+class ParticleEffect final
+{
+    public:
+        A_DELETE_COPY(ParticleEffect)
+
+        ~ParticleEffect();
+
+        /**
+         * Returns parsed effect for file name (with optional dye palettes
+         * after '|') and rotation. Parses and caches it on first use.
+         * Returns nullptr if effect can't be loaded.
+         */
+        static const ParticleEffect *get(const std::string &effectFile,
+                                         const int rotation) A_WARN_UNUSED;
+
+        /**
+         * Deletes all cached effects. Must not be called while particles
+         * created from cached effects are alive. Called on map change,
+         * after all particles are deleted.
+         */
+        static void clearCache();
+
+        static int getCacheSize() A_WARN_UNUSED;
+
+        static int cacheHits;
+        static int cacheMisses;
+
+        const ParticleTemplates &getParticles() const A_WARN_UNUSED
+        { return mParticles; }
+
+    private:
+        ParticleEffect();
+
+        bool load(const std::string &effectFile, const int rotation);
+
+        ParticleTemplates mParticles;
+};
+
+#endif  // PARTICLE_PARTICLEEFFECT_H
@@ -41,6 +41,7 @@ static const float DEG_RAD_FACTOR = 0.017453293F;
 
 typedef std::vector<ImageSet*>::const_iterator ImageSetVectorCIter;
 typedef std::list<ParticleEmitter>::const_iterator ParticleEmitterListCIter;
+typedef std::list<ParticleEmitter>::iterator ParticleEmitterListIter;
 
 ParticleEmitter::ParticleEmitter(const XmlNodePtrConst emitterNode,
                                  Particle *const target,
@@ -488,14 +489,13 @@ ParticleEmitter::readParticleEmitterProp(XmlNodePtrConst propertyNode, T def)
     return retval;
 }
 
-std::list<Particle *> ParticleEmitter::createParticles(const int tick)
+void ParticleEmitter::createParticles(const int tick,
+                                      std::vector<Particle *> &newParticles)
 {
-    std::list<Particle *> newParticles;
-
     if (mOutputPauseLeft > 0)
     {
         mOutputPauseLeft --;
-        return newParticles;
+        return;
     }
     mOutputPauseLeft = mOutputPause.value(tick);
 
@@ -523,14 +523,12 @@ std::list<Particle *> ParticleEmitter::createParticles(const int tick)
         }
         else if (!mParticleRotation.mFrames.empty())
         {
-            Animation *const newAnimation = new Animation(mParticleRotation);
-            newParticle = new RotationalParticle(newAnimation);
+            newParticle = new RotationalParticle(mParticleRotation);
             newParticle->setMap(mMap);
         }
         else if (!mParticleAnimation.mFrames.empty())
         {
-            Animation *const newAnimation = new Animation(mParticleAnimation);
-            newParticle = new AnimationParticle(newAnimation);
+            newParticle = new AnimationParticle(mParticleAnimation);
             newParticle->setMap(mMap);
         }
         else
@@ -579,8 +577,20 @@ std::list<Particle *> ParticleEmitter::createParticles(const int tick)
 
         newParticles.push_back(newParticle);
     }
+}
 
-    return newParticles;
+void ParticleEmitter::setTarget(Particle *const target)
+{
+    mParticleTarget = target;
+    FOR_EACH (ParticleEmitterListIter, it, mParticleChildEmitters)
+        (*it).setTarget(target);
+}
+
+void ParticleEmitter::setMap(Map *const map)
+{
+    mMap = map;
+    FOR_EACH (ParticleEmitterListIter, it, mParticleChildEmitters)
+        (*it).setMap(map);
 }
 
 void ParticleEmitter::adjustSize(const int w, const int h)
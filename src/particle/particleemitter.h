@@ -66,15 +66,28 @@ class ParticleEmitter final
 
         /**
          * Spawns new particles
-         * @return: a list of created particles
+         * and appends them to newParticles.
          */
-        std::list<Particle *> createParticles(const int tick);
+        void createParticles(const int tick,
+                             std::vector<Particle *> &newParticles);
 
         /**
          * Sets the target of the particles that are created
+         * by this emitter and its child emitters
          */
-        void setTarget(Particle *const target)
-        { mParticleTarget = target; }
+        void setTarget(Particle *const target);
+
+        /**
+         * Sets the map for this emitter and its child emitters
+         */
+        void setMap(Map *const map);
+
+        /**
+         * Restarts the initial output pause, for emitters copied
+         * from a cached particle effect.
+         */
+        void resetOutputPause()
+        { mOutputPauseLeft = mOutputPause.value(0); }
 
         /**
          * Changes the size of the emitter so that the effect fills a
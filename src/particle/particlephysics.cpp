@@ -0,0 +1,500 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "particle/particlephysics.h"
+
+#include "logger.h"
+
+#include "particle/particle.h"
+
+#include "utils/cpu.h"
+#include "utils/mathutils.h"
+
+#ifdef PARTICLE_SIMD
+#include <immintrin.h>
+#endif
+
+#include "debug.h"
+
+static const float SIN45 = 0.707106781F;
+
+namespace
+{
+    enum Implementation
+    {
+        SCALAR = 0,
+        SSE2,
+        AVX2
+    };
+
+    Implementation mImplementation = SCALAR;
+}  // namespace
+
+void ParticlePhysicsBatch::resize(const size_t sz)
+{
+    size = sz;
+    if (posX.size() >= sz)
+        return;
+    posX.resize(sz);
+    posY.resize(sz);
+    posZ.resize(sz);
+    velX.resize(sz);
+    velY.resize(sz);
+    velZ.resize(sz);
+    targetX.resize(sz);
+    targetY.resize(sz);
+    targetZ.resize(sz);
+    acceleration.resize(sz);
+    invDieDistance.resize(sz);
+    momentum.resize(sz);
+    gravity.resize(sz);
+    bounce.resize(sz);
+    randomX.resize(sz);
+    randomY.resize(sz);
+    randomZ.resize(sz);
+    status.resize(sz);
+}
+
+void ParticlePhysics::init()
+{
+    mImplementation = SCALAR;
+#ifdef PARTICLE_SIMD
+    const int flags = Cpu::getFlags();
+    if (flags & Cpu::FEATURE_AVX2)
+        mImplementation = AVX2;
+    else if (flags & Cpu::FEATURE_SSE2)
+        mImplementation = SSE2;
+#endif
+    logger->log("Particle physics: %s", getName());
+}
+
+const char *ParticlePhysics::getName()
+{
+    switch (mImplementation)
+    {
+        case AVX2:
+            return "avx2";
+        case SSE2:
+            return "sse2";
+        case SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+void ParticlePhysics::update(ParticlePhysicsBatch &batch,
+                             const int fastPhysics)
+{
+    switch (mImplementation)
+    {
+#ifdef PARTICLE_SIMD
+        case AVX2:
+            updateAvx2(batch, fastPhysics);
+            break;
+        case SSE2:
+            updateSse2(batch, fastPhysics);
+            break;
+#endif
+        case SCALAR:
+        default:
+            updateScalar(batch, 0, fastPhysics);
+            break;
+    }
+}
+
+void ParticlePhysics::updateScalar(ParticlePhysicsBatch &batch,
+                                   const size_t start,
+                                   const int fastPhysics)
+{
+    const size_t sz = batch.size;
+    for (size_t f = start; f < sz; f ++)
+    {
+        int32_t status = Particle::ALIVE;
+        float posX = batch.posX[f];
+        float posY = batch.posY[f];
+        float posZ = batch.posZ[f];
+        const float momentum = batch.momentum[f];
+        float velX = batch.velX[f] * momentum;
+        float velY = batch.velY[f] * momentum;
+        float velZ = batch.velZ[f] * momentum;
+
+        const float acceleration = batch.acceleration[f];
+        if (acceleration != 0.0F)
+        {
+            const float distX = (posX - batch.targetX[f]) * SIN45;
+            const float distY = posY - batch.targetY[f];
+            const float distZ = posZ - batch.targetZ[f];
+            float invHypotenuse;
+
+            switch (fastPhysics)
+            {
+                case 1:
+                    invHypotenuse = fastInvSqrt(
+                        distX * distX + distY * distY + distZ * distZ);
+                    break;
+                case 2:
+                    if (!distX)
+                    {
+                        invHypotenuse = 0;
+                        break;
+                    }
+
+                    invHypotenuse = 2.0F / (static_cast<float>(fabs(distX))
+                                    + static_cast<float>(fabs(distY))
+                                    + static_cast<float>(fabs(distZ)));
+                    break;
+                default:
+                    invHypotenuse = 1.0F / static_cast<float>(sqrt(
+                        distX * distX + distY * distY + distZ * distZ));
+                    break;
+            }
+
+            if (invHypotenuse)
+            {
+                const float invDieDistance = batch.invDieDistance[f];
+                if (invDieDistance > 0.0F && invHypotenuse > invDieDistance)
+                    status = Particle::DEAD_IMPACT;
+                const float accFactor = invHypotenuse * acceleration;
+                velX -= distX * accFactor;
+                velY -= distY * accFactor;
+                velZ -= distZ * accFactor;
+            }
+        }
+
+        velX += batch.randomX[f];
+        velY += batch.randomY[f];
+        velZ += batch.randomZ[f];
+        velZ -= batch.gravity[f];
+
+        posX += velX;
+        posY += velY * SIN45;
+        posZ += velZ * SIN45;
+
+        if (posZ < 0.0F)
+        {
+            const float bounce = batch.bounce[f];
+            if (bounce > 0.0F)
+            {
+                posZ *= -bounce;
+                velX *= bounce;
+                velY *= bounce;
+                velZ *= bounce;
+                velZ = -velZ;
+            }
+            else
+            {
+                status = Particle::DEAD_FLOOR;
+            }
+        }
+        else if (posZ > Particle::PARTICLE_SKY)
+        {
+            status = Particle::DEAD_SKY;
+        }
+
+        batch.posX[f] = posX;
+        batch.posY[f] = posY;
+        batch.posZ[f] = posZ;
+        batch.velX[f] = velX;
+        batch.velY[f] = velY;
+        batch.velZ[f] = velZ;
+        batch.status[f] = status;
+    }
+}
+
+#ifdef PARTICLE_SIMD
+
+// Lanes math repeats updateScalar step by step, for get same results.
+
+__attribute__((target("sse2")))
+void ParticlePhysics::updateSse2(ParticlePhysicsBatch &batch,
+                                 const int fastPhysics)
+{
+    const size_t end = batch.size & ~static_cast<size_t>(3);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signMask = _mm_set1_ps(-0.0F);
+    const __m128 sin45 = _mm_set1_ps(SIN45);
+    const __m128 sky = _mm_set1_ps(Particle::PARTICLE_SKY);
+    const __m128 deadImpact = _mm_castsi128_ps(
+        _mm_set1_epi32(Particle::DEAD_IMPACT));
+    const __m128 deadFloor = _mm_castsi128_ps(
+        _mm_set1_epi32(Particle::DEAD_FLOOR));
+    const __m128 deadSky = _mm_castsi128_ps(
+        _mm_set1_epi32(Particle::DEAD_SKY));
+
+    for (size_t f = 0; f < end; f += 4)
+    {
+        __m128 status = zero;
+        __m128 posX = _mm_loadu_ps(&batch.posX[f]);
+        __m128 posY = _mm_loadu_ps(&batch.posY[f]);
+        __m128 posZ = _mm_loadu_ps(&batch.posZ[f]);
+        const __m128 momentum = _mm_loadu_ps(&batch.momentum[f]);
+        __m128 velX = _mm_mul_ps(_mm_loadu_ps(&batch.velX[f]), momentum);
+        __m128 velY = _mm_mul_ps(_mm_loadu_ps(&batch.velY[f]), momentum);
+        __m128 velZ = _mm_mul_ps(_mm_loadu_ps(&batch.velZ[f]), momentum);
+
+        const __m128 acceleration = _mm_loadu_ps(&batch.acceleration[f]);
+        const __m128 accMask = _mm_cmpneq_ps(acceleration, zero);
+        if (_mm_movemask_ps(accMask))
+        {
+            const __m128 distX = _mm_mul_ps(_mm_sub_ps(posX,
+                _mm_loadu_ps(&batch.targetX[f])), sin45);
+            const __m128 distY = _mm_sub_ps(posY,
+                _mm_loadu_ps(&batch.targetY[f]));
+            const __m128 distZ = _mm_sub_ps(posZ,
+                _mm_loadu_ps(&batch.targetZ[f]));
+            const __m128 sq = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(distX, distX),
+                _mm_mul_ps(distY, distY)),
+                _mm_mul_ps(distZ, distZ));
+            __m128 invHypotenuse;
+
+            switch (fastPhysics)
+            {
+                case 1:
+                {
+                    const __m128 xhalf = _mm_mul_ps(_mm_set1_ps(0.5F), sq);
+                    const __m128 x = _mm_castsi128_ps(_mm_sub_epi32(
+                        _mm_set1_epi32(0x5f375a86),
+                        _mm_srai_epi32(_mm_castps_si128(sq), 1)));
+                    invHypotenuse = _mm_mul_ps(x, _mm_sub_ps(
+                        _mm_set1_ps(1.5F),
+                        _mm_mul_ps(_mm_mul_ps(xhalf, x), x)));
+                    break;
+                }
+                case 2:
+                {
+                    const __m128 sum = _mm_add_ps(_mm_add_ps(
+                        _mm_andnot_ps(signMask, distX),
+                        _mm_andnot_ps(signMask, distY)),
+                        _mm_andnot_ps(signMask, distZ));
+                    invHypotenuse = _mm_andnot_ps(
+                        _mm_cmpeq_ps(distX, zero),
+                        _mm_div_ps(_mm_set1_ps(2.0F), sum));
+                    break;
+                }
+                default:
+                    invHypotenuse = _mm_div_ps(_mm_set1_ps(1.0F),
+                        _mm_sqrt_ps(sq));
+                    break;
+            }
+
+            const __m128 applyMask = _mm_and_ps(accMask,
+                _mm_cmpneq_ps(invHypotenuse, zero));
+            const __m128 invDieDistance = _mm_loadu_ps(
+                &batch.invDieDistance[f]);
+            const __m128 impactMask = _mm_and_ps(applyMask, _mm_and_ps(
+                _mm_cmpgt_ps(invDieDistance, zero),
+                _mm_cmpgt_ps(invHypotenuse, invDieDistance)));
+            status = _mm_and_ps(impactMask, deadImpact);
+
+            const __m128 accFactor = _mm_mul_ps(invHypotenuse, acceleration);
+            velX = _mm_sub_ps(velX, _mm_and_ps(applyMask,
+                _mm_mul_ps(distX, accFactor)));
+            velY = _mm_sub_ps(velY, _mm_and_ps(applyMask,
+                _mm_mul_ps(distY, accFactor)));
+            velZ = _mm_sub_ps(velZ, _mm_and_ps(applyMask,
+                _mm_mul_ps(distZ, accFactor)));
+        }
+
+        velX = _mm_add_ps(velX, _mm_loadu_ps(&batch.randomX[f]));
+        velY = _mm_add_ps(velY, _mm_loadu_ps(&batch.randomY[f]));
+        velZ = _mm_add_ps(velZ, _mm_loadu_ps(&batch.randomZ[f]));
+        velZ = _mm_sub_ps(velZ, _mm_loadu_ps(&batch.gravity[f]));
+
+        posX = _mm_add_ps(posX, velX);
+        posY = _mm_add_ps(posY, _mm_mul_ps(velY, sin45));
+        posZ = _mm_add_ps(posZ, _mm_mul_ps(velZ, sin45));
+
+        const __m128 bounce = _mm_loadu_ps(&batch.bounce[f]);
+        const __m128 floorMask = _mm_cmplt_ps(posZ, zero);
+        const __m128 skyMask = _mm_cmpgt_ps(posZ, sky);
+        const __m128 bounceMask = _mm_and_ps(floorMask,
+            _mm_cmpgt_ps(bounce, zero));
+        const __m128 floorDeadMask = _mm_andnot_ps(bounceMask, floorMask);
+
+        posZ = _mm_or_ps(_mm_andnot_ps(bounceMask, posZ),
+            _mm_and_ps(bounceMask, _mm_mul_ps(posZ,
+            _mm_xor_ps(bounce, signMask))));
+        velX = _mm_or_ps(_mm_andnot_ps(bounceMask, velX),
+            _mm_and_ps(bounceMask, _mm_mul_ps(velX, bounce)));
+        velY = _mm_or_ps(_mm_andnot_ps(bounceMask, velY),
+            _mm_and_ps(bounceMask, _mm_mul_ps(velY, bounce)));
+        velZ = _mm_or_ps(_mm_andnot_ps(bounceMask, velZ),
+            _mm_and_ps(bounceMask, _mm_xor_ps(_mm_mul_ps(velZ, bounce),
+            signMask)));
+
+        status = _mm_or_ps(_mm_andnot_ps(floorDeadMask, status),
+            _mm_and_ps(floorDeadMask, deadFloor));
+        status = _mm_or_ps(_mm_andnot_ps(skyMask, status),
+            _mm_and_ps(skyMask, deadSky));
+
+        _mm_storeu_ps(&batch.posX[f], posX);
+        _mm_storeu_ps(&batch.posY[f], posY);
+        _mm_storeu_ps(&batch.posZ[f], posZ);
+        _mm_storeu_ps(&batch.velX[f], velX);
+        _mm_storeu_ps(&batch.velY[f], velY);
+        _mm_storeu_ps(&batch.velZ[f], velZ);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&batch.status[f]),
+            _mm_castps_si128(status));
+    }
+    updateScalar(batch, end, fastPhysics);
+}
+
+__attribute__((target("avx2")))
+void ParticlePhysics::updateAvx2(ParticlePhysicsBatch &batch,
+                                 const int fastPhysics)
+{
+    const size_t end = batch.size & ~static_cast<size_t>(7);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signMask = _mm256_set1_ps(-0.0F);
+    const __m256 sin45 = _mm256_set1_ps(SIN45);
+    const __m256 sky = _mm256_set1_ps(Particle::PARTICLE_SKY);
+    const __m256 deadImpact = _mm256_castsi256_ps(
+        _mm256_set1_epi32(Particle::DEAD_IMPACT));
+    const __m256 deadFloor = _mm256_castsi256_ps(
+        _mm256_set1_epi32(Particle::DEAD_FLOOR));
+    const __m256 deadSky = _mm256_castsi256_ps(
+        _mm256_set1_epi32(Particle::DEAD_SKY));
+
+    for (size_t f = 0; f < end; f += 8)
+    {
+        __m256 status = zero;
+        __m256 posX = _mm256_loadu_ps(&batch.posX[f]);
+        __m256 posY = _mm256_loadu_ps(&batch.posY[f]);
+        __m256 posZ = _mm256_loadu_ps(&batch.posZ[f]);
+        const __m256 momentum = _mm256_loadu_ps(&batch.momentum[f]);
+        __m256 velX = _mm256_mul_ps(_mm256_loadu_ps(&batch.velX[f]),
+            momentum);
+        __m256 velY = _mm256_mul_ps(_mm256_loadu_ps(&batch.velY[f]),
+            momentum);
+        __m256 velZ = _mm256_mul_ps(_mm256_loadu_ps(&batch.velZ[f]),
+            momentum);
+
+        const __m256 acceleration = _mm256_loadu_ps(
+            &batch.acceleration[f]);
+        const __m256 accMask = _mm256_cmp_ps(acceleration, zero,
+            _CMP_NEQ_UQ);
+        if (_mm256_movemask_ps(accMask))
+        {
+            const __m256 distX = _mm256_mul_ps(_mm256_sub_ps(posX,
+                _mm256_loadu_ps(&batch.targetX[f])), sin45);
+            const __m256 distY = _mm256_sub_ps(posY,
+                _mm256_loadu_ps(&batch.targetY[f]));
+            const __m256 distZ = _mm256_sub_ps(posZ,
+                _mm256_loadu_ps(&batch.targetZ[f]));
+            const __m256 sq = _mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(distX, distX),
+                _mm256_mul_ps(distY, distY)),
+                _mm256_mul_ps(distZ, distZ));
+            __m256 invHypotenuse;
+
+            switch (fastPhysics)
+            {
+                case 1:
+                {
+                    const __m256 xhalf = _mm256_mul_ps(
+                        _mm256_set1_ps(0.5F), sq);
+                    const __m256 x = _mm256_castsi256_ps(_mm256_sub_epi32(
+                        _mm256_set1_epi32(0x5f375a86),
+                        _mm256_srai_epi32(_mm256_castps_si256(sq), 1)));
+                    invHypotenuse = _mm256_mul_ps(x, _mm256_sub_ps(
+                        _mm256_set1_ps(1.5F),
+                        _mm256_mul_ps(_mm256_mul_ps(xhalf, x), x)));
+                    break;
+                }
+                case 2:
+                {
+                    const __m256 sum = _mm256_add_ps(_mm256_add_ps(
+                        _mm256_andnot_ps(signMask, distX),
+                        _mm256_andnot_ps(signMask, distY)),
+                        _mm256_andnot_ps(signMask, distZ));
+                    invHypotenuse = _mm256_andnot_ps(
+                        _mm256_cmp_ps(distX, zero, _CMP_EQ_OQ),
+                        _mm256_div_ps(_mm256_set1_ps(2.0F), sum));
+                    break;
+                }
+                default:
+                    invHypotenuse = _mm256_div_ps(_mm256_set1_ps(1.0F),
+                        _mm256_sqrt_ps(sq));
+                    break;
+            }
+
+            const __m256 applyMask = _mm256_and_ps(accMask,
+                _mm256_cmp_ps(invHypotenuse, zero, _CMP_NEQ_UQ));
+            const __m256 invDieDistance = _mm256_loadu_ps(
+                &batch.invDieDistance[f]);
+            const __m256 impactMask = _mm256_and_ps(applyMask,
+                _mm256_and_ps(
+                _mm256_cmp_ps(invDieDistance, zero, _CMP_GT_OQ),
+                _mm256_cmp_ps(invHypotenuse, invDieDistance, _CMP_GT_OQ)));
+            status = _mm256_and_ps(impactMask, deadImpact);
+
+            const __m256 accFactor = _mm256_mul_ps(invHypotenuse,
+                acceleration);
+            velX = _mm256_sub_ps(velX, _mm256_and_ps(applyMask,
+                _mm256_mul_ps(distX, accFactor)));
+            velY = _mm256_sub_ps(velY, _mm256_and_ps(applyMask,
+                _mm256_mul_ps(distY, accFactor)));
+            velZ = _mm256_sub_ps(velZ, _mm256_and_ps(applyMask,
+                _mm256_mul_ps(distZ, accFactor)));
+        }
+
+        velX = _mm256_add_ps(velX, _mm256_loadu_ps(&batch.randomX[f]));
+        velY = _mm256_add_ps(velY, _mm256_loadu_ps(&batch.randomY[f]));
+        velZ = _mm256_add_ps(velZ, _mm256_loadu_ps(&batch.randomZ[f]));
+        velZ = _mm256_sub_ps(velZ, _mm256_loadu_ps(&batch.gravity[f]));
+
+        posX = _mm256_add_ps(posX, velX);
+        posY = _mm256_add_ps(posY, _mm256_mul_ps(velY, sin45));
+        posZ = _mm256_add_ps(posZ, _mm256_mul_ps(velZ, sin45));
+
+        const __m256 bounce = _mm256_loadu_ps(&batch.bounce[f]);
+        const __m256 floorMask = _mm256_cmp_ps(posZ, zero, _CMP_LT_OQ);
+        const __m256 skyMask = _mm256_cmp_ps(posZ, sky, _CMP_GT_OQ);
+        const __m256 bounceMask = _mm256_and_ps(floorMask,
+            _mm256_cmp_ps(bounce, zero, _CMP_GT_OQ));
+        const __m256 floorDeadMask = _mm256_andnot_ps(bounceMask,
+            floorMask);
+
+        posZ = _mm256_blendv_ps(posZ, _mm256_mul_ps(posZ,
+            _mm256_xor_ps(bounce, signMask)), bounceMask);
+        velX = _mm256_blendv_ps(velX, _mm256_mul_ps(velX, bounce),
+            bounceMask);
+        velY = _mm256_blendv_ps(velY, _mm256_mul_ps(velY, bounce),
+            bounceMask);
+        velZ = _mm256_blendv_ps(velZ, _mm256_xor_ps(
+            _mm256_mul_ps(velZ, bounce), signMask), bounceMask);
+
+        status = _mm256_blendv_ps(status, deadFloor, floorDeadMask);
+        status = _mm256_blendv_ps(status, deadSky, skyMask);
+
+        _mm256_storeu_ps(&batch.posX[f], posX);
+        _mm256_storeu_ps(&batch.posY[f], posY);
+        _mm256_storeu_ps(&batch.posZ[f], posZ);
+        _mm256_storeu_ps(&batch.velX[f], velX);
+        _mm256_storeu_ps(&batch.velY[f], velY);
+        _mm256_storeu_ps(&batch.velZ[f], velZ);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&batch.status[f]),
+            _mm256_castps_si256(status));
+    }
+    updateScalar(batch, end, fastPhysics);
+}
+
+#endif  // PARTICLE_SIMD
@@ -0,0 +1,116 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARTICLE_PARTICLEPHYSICS_H
+#define PARTICLE_PARTICLEPHYSICS_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "localconsts.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && (GCC_VERSION >= 40900) \
+    && (defined(__x86_64__) || defined(__i386__)) && !defined(ANDROID)
+#define PARTICLE_SIMD
+#endif
+
+/**
+ * Physics state of particles updated together, one array per field.
+ */
+struct ParticlePhysicsBatch final
+{
+    ParticlePhysicsBatch() :
+        posX(),
+        posY(),
+        posZ(),
+        velX(),
+        velY(),
+        velZ(),
+        targetX(),
+        targetY(),
+        targetZ(),
+        acceleration(),
+        invDieDistance(),
+        momentum(),
+        gravity(),
+        bounce(),
+        randomX(),
+        randomY(),
+        randomZ(),
+        status(),
+        size(0)
+    {
+    }
+
+    A_DELETE_COPY(ParticlePhysicsBatch)
+
+    void resize(const size_t sz);
+
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> posZ;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> velZ;
+    // target position, used only if acceleration is not zero
+    std::vector<float> targetX;
+    std::vector<float> targetY;
+    std::vector<float> targetZ;
+    std::vector<float> acceleration;
+    std::vector<float> invDieDistance;
+    std::vector<float> momentum;
+    std::vector<float> gravity;
+    std::vector<float> bounce;
+    // velocity change from particle randomness
+    std::vector<float> randomX;
+    std::vector<float> randomY;
+    std::vector<float> randomZ;
+    // output, Particle::AliveStatus
+    std::vector<int32_t> status;
+    size_t size;
+};
+
+/**
+ * Moves particles one game tick. Implementation selected at runtime
+ * from detected cpu features.
+ */
+namespace ParticlePhysics
+{
+    void init();
+
+    void update(ParticlePhysicsBatch &batch, const int fastPhysics);
+
+    /**
+     * Reference implementation, updates particles from start to end.
+     */
+    void updateScalar(ParticlePhysicsBatch &batch,
+                      const size_t start,
+                      const int fastPhysics);
+
+#ifdef PARTICLE_SIMD
+    void updateSse2(ParticlePhysicsBatch &batch, const int fastPhysics);
+
+    void updateAvx2(ParticlePhysicsBatch &batch, const int fastPhysics);
+#endif
+
+    const char *getName() A_WARN_UNUSED;
+}  // namespace ParticlePhysics
+
+#endif  // PARTICLE_PARTICLEPHYSICS_H
@@ -0,0 +1,178 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "particle/particlephysics.h"
+
+#include "logger.h"
+
+#include "particle/particle.h"
+
+#include "utils/cpu.h"
+#include "utils/delete2.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "debug.h"
+
+static const size_t batchSize = 37;
+
+static float getValue(const int f, const int mul, const int range)
+{
+    return static_cast<float>((f * mul) % range - range / 2) / 10.0F;
+}
+
+static void fillBatch(ParticlePhysicsBatch &batch)
+{
+    batch.resize(batchSize);
+    for (size_t f = 0; f < batchSize; f ++)
+    {
+        const int i = static_cast<int>(f);
+        batch.posX[f] = getValue(i, 37, 2000);
+        batch.posY[f] = getValue(i, 53, 2000);
+        // some particles near floor and near sky
+        batch.posZ[f] = static_cast<float>((i * 97) % 8050) / 10.0F;
+        batch.velX[f] = getValue(i, 13, 60);
+        batch.velY[f] = getValue(i, 17, 60);
+        batch.velZ[f] = getValue(i, 19, 200);
+        batch.targetX[f] = getValue(i, 7, 2000);
+        batch.targetY[f] = getValue(i, 11, 2000);
+        batch.targetZ[f] = getValue(i, 23, 200);
+        if (f % 5 == 0)
+        {
+            // particle already on target
+            batch.targetX[f] = batch.posX[f];
+            batch.targetY[f] = batch.posY[f];
+            batch.targetZ[f] = batch.posZ[f];
+        }
+        batch.acceleration[f] = (f % 3) ? getValue(i, 29, 40) : 0.0F;
+        batch.invDieDistance[f] = (f % 4) ? 1.0F / (f * 3.0F) : -1.0F;
+        batch.momentum[f] = (f % 2) ? 0.95F : 1.0F;
+        batch.gravity[f] = getValue(i, 3, 20) / 10.0F;
+        batch.bounce[f] = (f % 3 == 1) ? 0.5F : 0.0F;
+        batch.randomX[f] = getValue(i, 41, 30) / 100.0F;
+        batch.randomY[f] = getValue(i, 43, 30) / 100.0F;
+        batch.randomZ[f] = getValue(i, 47, 30) / 100.0F;
+        batch.status[f] = -1;
+    }
+}
+
+static void expectSame(const std::vector<float> &vals1,
+                       const std::vector<float> &vals2)
+{
+    for (size_t f = 0; f < batchSize; f ++)
+    {
+        if (std::isnan(vals1[f]))
+            EXPECT_TRUE(std::isnan(vals2[f]));
+        else
+            EXPECT_EQ(0, memcmp(&vals1[f], &vals2[f], sizeof(float)));
+    }
+}
+
+static void expectSame(const ParticlePhysicsBatch &batch1,
+                       const ParticlePhysicsBatch &batch2)
+{
+    expectSame(batch1.posX, batch2.posX);
+    expectSame(batch1.posY, batch2.posY);
+    expectSame(batch1.posZ, batch2.posZ);
+    expectSame(batch1.velX, batch2.velX);
+    expectSame(batch1.velY, batch2.velY);
+    expectSame(batch1.velZ, batch2.velZ);
+    for (size_t f = 0; f < batchSize; f ++)
+        EXPECT_EQ(batch1.status[f], batch2.status[f]);
+}
+
+static void init()
+{
+    logger = new Logger();
+    Cpu::detect();
+}
+
+TEST(ParticlePhysics, scalar)
+{
+    ParticlePhysicsBatch batch;
+    fillBatch(batch);
+    const float posX = batch.posX[0];
+    const float velX = batch.velX[0];
+    ParticlePhysics::updateScalar(batch, 0, 0);
+
+    // no acceleration and momentum
+    EXPECT_FLOAT_EQ(velX + batch.randomX[0], batch.velX[0]);
+    EXPECT_FLOAT_EQ(posX + batch.velX[0], batch.posX[0]);
+
+    bool hasDead = false;
+    bool hasAlive = false;
+    for (size_t f = 0; f < batchSize; f ++)
+    {
+        const int32_t status = batch.status[f];
+        EXPECT_TRUE(status == Particle::ALIVE
+            || status == Particle::DEAD_FLOOR
+            || status == Particle::DEAD_SKY
+            || status == Particle::DEAD_IMPACT);
+        if (status == Particle::ALIVE)
+            hasAlive = true;
+        else
+            hasDead = true;
+    }
+    EXPECT_TRUE(hasAlive);
+    EXPECT_TRUE(hasDead);
+}
+
+#ifdef PARTICLE_SIMD
+TEST(ParticlePhysics, sse2)
+{
+    init();
+    if (Cpu::getFlags() & Cpu::FEATURE_SSE2)
+    {
+        for (int fastPhysics = 0; fastPhysics < 3; fastPhysics ++)
+        {
+            ParticlePhysicsBatch batch1;
+            ParticlePhysicsBatch batch2;
+            fillBatch(batch1);
+            fillBatch(batch2);
+            ParticlePhysics::updateScalar(batch1, 0, fastPhysics);
+            ParticlePhysics::updateSse2(batch2, fastPhysics);
+            expectSame(batch1, batch2);
+        }
+    }
+    delete2(logger);
+}
+
+TEST(ParticlePhysics, avx2)
+{
+    init();
+    if (Cpu::getFlags() & Cpu::FEATURE_AVX2)
+    {
+        for (int fastPhysics = 0; fastPhysics < 3; fastPhysics ++)
+        {
+            ParticlePhysicsBatch batch1;
+            ParticlePhysicsBatch batch2;
+            fillBatch(batch1);
+            fillBatch(batch2);
+            ParticlePhysics::updateScalar(batch1, 0, fastPhysics);
+            ParticlePhysics::updateAvx2(batch2, fastPhysics);
+            expectSame(batch1, batch2);
+        }
+    }
+    delete2(logger);
+}
+#endif  // PARTICLE_SIMD
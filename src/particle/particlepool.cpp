@@ -0,0 +1,121 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "particle/particlepool.h"
+
+#include <cstdlib>
+#include <new>
+
+#include "debug.h"
+
+namespace
+{
+    // all sizes rounded up to this value
+    const size_t granularity = 16;
+    // bigger objects allocated directly
+    const size_t maxPooledSize = 512;
+    const size_t bucketsCount = maxPooledSize / granularity;
+    // objects allocated together in one slab
+    const size_t slabObjects = 64;
+
+    struct FreeNode final
+    {
+        FreeNode *next;
+    };
+
+    // slabs never returned to system, pool size limited by peak
+    // particles count.
+    FreeNode *mFreeLists[bucketsCount] = { };
+    int mUsedCount = 0;
+    int mFreeCount = 0;
+
+    size_t sizeToBucket(const size_t size) A_WARN_UNUSED;
+    size_t sizeToBucket(const size_t size)
+    {
+        return (size + granularity - 1) / granularity - 1;
+    }
+
+    void addSlab(const size_t bucket)
+    {
+        const size_t objectSize = (bucket + 1) * granularity;
+        char *const slab = static_cast<char*>(
+            malloc(objectSize * slabObjects));
+        if (!slab)
+            throw std::bad_alloc();
+        // link objects in memory order, so first allocations are adjacent
+        for (size_t f = slabObjects; f > 0; f --)
+        {
+            FreeNode *const node = reinterpret_cast<FreeNode*>(
+                slab + (f - 1) * objectSize);
+            node->next = mFreeLists[bucket];
+            mFreeLists[bucket] = node;
+        }
+        mFreeCount += static_cast<int>(slabObjects);
+    }
+}  // namespace
+
+void *ParticlePool::allocate(const size_t size)
+{
+    if (size == 0 || size > maxPooledSize)
+    {
+        void *const ptr = malloc(size ? size : 1);
+        if (!ptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+
+    const size_t bucket = sizeToBucket(size);
+    if (!mFreeLists[bucket])
+        addSlab(bucket);
+
+    FreeNode *const node = mFreeLists[bucket];
+    mFreeLists[bucket] = node->next;
+    mFreeCount --;
+    mUsedCount ++;
+    return node;
+}
+
+void ParticlePool::release(void *const ptr, const size_t size)
+{
+    if (!ptr)
+        return;
+    if (size == 0 || size > maxPooledSize)
+    {
+        free(ptr);
+        return;
+    }
+
+    const size_t bucket = sizeToBucket(size);
+    FreeNode *const node = static_cast<FreeNode*>(ptr);
+    node->next = mFreeLists[bucket];
+    mFreeLists[bucket] = node;
+    mFreeCount ++;
+    mUsedCount --;
+}
+
+int ParticlePool::getUsedCount()
+{
+    return mUsedCount;
+}
+
+int ParticlePool::getFreeCount()
+{
+    return mFreeCount;
+}
@@ -0,0 +1,45 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARTICLE_PARTICLEPOOL_H
+#define PARTICLE_PARTICLEPOOL_H
+
+#include <cstddef>
+
+#include "localconsts.h"
+
+/**
+ * Slab allocator for particle objects. Memory of deleted particles is
+ * kept in per size free lists and reused by next particles, so particle
+ * bursts do not hit the system allocator and live particles stay close
+ * to each other in memory.
+ */
+namespace ParticlePool
+{
+    void *allocate(const size_t size) A_WARN_UNUSED;
+
+    void release(void *const ptr, const size_t size);
+
+    int getUsedCount() A_WARN_UNUSED;
+
+    int getFreeCount() A_WARN_UNUSED;
+}  // namespace ParticlePool
+
+#endif  // PARTICLE_PARTICLEPOOL_H
@@ -0,0 +1,81 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARTICLE_PARTICLETEMPLATE_H
+#define PARTICLE_PARTICLETEMPLATE_H
+
+#include <string>
+#include <vector>
+
+#include "localconsts.h"
+
+class Image;
+class ParticleEmitter;
+class SimpleAnimation;
+
+/**
+ * Parsed form of one <particle> node from a particle effect file.
+ * Owned by ParticleEffect, which releases the referenced resources.
+ */
+struct ParticleTemplate final
+{
+    enum Type
+    {
+        PLAIN = 0,
+        IMAGE,
+        ANIMATION,
+        ROTATION
+    };
+
+    ParticleTemplate() :
+        emitters(),
+        deathEffect(),
+        image(nullptr),
+        animation(nullptr),
+        offsetX(0.0F),
+        offsetY(0.0F),
+        offsetZ(0.0F),
+        lifetime(-1),
+        type(PLAIN),
+        deathEffectConditions(0x00),
+        sizeAdjustable(false)
+    {
+    }
+
+    A_DELETE_COPY(ParticleTemplate)
+
+    // Prototype emitters copied into every new particle
+    std::vector<ParticleEmitter*> emitters;
+    std::string deathEffect;
+    Image *image;
+    SimpleAnimation *animation;
+    float offsetX;
+    float offsetY;
+    float offsetZ;
+    int lifetime;
+    Type type;
+    signed char deathEffectConditions;
+    bool sizeAdjustable;
+};
+
+typedef std::vector<ParticleTemplate*> ParticleTemplates;
+typedef ParticleTemplates::const_iterator ParticleTemplatesCIter;
+
+#endif  // PARTICLE_PARTICLETEMPLATE_H
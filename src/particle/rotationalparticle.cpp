@@ -22,42 +22,34 @@
 
 #include "particle/rotationalparticle.h"
 
-#include "simpleanimation.h"
-
-#include "utils/delete2.h"
-
 #include "debug.h"
 
 static const double PI = M_PI;
 static const float PI2 = 2 * M_PI;
 
-RotationalParticle::RotationalParticle(Animation *const animation) :
+RotationalParticle::RotationalParticle(const Animation &animation) :
     ImageParticle(nullptr),
-    mAnimation(new SimpleAnimation(animation))
+    mAnimation(animation)
 {
 }
 
 RotationalParticle::RotationalParticle(const XmlNodePtr animationNode,
                                        const std::string& dyePalettes) :
     ImageParticle(nullptr),
-    mAnimation(new SimpleAnimation(animationNode, dyePalettes))
+    mAnimation(animationNode, dyePalettes)
 {
 }
 
 RotationalParticle::~RotationalParticle()
 {
-    delete2(mAnimation);
     mImage = nullptr;
 }
 
 bool RotationalParticle::update()
 {
-    if (!mAnimation)
-        return false;
-
     // TODO: cache velocities to avoid spamming atan2()
 
-    const int size = mAnimation->getLength();
+    const int size = mAnimation.getLength();
     if (!size)
         return false;
 
@@ -70,7 +62,7 @@ bool RotationalParticle::update()
     // Determines which frame the particle should play
     if (rad < range || rad > PI2 - range)
     {
-        mAnimation->setFrame(0);
+        mAnimation.setFrame(0);
     }
     else
     {
@@ -79,13 +71,13 @@ bool RotationalParticle::update()
             if (((static_cast<float>(c) * (2 * range)) - range) < rad
                 && rad < ((static_cast<float>(c) * (2 * range)) + range))
             {
-                mAnimation->setFrame(c);
+                mAnimation.setFrame(c);
                 break;
             }
         }
     }
 
-    mImage = mAnimation->getCurrentImage();
+    mImage = mAnimation.getCurrentImage();
 
     return Particle::update();
 }
@@ -23,17 +23,22 @@
 #ifndef PARTICLE_ROTATIONALPARTICLE_H
 #define PARTICLE_ROTATIONALPARTICLE_H
 
+#include "simpleanimation.h"
+
 #include "particle/imageparticle.h"
 
 #include "utils/xml.h"
 
 class Animation;
-class SimpleAnimation;
 
 class RotationalParticle final : public ImageParticle
 {
     public:
-        explicit RotationalParticle(Animation *const animation);
+        /**
+         * Plays animation owned by emitter or cached effect,
+         * which must outlive the particle.
+         */
+        explicit RotationalParticle(const Animation &animation);
 
         explicit RotationalParticle(const XmlNodePtr animationNode,
                                     const std::string& dyePalettes
@@ -46,7 +51,7 @@ class RotationalParticle final : public ImageParticle
         bool update() override final;
 
     private:
-        SimpleAnimation *mAnimation; /**< Used animation for this particle */
+        SimpleAnimation mAnimation; /**< Used animation for this particle */
 };
 
 #endif  // PARTICLE_ROTATIONALPARTICLE_H
@@ -217,6 +217,17 @@ class Graphics notfinal
 
         virtual void drawTileVertexes(const ImageVertexes *const vert) = 0;
 
+        /**
+         * Draws vertexes already uploaded by finalize, moved on screen by
+         * dx and dy. Supported only if renderer keeps vertexes in gpu.
+         */
+        virtual void drawStaticVertexes(const ImageVertexes *const vert
+                                        A_UNUSED,
+                                        const int dx A_UNUSED,
+                                        const int dy A_UNUSED)
+        {
+        }
+
         virtual void drawTileCollection(const ImageCollection
                                         *const vertCol) = 0;
 
@@ -326,6 +337,13 @@ class Graphics notfinal
         const Color &getColor2() const
         { return mColor2; }
 
+        /**
+         * Sets color multiplied with colors of next drawn images.
+         * Used for glyph atlases, other renderers ignore it.
+         */
+        virtual void setImageColor(const Color &color A_UNUSED)
+        { }
+
 #ifdef DEBUG_DRAW_CALLS
         virtual unsigned int getDrawCalls() const
         { return 0; }
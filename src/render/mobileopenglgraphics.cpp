@@ -81,6 +81,7 @@ MobileOpenGLGraphics::MobileOpenGLGraphics() :
     mTexture(false),
     mIsByteColor(false),
     mByteColor(),
+    mImageColor(255, 255, 255),
     mImageCached(0),
     mFloatColor(1.0F),
     mMaxVertices(500),
@@ -151,48 +152,6 @@ bool MobileOpenGLGraphics::setVideoMode(const int w, const int h,
     return setOpenGLMode();
 }
 
-static inline void drawQuad(const Image *const image,
-                            const int srcX, const int srcY,
-                            const int dstX, const int dstY,
-                            const int width, const int height)
-{
-//    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
-    {
-        const float tw = static_cast<float>(image->mTexWidth);
-        const float th = static_cast<float>(image->mTexHeight);
-        // Find OpenGL normalized texture coordinates.
-        const float texX1 = static_cast<float>(srcX) / tw;
-        const float texY1 = static_cast<float>(srcY) / th;
-        const float texX2 = static_cast<float>(srcX + width) / tw;
-        const float texY2 = static_cast<float>(srcY + height) / th;
-
-        GLfloat tex[] =
-        {
-            texX1, texY1,
-            texX2, texY1,
-            texX1, texY2,
-            texX2, texY2
-        };
-
-        GLshort vert[] =
-        {
-            static_cast<GLshort>(dstX), static_cast<GLshort>(dstY),
-            static_cast<GLshort>(dstX + width), static_cast<GLshort>(dstY),
-            static_cast<GLshort>(dstX), static_cast<GLshort>(dstY + height),
-            static_cast<GLshort>(dstX + width),
-                static_cast<GLshort>(dstY + height)
-        };
-
-        glVertexPointer(2, GL_SHORT, 0, &vert);
-        glTexCoordPointer(2, GL_FLOAT, 0, &tex);
-
-#ifdef DEBUG_DRAW_CALLS
-        MobileOpenGLGraphics::mDrawCalls ++;
-#endif
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    }
-}
-
 static inline void drawRescaledQuad(const Image *const image,
                                     const int srcX, const int srcY,
                                     const int dstX, const int dstY,
@@ -251,153 +210,72 @@ void MobileOpenGLGraphics::drawImageInline(const Image *const image,
     if (!image)
         return;
 
-    setColorAlpha(image->mAlpha);
-#ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
-#endif
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
-    setTexturingAndBlending(true);
-
-    const SDL_Rect &imageRect = image->mBounds;
-    drawQuad(image, imageRect.x, imageRect.y,
-        dstX, dstY, imageRect.w, imageRect.h);
-}
-
-void MobileOpenGLGraphics::copyImage(const Image *const image,
-                                     int dstX, int dstY)
-{
-    drawImageInline(image, dstX, dstY);
-}
-
-void MobileOpenGLGraphics::drawImageCached(const Image *const image,
-                                           int x, int y)
-{
-    if (!image)
-        return;
-
-    if (image->mGLImage != mImageCached)
+    // consecutive images with same texture and alpha merged in one draw call
+    if (image->mGLImage != mImageCached || image->mAlpha != mAlphaCached)
     {
         completeCache();
+#ifdef DEBUG_BIND_TEXTURE
+        debugBindTexture(image);
+#endif
         mImageCached = image->mGLImage;
         mAlphaCached = image->mAlpha;
     }
 
     const SDL_Rect &imageRect = image->mBounds;
-    const int srcX = imageRect.x;
-    const int srcY = imageRect.y;
     const int w = imageRect.w;
     const int h = imageRect.h;
 
     if (w == 0 || h == 0)
         return;
 
+    const int srcX = imageRect.x;
+    const int srcY = imageRect.y;
     const float tw = static_cast<float>(image->mTexWidth);
     const float th = static_cast<float>(image->mTexHeight);
+    const float texX1 = static_cast<float>(srcX) / tw;
+    const float texY1 = static_cast<float>(srcY) / th;
+    const float texX2 = static_cast<float>(srcX + w) / tw;
+    const float texY2 = static_cast<float>(srcY + h) / th;
+    const unsigned int vp = mVpCached;
+
+    vertFill2D(mFloatTexArrayCached, mShortVertArrayCached,
+        texX1, texY1, texX2, texY2,
+        dstX, dstY, w, h);
+
+    mVpCached = vp + 12;
+    if (mVpCached >= mMaxVertices * 4)
+        completeCache();
+}
 
-    const unsigned int vLimit = mMaxVertices * 4;
-
-    unsigned int vp = mVpCached;
-
-    // Draw a set of textured rectangles
-//    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
-    {
-        float texX1 = static_cast<float>(srcX) / tw;
-        float texY1 = static_cast<float>(srcY) / th;
-        float texX2 = static_cast<float>(srcX + w) / tw;
-        float texY2 = static_cast<float>(srcY + h) / th;
-
-        vertFill2D(mFloatTexArrayCached, mShortVertArrayCached,
-            texX1, texY1, texX2, texY2,
-            x, y, w, h);
+void MobileOpenGLGraphics::copyImage(const Image *const image,
+                                     int dstX, int dstY)
+{
+    drawImageInline(image, dstX, dstY);
+}
 
-        vp += 12;
-        if (vp >= vLimit)
-        {
-            completeCache();
-            vp = 0;
-        }
-        else
-        {
-            mVpCached = vp;
-        }
-    }
+void MobileOpenGLGraphics::drawImageCached(const Image *const image,
+                                           int x, int y)
+{
+    drawImageInline(image, x, y);
 }
 
 void MobileOpenGLGraphics::drawPatternCached(const Image *const image,
                                              const int x, const int y,
                                              const int w, const int h)
 {
-    if (!image)
-        return;
-
-    if (image->mGLImage != mImageCached)
-    {
-        completeCache();
-        mImageCached = image->mGLImage;
-    }
-
-    const SDL_Rect &imageRect = image->mBounds;
-    const int srcX = imageRect.x;
-    const int srcY = imageRect.y;
-    const int iw = imageRect.w;
-    const int ih = imageRect.h;
-
-    if (iw == 0 || ih == 0)
-        return;
-
-    const float tw = static_cast<float>(image->mTexWidth);
-    const float th = static_cast<float>(image->mTexHeight);
-
-    unsigned int vp = mVpCached;
-    const unsigned int vLimit = mMaxVertices * 4;
-    // Draw a set of textured rectangles
-//    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
-//    {
-        const float texX1 = static_cast<float>(srcX) / tw;
-        const float texY1 = static_cast<float>(srcY) / th;
-
-        for (int py = 0; py < h; py += ih)
-        {
-            const int height = (py + ih >= h) ? h - py : ih;
-            const float texY2 = static_cast<float>(srcY + height) / th;
-            const int dstY = y + py;
-            for (int px = 0; px < w; px += iw)
-            {
-                const int width = (px + iw >= w) ? w - px : iw;
-                const int dstX = x + px;
-
-                const float texX2 = static_cast<float>(srcX + width) / tw;
-
-                vertFill2D(mFloatTexArrayCached, mShortVertArrayCached,
-                    texX1, texY1, texX2, texY2,
-                    dstX, dstY, width, height);
-
-                vp += 12;
-                if (vp >= vLimit)
-                {
-                    completeCache();
-                    vp = 0;
-                }
-            }
-        }
-//    }
-    mVpCached = vp;
+    drawPatternInline(image, x, y, w, h);
 }
 
 void MobileOpenGLGraphics::completeCache()
 {
-    if (!mImageCached)
+    if (!mVpCached)
         return;
 
     setColorAlpha(mAlphaCached);
-#ifdef DEBUG_BIND_TEXTURE
-//    debugBindTexture(image);
-#endif
     bindTexture(OpenGLImageHelper::mTextureType, mImageCached);
     setTexturingAndBlending(true);
 
     drawTriangleArrayfsCached(mVpCached);
-    mImageCached = 0;
     mVpCached = 0;
 }
 
@@ -419,6 +297,7 @@ void MobileOpenGLGraphics::drawRescaledImage(const Image *const image,
         return;
     }
 
+    completeCache();
     setColorAlpha(image->mAlpha);
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
@@ -455,19 +334,20 @@ void MobileOpenGLGraphics::drawPatternInline(const Image *const image,
     if (iw == 0 || ih == 0)
         return;
 
-    const float tw = static_cast<float>(image->mTexWidth);
-    const float th = static_cast<float>(image->mTexHeight);
-
-    setColorAlpha(image->mAlpha);
-
+    if (image->mGLImage != mImageCached || image->mAlpha != mAlphaCached)
+    {
+        completeCache();
 #ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
+        debugBindTexture(image);
 #endif
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
+        mImageCached = image->mGLImage;
+        mAlphaCached = image->mAlpha;
+    }
 
-    setTexturingAndBlending(true);
+    const float tw = static_cast<float>(image->mTexWidth);
+    const float th = static_cast<float>(image->mTexHeight);
 
-    unsigned int vp = 0;
+    unsigned int vp = mVpCached;
     const unsigned int vLimit = mMaxVertices * 4;
     // Draw a set of textured rectangles
 //    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
@@ -487,21 +367,21 @@ void MobileOpenGLGraphics::drawPatternInline(const Image *const image,
 
                 const float texX2 = static_cast<float>(srcX + width) / tw;
 
-                vertFill2D(mFloatTexArray, mShortVertArray,
+                vertFill2D(mFloatTexArrayCached, mShortVertArrayCached,
                     texX1, texY1, texX2, texY2,
                     dstX, dstY, width, height);
 
                 vp += 12;
                 if (vp >= vLimit)
                 {
-                    drawTriangleArrayfs(vp);
+                    mVpCached = vp;
+                    completeCache();
                     vp = 0;
                 }
             }
         }
-        if (vp > 0)
-            drawTriangleArrayfs(vp);
 //    }
+    mVpCached = vp;
 }
 
 void MobileOpenGLGraphics::drawRescaledPattern(const Image *const image,
@@ -524,6 +404,7 @@ void MobileOpenGLGraphics::drawRescaledPattern(const Image *const image,
     if (iw == 0 || ih == 0)
         return;
 
+    completeCache();
     setColorAlpha(image->mAlpha);
 
 #ifdef DEBUG_BIND_TEXTURE
@@ -704,6 +585,7 @@ void MobileOpenGLGraphics::calcTileCollection(ImageCollection *const vertCol,
 void MobileOpenGLGraphics::drawTileCollection(const ImageCollection
                                               *const vertCol)
 {
+    completeCache();
     const ImageVertexesVector &draws = vertCol->draws;
     const ImageCollectionCIter it_end = draws.end();
     for (ImageCollectionCIter it = draws.begin(); it != it_end; ++ it)
@@ -807,6 +689,7 @@ void MobileOpenGLGraphics::drawTileVertexes(const ImageVertexes *const vert)
 {
     if (!vert)
         return;
+    completeCache();
     const Image *const image = vert->image;
 
     setColorAlpha(image->mAlpha);
@@ -843,6 +726,7 @@ void MobileOpenGLGraphics::calcWindow(ImageCollection *const vertCol,
 void MobileOpenGLGraphics::updateScreen()
 {
     BLOCK_START("Graphics::updateScreen")
+    completeCache();
 //    glFlush();
 //    glFinish();
 #ifdef DEBUG_DRAW_CALLS
@@ -917,6 +801,7 @@ void MobileOpenGLGraphics::prepareScreenshot()
 
 SDL_Surface* MobileOpenGLGraphics::getScreenshot()
 {
+    completeCache();
     const int h = mRect.h;
     const int w = mRect.w - (mRect.w % 4);
     GLint pack = 1;
@@ -968,6 +853,8 @@ SDL_Surface* MobileOpenGLGraphics::getScreenshot()
 
 void MobileOpenGLGraphics::pushClipArea(const Rect &area)
 {
+    completeCache();
+
     int transX = 0;
     int transY = 0;
 
@@ -997,6 +884,8 @@ void MobileOpenGLGraphics::pushClipArea(const Rect &area)
 
 void MobileOpenGLGraphics::popClipArea()
 {
+    completeCache();
+
     if (mClipStack.empty())
         return;
 
@@ -1029,6 +918,7 @@ void MobileOpenGLGraphics::drawPoint(int x A_UNUSED, int y A_UNUSED)
 void MobileOpenGLGraphics::drawPoint(int x, int y)
 #endif
 {
+    completeCache();
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1043,6 +933,7 @@ void MobileOpenGLGraphics::drawPoint(int x, int y)
 
 void MobileOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    completeCache();
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1108,6 +999,7 @@ void MobileOpenGLGraphics::drawRectangle(const Rect& rect,
                                          const bool filled)
 {
     BLOCK_START("Graphics::drawRectangle")
+    completeCache();
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1157,6 +1049,8 @@ void MobileOpenGLGraphics::drawNet(const int x1, const int y1,
                                    const int x2, const int y2,
                                    const int width, const int height)
 {
+    completeCache();
+
     unsigned int vp = 0;
     const unsigned int vLimit = mMaxVertices * 4;
 
@@ -1288,11 +1182,26 @@ void MobileOpenGLGraphics::setColorAlpha(const float alpha)
     if (!mIsByteColor && mFloatColor == alpha)
         return;
 
-    glColor4f(1.0F, 1.0F, 1.0F, alpha);
+    glColor4f(static_cast<float>(mImageColor.r) / 255.0F,
+        static_cast<float>(mImageColor.g) / 255.0F,
+        static_cast<float>(mImageColor.b) / 255.0F,
+        alpha);
     mIsByteColor = false;
     mFloatColor = alpha;
 }
 
+void MobileOpenGLGraphics::setImageColor(const Color &color)
+{
+    if (mImageColor == color)
+        return;
+
+    // images with other color can not be in same draw call
+    completeCache();
+    mImageColor = color;
+    // force color update in next setColorAlpha
+    mFloatColor = -1.0F;
+}
+
 void MobileOpenGLGraphics::restoreColor()
 {
     if (mIsByteColor && mByteColor == mColor)
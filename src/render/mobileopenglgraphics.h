@@ -71,6 +71,8 @@ class MobileOpenGLGraphics final : public Graphics
 
         #include "render/openglgraphicsdefadvanced.hpp"
 
+        void setImageColor(const Color &color) override final;
+
     private:
         GLfloat *mFloatTexArray;
         GLshort *mShortVertArray;
@@ -82,6 +84,7 @@ class MobileOpenGLGraphics final : public Graphics
 
         bool mIsByteColor;
         Color mByteColor;
+        Color mImageColor;
         GLuint mImageCached;
         float mFloatColor;
         int mMaxVertices;
@@ -87,20 +87,24 @@ ModernOpenGLGraphics::ModernOpenGLGraphics() :
     mProgram(nullptr),
     mAlphaCached(1.0F),
     mVpCached(0),
+    mImageCached(0U),
     mFloatColor(1.0F),
     mMaxVertices(500),
     mProgramId(0U),
     mSimpleColorUniform(0U),
     mPosAttrib(0),
     mTextureColorUniform(0U),
+    mImageColorUniform(0U),
     mScreenUniform(0U),
     mDrawTypeUniform(0U),
+    mTranslateUniform(0U),
     mVao(0U),
     mVbo(0U),
     mEbo(0U),
     mVboBinded(0U),
     mEboBinded(0U),
     mAttributesBinded(0U),
+    mImageColor(255, 255, 255),
     mColorAlpha(false),
     mTextureDraw(false),
 #ifdef DEBUG_BIND_TEXTURE
@@ -185,9 +189,13 @@ void ModernOpenGLGraphics::postInit()
     mSimpleColorUniform = mglGetUniformLocation(mProgramId, "color");
     mScreenUniform = mglGetUniformLocation(mProgramId, "screen");
     mDrawTypeUniform = mglGetUniformLocation(mProgramId, "drawType");
+    mTranslateUniform = mglGetUniformLocation(mProgramId, "translate");
     mTextureColorUniform = mglGetUniformLocation(mProgramId, "alpha");
+    mImageColorUniform = mglGetUniformLocation(mProgramId, "imageColor");
 
     mglUniform1f(mTextureColorUniform, 1.0f);
+    mglUniform3f(mImageColorUniform, 1.0f, 1.0f, 1.0f);
+    mglUniform2f(mTranslateUniform, 0.0f, 0.0f);
 
     mglBindVertexBuffer(0, mVbo, 0, 4 * sizeof(GLint));
     mglVertexAttribBinding(mPosAttrib, 0);
@@ -201,6 +209,7 @@ void ModernOpenGLGraphics::postInit()
 
 void ModernOpenGLGraphics::screenResized()
 {
+    completeCache();
     deleteGLObjects();
     mVboBinded = 0U;
     mEboBinded = 0U;
@@ -257,38 +266,25 @@ void ModernOpenGLGraphics::setColorAll(const Color &color,
 
 void ModernOpenGLGraphics::setColorAlpha(const float alpha)
 {
-    if (mAlphaCached != alpha)
+    if (mFloatColor != alpha)
     {
-        mAlphaCached = alpha;
+        mFloatColor = alpha;
         mglUniform1f(mTextureColorUniform, alpha);
     }
 }
 
-void ModernOpenGLGraphics::drawQuad(const Image *const image A_UNUSED,
-                                    const int srcX, const int srcY,
-                                    const int dstX, const int dstY,
-                                    const int width, const int height)
+void ModernOpenGLGraphics::setImageColor(const Color &color)
 {
-    const int texX2 = srcX + width;
-    const int texY2 = srcY + height;
-    const int x2 = dstX + width;
-    const int y2 = dstY + height;
-
-    GLint vertices[] =
-    {
-        dstX, dstY, srcX, srcY,
-        x2, dstY, texX2, srcY,
-        dstX, y2, srcX, texY2,
-        x2, y2, texX2, texY2
-    };
+    if (mImageColor == color)
+        return;
 
-//    logger->log("allocate: %d, %ld", mVboBinded, sizeof(vertices));
-    mglBufferData(GL_ARRAY_BUFFER, sizeof(vertices),
-        vertices, GL_STREAM_DRAW);
-#ifdef DEBUG_DRAW_CALLS
-    mDrawCalls ++;
-#endif
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    // images with other color can not be in same draw call
+    completeCache();
+    mImageColor = color;
+    mglUniform3f(mImageColorUniform,
+        static_cast<float>(color.r) / 255.0F,
+        static_cast<float>(color.g) / 255.0F,
+        static_cast<float>(color.b) / 255.0F);
 }
 
 void ModernOpenGLGraphics::drawRescaledQuad(const Image *const image A_UNUSED,
@@ -333,20 +329,38 @@ void ModernOpenGLGraphics::drawImageInline(const Image *const image,
     if (!image)
         return;
 
+    // consecutive images with same texture and alpha merged in one draw call
+    if (image->mGLImage != mImageCached || image->mAlpha != mAlphaCached)
+    {
+        completeCache();
 #ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
+        debugBindTexture(image);
 #endif
-    bindTexture(GL_TEXTURE_2D, image->mGLImage);
-    setTexturingAndBlending(true);
-    bindArrayBufferAndAttributes(mVbo);
-    setColorAlpha(image->mAlpha);
+        mImageCached = image->mGLImage;
+        mAlphaCached = image->mAlpha;
+    }
 
-    const ClipRect &clipArea = mClipStack.top();
     const SDL_Rect &imageRect = image->mBounds;
-    drawQuad(nullptr,
-        imageRect.x, imageRect.y,
-        dstX + clipArea.xOffset, dstY + clipArea.yOffset,
-        imageRect.w, imageRect.h);
+    const int w = imageRect.w;
+    const int h = imageRect.h;
+
+    if (w == 0 || h == 0)
+        return;
+
+    const ClipRect &clipArea = mClipStack.top();
+    const int srcX = imageRect.x;
+    const int srcY = imageRect.y;
+    const int x2 = dstX + clipArea.xOffset;
+    const int y2 = dstY + clipArea.yOffset;
+    const unsigned int vp = mVpCached;
+
+    vertFill2D(mIntArrayCached,
+        srcX, srcY, srcX + w, srcY + h,
+        x2, y2, w, h);
+
+    mVpCached = vp + 24;
+    if (mVpCached >= mMaxVertices * 4)
+        completeCache();
 }
 
 void ModernOpenGLGraphics::copyImage(const Image *const image,
@@ -379,21 +393,31 @@ void ModernOpenGLGraphics::testDraw()
 //    glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_INT, 0);
 }
 
-void ModernOpenGLGraphics::drawImageCached(const Image *const image A_UNUSED,
-                                           int A_UNUSED x, int y A_UNUSED)
+void ModernOpenGLGraphics::drawImageCached(const Image *const image,
+                                           int x, int y)
 {
+    drawImageInline(image, x, y);
 }
 
-void ModernOpenGLGraphics::drawPatternCached(const Image *const image A_UNUSED,
-                                             const int x A_UNUSED,
-                                             const int y A_UNUSED,
-                                             const int w A_UNUSED,
-                                             const int h A_UNUSED)
+void ModernOpenGLGraphics::drawPatternCached(const Image *const image,
+                                             const int x, const int y,
+                                             const int w, const int h)
 {
+    drawPatternInline(image, x, y, w, h);
 }
 
 void ModernOpenGLGraphics::completeCache()
 {
+    if (!mVpCached)
+        return;
+
+    bindTexture(OpenGLImageHelper::mTextureType, mImageCached);
+    setTexturingAndBlending(true);
+    bindArrayBufferAndAttributes(mVbo);
+    setColorAlpha(mAlphaCached);
+
+    drawTriangleArray(mIntArrayCached, mVpCached);
+    mVpCached = 0;
 }
 
 void ModernOpenGLGraphics::drawRescaledImage(const Image *const image,
@@ -413,6 +437,7 @@ void ModernOpenGLGraphics::drawRescaledImage(const Image *const image,
         return;
     }
 
+    completeCache();
     setColorAlpha(image->mAlpha);
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
@@ -457,16 +482,17 @@ void ModernOpenGLGraphics::drawPatternInline(const Image *const image,
     const int x2 = x + clipArea.xOffset;
     const int y2 = y + clipArea.yOffset;
 
+    if (image->mGLImage != mImageCached || image->mAlpha != mAlphaCached)
+    {
+        completeCache();
 #ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
+        debugBindTexture(image);
 #endif
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
-
-    setTexturingAndBlending(true);
-    bindArrayBufferAndAttributes(mVbo);
-    setColorAlpha(image->mAlpha);
+        mImageCached = image->mGLImage;
+        mAlphaCached = image->mAlpha;
+    }
 
-    unsigned int vp = 0;
+    unsigned int vp = mVpCached;
     const unsigned int vLimit = mMaxVertices * 4;
 
     for (int py = 0; py < h; py += ih)
@@ -481,20 +507,20 @@ void ModernOpenGLGraphics::drawPatternInline(const Image *const image,
 
             const int texX2 = srcX + width;
 
-            vertFill2D(mIntArray,
+            vertFill2D(mIntArrayCached,
                 srcX, srcY, texX2, texY2,
                 dstX, dstY, width, height);
 
             vp += 24;
             if (vp >= vLimit)
             {
-                drawTriangleArray(vp);
+                mVpCached = vp;
+                completeCache();
                 vp = 0;
             }
         }
     }
-    if (vp > 0)
-        drawTriangleArray(vp);
+    mVpCached = vp;
 }
 
 void ModernOpenGLGraphics::drawRescaledPattern(const Image *const image,
@@ -517,6 +543,7 @@ void ModernOpenGLGraphics::drawRescaledPattern(const Image *const image,
     if (iw == 0 || ih == 0)
         return;
 
+    completeCache();
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
 #endif
@@ -677,6 +704,7 @@ void ModernOpenGLGraphics::calcTileCollection(ImageCollection *const vertCol,
 void ModernOpenGLGraphics::drawTileCollection(const ImageCollection
                                               *const vertCol)
 {
+    completeCache();
     setTexturingAndBlending(true);
 /*
     if (!vertCol)
@@ -780,6 +808,7 @@ void ModernOpenGLGraphics::drawTileVertexes(const ImageVertexes *const vert)
 {
     if (!vert)
         return;
+    completeCache();
     const Image *const image = vert->image;
 
     setColorAlpha(image->mAlpha);
@@ -793,6 +822,29 @@ void ModernOpenGLGraphics::drawTileVertexes(const ImageVertexes *const vert)
     drawVertexes(vert->ogl);
 }
 
+void ModernOpenGLGraphics::drawStaticVertexes(const ImageVertexes *const vert,
+                                              const int dx, const int dy)
+{
+    if (!vert)
+        return;
+    completeCache();
+    const Image *const image = vert->image;
+
+    setColorAlpha(image->mAlpha);
+#ifdef DEBUG_BIND_TEXTURE
+    debugBindTexture(image);
+#endif
+    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
+    setTexturingAndBlending(true);
+
+    const ClipRect &clipArea = mClipStack.top();
+    mglUniform2f(mTranslateUniform,
+        static_cast<float>(dx + clipArea.xOffset),
+        static_cast<float>(dy + clipArea.yOffset));
+    drawVertexes(vert->ogl);
+    mglUniform2f(mTranslateUniform, 0.0f, 0.0f);
+}
+
 void ModernOpenGLGraphics::calcWindow(ImageCollection *const vertCol,
                                       const int x, const int y,
                                       const int w, const int h,
@@ -818,6 +870,7 @@ void ModernOpenGLGraphics::calcWindow(ImageCollection *const vertCol,
 void ModernOpenGLGraphics::updateScreen()
 {
     BLOCK_START("Graphics::updateScreen")
+    completeCache();
 #ifdef DEBUG_DRAW_CALLS
     mLastDrawCalls = mDrawCalls;
     mDrawCalls = 0;
@@ -857,6 +910,7 @@ void ModernOpenGLGraphics::prepareScreenshot()
 
 SDL_Surface* ModernOpenGLGraphics::getScreenshot()
 {
+    completeCache();
     const int h = mRect.h;
     const int w = mRect.w - (mRect.w % 4);
     GLint pack = 1;
@@ -908,6 +962,7 @@ SDL_Surface* ModernOpenGLGraphics::getScreenshot()
 
 void ModernOpenGLGraphics::pushClipArea(const Rect &area)
 {
+    completeCache();
     Graphics::pushClipArea(area);
     const ClipRect &clipArea = mClipStack.top();
 
@@ -919,6 +974,7 @@ void ModernOpenGLGraphics::pushClipArea(const Rect &area)
 
 void ModernOpenGLGraphics::popClipArea()
 {
+    completeCache();
     if (mClipStack.empty())
         return;
     Graphics::popClipArea();
@@ -934,6 +990,7 @@ void ModernOpenGLGraphics::popClipArea()
 
 void ModernOpenGLGraphics::drawPoint(int x, int y)
 {
+    completeCache();
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -952,6 +1009,7 @@ void ModernOpenGLGraphics::drawPoint(int x, int y)
 
 void ModernOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    completeCache();
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -971,6 +1029,7 @@ void ModernOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 
 void ModernOpenGLGraphics::drawRectangle(const Rect& rect)
 {
+    completeCache();
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -997,6 +1056,7 @@ void ModernOpenGLGraphics::drawRectangle(const Rect& rect)
 
 void ModernOpenGLGraphics::fillRectangle(const Rect& rect)
 {
+    completeCache();
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -1065,6 +1125,8 @@ void ModernOpenGLGraphics::drawNet(const int x1, const int y1,
                                    const int x2, const int y2,
                                    const int width, const int height)
 {
+    completeCache();
+
     unsigned int vp = 0;
     const unsigned int vLimit = mMaxVertices * 4;
 
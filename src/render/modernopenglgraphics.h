@@ -74,20 +74,20 @@ class ModernOpenGLGraphics final : public Graphics
 
         virtual void createGLContext() override final;
 
+        void drawStaticVertexes(const ImageVertexes *const vert,
+                                const int dx, const int dy) override final;
+
         #include "render/graphicsdef.hpp"
 
         #include "render/openglgraphicsdef.hpp"
 
         #include "render/openglgraphicsdefadvanced.hpp"
 
+        void setImageColor(const Color &color) override final;
+
     private:
         void deleteGLObjects();
 
-        inline void drawQuad(const Image *const image,
-                             const int srcX, const int srcY,
-                             const int dstX, const int dstY,
-                             const int width, const int height);
-
         inline void drawRescaledQuad(const Image *const image,
                                      const int srcX, const int srcY,
                                      const int dstX, const int dstY,
@@ -115,6 +115,7 @@ class ModernOpenGLGraphics final : public Graphics
         ShaderProgram *mProgram;
         float mAlphaCached;
         int mVpCached;
+        GLuint mImageCached;
 
         float mFloatColor;
         int mMaxVertices;
@@ -122,14 +123,17 @@ class ModernOpenGLGraphics final : public Graphics
         GLuint mSimpleColorUniform;
         GLint mPosAttrib;
         GLint mTextureColorUniform;
+        GLint mImageColorUniform;
         GLuint mScreenUniform;
         GLuint mDrawTypeUniform;
+        GLuint mTranslateUniform;
         GLuint mVao;
         GLuint mVbo;
         GLuint mEbo;
         GLuint mVboBinded;
         GLuint mEboBinded;
         GLuint mAttributesBinded;
+        Color mImageColor;
         bool mColorAlpha;
         bool mTextureDraw;
 #ifdef DEBUG_BIND_TEXTURE
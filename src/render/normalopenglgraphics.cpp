@@ -103,6 +103,7 @@ NormalOpenGLGraphics::NormalOpenGLGraphics() :
     mTexture(false),
     mIsByteColor(false),
     mByteColor(),
+    mImageColor(255, 255, 255),
     mImageCached(0),
     mFloatColor(1.0F),
     mMaxVertices(500),
@@ -203,68 +204,6 @@ static inline void bindPointerInt(const GLint *const vert,
     }
 }
 
-static inline void drawQuad(const Image *const image,
-                            const int srcX, const int srcY,
-                            const int dstX, const int dstY,
-                            const int width, const int height)
-{
-    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
-    {
-        const float tw = static_cast<float>(image->mTexWidth);
-        const float th = static_cast<float>(image->mTexHeight);
-        // Find OpenGL normalized texture coordinates.
-        const float texX1 = static_cast<float>(srcX) / tw;
-        const float texY1 = static_cast<float>(srcY) / th;
-        const float texX2 = static_cast<float>(srcX + width) / tw;
-        const float texY2 = static_cast<float>(srcY + height) / th;
-
-        GLfloat tex[] =
-        {
-            texX1, texY1,
-            texX2, texY1,
-            texX2, texY2,
-            texX1, texY2
-        };
-
-        GLint vert[] =
-        {
-            dstX, dstY,
-            dstX + width, dstY,
-            dstX + width, dstY + height,
-            dstX, dstY + height
-        };
-
-        bindPointerIntFloat(&vert[0], &tex[0]);
-#ifdef DEBUG_DRAW_CALLS
-        NormalOpenGLGraphics::mDrawCalls ++;
-#endif
-        glDrawArrays(GL_QUADS, 0, 4);
-    }
-    else
-    {
-        GLint tex[] =
-        {
-            srcX, srcY,
-            srcX + width, srcY,
-            srcX + width, srcY + height,
-            srcX, srcY + height
-        };
-        GLint vert[] =
-        {
-            dstX, dstY,
-            dstX + width, dstY,
-            dstX + width, dstY + height,
-            dstX, dstY + height
-        };
-
-        bindPointerInt(&vert[0], &tex[0]);
-#ifdef DEBUG_DRAW_CALLS
-        NormalOpenGLGraphics::mDrawCalls ++;
-#endif
-        glDrawArrays(GL_QUADS, 0, 4);
-    }
-}
-
 static inline void drawRescaledQuad(const Image *const image,
                                     const int srcX, const int srcY,
                                     const int dstX, const int dstY,
@@ -342,16 +281,50 @@ void NormalOpenGLGraphics::drawImageInline(const Image *const image,
     if (!image)
         return;
 
-    setColorAlpha(image->mAlpha);
+    // consecutive images with same texture and alpha merged in one draw call
+    if (image->mGLImage != mImageCached || image->mAlpha != mAlphaCached)
+    {
+        completeCache();
 #ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
+        debugBindTexture(image);
 #endif
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
-    setTexturingAndBlending(true);
+        mImageCached = image->mGLImage;
+        mAlphaCached = image->mAlpha;
+    }
 
     const SDL_Rect &imageRect = image->mBounds;
-    drawQuad(image, imageRect.x, imageRect.y,
-        dstX, dstY, imageRect.w, imageRect.h);
+    const int w = imageRect.w;
+    const int h = imageRect.h;
+
+    if (w == 0 || h == 0)
+        return;
+
+    const int srcX = imageRect.x;
+    const int srcY = imageRect.y;
+    const unsigned int vp = mVpCached;
+
+    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
+    {
+        const float tw = static_cast<float>(image->mTexWidth);
+        const float th = static_cast<float>(image->mTexHeight);
+        const float texX1 = static_cast<float>(srcX) / tw;
+        const float texY1 = static_cast<float>(srcY) / th;
+        const float texX2 = static_cast<float>(srcX + w) / tw;
+        const float texY2 = static_cast<float>(srcY + h) / th;
+
+        vertFill2D(mFloatTexArrayCached, mIntVertArrayCached,
+            texX1, texY1, texX2, texY2,
+            dstX, dstY, w, h);
+    }
+    else
+    {
+        vertFillNv(mIntTexArrayCached, mIntVertArrayCached,
+            srcX, srcY, dstX, dstY, w, h);
+    }
+
+    mVpCached = vp + 8;
+    if (mVpCached >= mMaxVertices * 4)
+        completeCache();
 }
 
 void NormalOpenGLGraphics::copyImage(const Image *const image,
@@ -415,169 +388,22 @@ void NormalOpenGLGraphics::testDraw()
 void NormalOpenGLGraphics::drawImageCached(const Image *const image,
                                            int x, int y)
 {
-    if (!image)
-        return;
-
-    if (image->mGLImage != mImageCached)
-    {
-        completeCache();
-        mImageCached = image->mGLImage;
-        mAlphaCached = image->mAlpha;
-    }
-
-    const SDL_Rect &imageRect = image->mBounds;
-    const int w = imageRect.w;
-    const int h = imageRect.h;
-
-    if (w == 0 || h == 0)
-        return;
-
-    const int srcX = imageRect.x;
-    const int srcY = imageRect.y;
-
-    const float tw = static_cast<float>(image->mTexWidth);
-    const float th = static_cast<float>(image->mTexHeight);
-
-    const unsigned int vLimit = mMaxVertices * 4;
-
-    unsigned int vp = mVpCached;
-
-    // Draw a set of textured rectangles
-    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
-    {
-        const float texX1 = static_cast<float>(srcX) / tw;
-        const float texY1 = static_cast<float>(srcY) / th;
-
-        const float texX2 = static_cast<float>(srcX + w) / tw;
-        const float texY2 = static_cast<float>(srcY + h) / th;
-
-        vertFill2D(mFloatTexArrayCached, mIntVertArrayCached,
-            texX1, texY1, texX2, texY2,
-            x, y, w, h);
-
-        vp += 8;
-        if (vp >= vLimit)
-        {
-            completeCache();
-            vp = 0;
-        }
-        else
-        {
-            mVpCached = vp;
-        }
-    }
-    else
-    {
-        vertFillNv(mIntTexArrayCached, mIntVertArrayCached,
-            srcX, srcY, x, y, w, h);
-
-        vp += 8;
-        if (vp >= vLimit)
-        {
-            completeCache();
-            vp = 0;
-        }
-        else
-        {
-            mVpCached = vp;
-        }
-    }
+    drawImageInline(image, x, y);
 }
 
 void NormalOpenGLGraphics::drawPatternCached(const Image *const image,
                                              const int x, const int y,
                                              const int w, const int h)
 {
-    FUNC_BLOCK("Graphics::drawPatternCached", 1)
-    if (!image)
-        return;
-
-    if (image->mGLImage != mImageCached)
-    {
-        completeCache();
-        mImageCached = image->mGLImage;
-    }
-
-    const SDL_Rect &imageRect = image->mBounds;
-    const int srcX = imageRect.x;
-    const int srcY = imageRect.y;
-    const int iw = imageRect.w;
-    const int ih = imageRect.h;
-
-    if (iw == 0 || ih == 0)
-        return;
-
-    const float tw = static_cast<float>(image->mTexWidth);
-    const float th = static_cast<float>(image->mTexHeight);
-
-    unsigned int vp = mVpCached;
-    const unsigned int vLimit = mMaxVertices * 4;
-    // Draw a set of textured rectangles
-    if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
-    {
-        const float texX1 = static_cast<float>(srcX) / tw;
-        const float texY1 = static_cast<float>(srcY) / th;
-
-        for (int py = 0; py < h; py += ih)
-        {
-            const int height = (py + ih >= h) ? h - py : ih;
-            const int dstY = y + py;
-            const float texY2 = static_cast<float>(srcY + height) / th;
-            for (int px = 0; px < w; px += iw)
-            {
-                const int width = (px + iw >= w) ? w - px : iw;
-                const int dstX = x + px;
-
-                const float texX2 = static_cast<float>(srcX + width) / tw;
-
-                vertFill2D(mFloatTexArrayCached, mIntVertArrayCached,
-                    texX1, texY1, texX2, texY2,
-                    dstX, dstY, width, height);
-
-                vp += 8;
-                if (vp >= vLimit)
-                {
-                    completeCache();
-                    vp = 0;
-                }
-            }
-        }
-    }
-    else
-    {
-        for (int py = 0; py < h; py += ih)
-        {
-            const int height = (py + ih >= h) ? h - py : ih;
-            const int dstY = y + py;
-            for (int px = 0; px < w; px += iw)
-            {
-                const int width = (px + iw >= w) ? w - px : iw;
-                const int dstX = x + px;
-
-                vertFillNv(mIntTexArrayCached, mIntVertArrayCached,
-                    srcX, srcY, dstX, dstY, width, height);
-
-                vp += 8;
-                if (vp >= vLimit)
-                {
-                    completeCache();
-                    vp = 0;
-                }
-            }
-        }
-    }
-    mVpCached = vp;
+    drawPatternInline(image, x, y, w, h);
 }
 
 void NormalOpenGLGraphics::completeCache()
 {
-    if (!mImageCached)
+    if (!mVpCached)
         return;
 
     setColorAlpha(mAlphaCached);
-#ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
-#endif
     bindTexture(OpenGLImageHelper::mTextureType, mImageCached);
     setTexturingAndBlending(true);
 
@@ -586,7 +412,6 @@ void NormalOpenGLGraphics::completeCache()
     else
         drawQuadArrayiiCached(mVpCached);
 
-    mImageCached = 0;
     mVpCached = 0;
 }
 
@@ -608,6 +433,7 @@ void NormalOpenGLGraphics::drawRescaledImage(const Image *const image,
         return;
     }
 
+    completeCache();
     setColorAlpha(image->mAlpha);
 #ifdef DEBUG_BIND_TEXTURE
     debugBindTexture(image);
@@ -644,19 +470,20 @@ void NormalOpenGLGraphics::drawPatternInline(const Image *const image,
     if (iw == 0 || ih == 0)
         return;
 
-    const float tw = static_cast<float>(image->mTexWidth);
-    const float th = static_cast<float>(image->mTexHeight);
-
-    setColorAlpha(image->mAlpha);
-
+    if (image->mGLImage != mImageCached || image->mAlpha != mAlphaCached)
+    {
+        completeCache();
 #ifdef DEBUG_BIND_TEXTURE
-    debugBindTexture(image);
+        debugBindTexture(image);
 #endif
-    bindTexture(OpenGLImageHelper::mTextureType, image->mGLImage);
+        mImageCached = image->mGLImage;
+        mAlphaCached = image->mAlpha;
+    }
 
-    setTexturingAndBlending(true);
+    const float tw = static_cast<float>(image->mTexWidth);
+    const float th = static_cast<float>(image->mTexHeight);
 
-    unsigned int vp = 0;
+    unsigned int vp = mVpCached;
     const unsigned int vLimit = mMaxVertices * 4;
     // Draw a set of textured rectangles
     if (OpenGLImageHelper::mTextureType == GL_TEXTURE_2D)
@@ -675,20 +502,19 @@ void NormalOpenGLGraphics::drawPatternInline(const Image *const image,
                 const int dstX = x + px;
                 const float texX2 = static_cast<float>(srcX + width) / tw;
 
-                vertFill2D(mFloatTexArray, mIntVertArray,
+                vertFill2D(mFloatTexArrayCached, mIntVertArrayCached,
                     texX1, texY1, texX2, texY2,
                     dstX, dstY, width, height);
 
                 vp += 8;
                 if (vp >= vLimit)
                 {
-                    drawQuadArrayfi(vp);
+                    mVpCached = vp;
+                    completeCache();
                     vp = 0;
                 }
             }
         }
-        if (vp > 0)
-            drawQuadArrayfi(vp);
     }
     else
     {
@@ -701,20 +527,20 @@ void NormalOpenGLGraphics::drawPatternInline(const Image *const image,
                 const int width = (px + iw >= w) ? w - px : iw;
                 const int dstX = x + px;
 
-                vertFillNv(mIntTexArray, mIntVertArray,
+                vertFillNv(mIntTexArrayCached, mIntVertArrayCached,
                     srcX, srcY, dstX, dstY, width, height);
 
                 vp += 8;
                 if (vp >= vLimit)
                 {
-                    drawQuadArrayii(vp);
+                    mVpCached = vp;
+                    completeCache();
                     vp = 0;
                 }
             }
         }
-        if (vp > 0)
-            drawQuadArrayii(vp);
     }
+    mVpCached = vp;
 }
 
 void NormalOpenGLGraphics::drawRescaledPattern(const Image *const image,
@@ -738,6 +564,7 @@ void NormalOpenGLGraphics::drawRescaledPattern(const Image *const image,
     const int srcX = imageRect.x;
     const int srcY = imageRect.y;
 
+    completeCache();
     setColorAlpha(image->mAlpha);
 
 #ifdef DEBUG_BIND_TEXTURE
@@ -1013,6 +840,7 @@ void NormalOpenGLGraphics::calcTileCollection(ImageCollection *const vertCol,
 void NormalOpenGLGraphics::drawTileCollection(const ImageCollection
                                               *const vertCol)
 {
+    completeCache();
     const ImageVertexesVector &draws = vertCol->draws;
     const ImageCollectionCIter it_end = draws.end();
     for (ImageCollectionCIter it = draws.begin(); it != it_end; ++ it)
@@ -1135,6 +963,7 @@ void NormalOpenGLGraphics::drawTileVertexes(const ImageVertexes *const vert)
 {
     if (!vert)
         return;
+    completeCache();
     const Image *const image = vert->image;
 
     setColorAlpha(image->mAlpha);
@@ -1173,6 +1002,7 @@ void NormalOpenGLGraphics::calcWindow(ImageCollection *const vertCol,
 void NormalOpenGLGraphics::updateScreen()
 {
     BLOCK_START("Graphics::updateScreen")
+    completeCache();
 //    glFlush();
 //    glFinish();
 #ifdef DEBUG_DRAW_CALLS
@@ -1256,6 +1086,7 @@ void NormalOpenGLGraphics::prepareScreenshot()
 
 SDL_Surface* NormalOpenGLGraphics::getScreenshot()
 {
+    completeCache();
     const int h = mRect.h;
     const int w = mRect.w - (mRect.w % 4);
     GLint pack = 1;
@@ -1308,6 +1139,8 @@ SDL_Surface* NormalOpenGLGraphics::getScreenshot()
 
 void NormalOpenGLGraphics::pushClipArea(const Rect &area)
 {
+    completeCache();
+
     int transX = 0;
     int transY = 0;
 
@@ -1337,6 +1170,8 @@ void NormalOpenGLGraphics::pushClipArea(const Rect &area)
 
 void NormalOpenGLGraphics::popClipArea()
 {
+    completeCache();
+
     if (mClipStack.empty())
         return;
 
@@ -1365,6 +1200,7 @@ void NormalOpenGLGraphics::popClipArea()
 
 void NormalOpenGLGraphics::drawPoint(int x, int y)
 {
+    completeCache();
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1379,6 +1215,7 @@ void NormalOpenGLGraphics::drawPoint(int x, int y)
 
 void NormalOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    completeCache();
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1444,6 +1281,7 @@ void NormalOpenGLGraphics::drawRectangle(const Rect& rect,
                                          const bool filled)
 {
     BLOCK_START("Graphics::drawRectangle")
+    completeCache();
     const float offset = filled ? 0 : 0.5F;
     const float x = static_cast<float>(rect.x);
     const float y = static_cast<float>(rect.y);
@@ -1474,6 +1312,8 @@ void NormalOpenGLGraphics::drawNet(const int x1, const int y1,
                                    const int x2, const int y2,
                                    const int width, const int height)
 {
+    completeCache();
+
     unsigned int vp = 0;
     const unsigned int vLimit = mMaxVertices * 4;
 
@@ -1645,11 +1485,26 @@ void NormalOpenGLGraphics::setColorAlpha(const float alpha)
     if (!mIsByteColor && mFloatColor == alpha)
         return;
 
-    glColor4f(1.0F, 1.0F, 1.0F, alpha);
+    glColor4f(static_cast<float>(mImageColor.r) / 255.0F,
+        static_cast<float>(mImageColor.g) / 255.0F,
+        static_cast<float>(mImageColor.b) / 255.0F,
+        alpha);
     mIsByteColor = false;
     mFloatColor = alpha;
 }
 
+void NormalOpenGLGraphics::setImageColor(const Color &color)
+{
+    if (mImageColor == color)
+        return;
+
+    // images with other color can not be in same draw call
+    completeCache();
+    mImageColor = color;
+    // force color update in next setColorAlpha
+    mFloatColor = -1.0F;
+}
+
 void NormalOpenGLGraphics::restoreColor()
 {
     if (mIsByteColor && mByteColor == mColor)
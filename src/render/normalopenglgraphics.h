@@ -83,6 +83,8 @@ class NormalOpenGLGraphics final : public Graphics
 
         #include "render/openglgraphicsdefadvanced.hpp"
 
+        void setImageColor(const Color &color) override final;
+
 #ifdef DEBUG_BIND_TEXTURE
         unsigned int getBinds() const
         { return mLastBinds; }
@@ -101,6 +103,7 @@ class NormalOpenGLGraphics final : public Graphics
 
         bool mIsByteColor;
         Color mByteColor;
+        Color mImageColor;
         GLuint mImageCached;
         float mFloatColor;
         int mMaxVertices;
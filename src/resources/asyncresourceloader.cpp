@@ -0,0 +1,302 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/asyncresourceloader.h"
+
+#include "configuration.h"
+#include "logger.h"
+
+#include "resources/dye.h"
+#include "resources/imagehelper.h"
+
+#include "utils/delete2.h"
+#include "utils/physfsrwops.h"
+#include "utils/physfstools.h"
+#include "utils/sdlcheckutils.h"
+#include "utils/sdlhelper.h"
+#include "utils/xml.h"
+
+#include <algorithm>
+
+#include "debug.h"
+
+AsyncResourceLoader *asyncResourceLoader = nullptr;
+
+int resourceLoaderThread(void *data)
+{
+    AsyncResourceLoader *const loader
+        = static_cast<AsyncResourceLoader*>(data);
+    if (!loader)
+        return -1;
+
+    loader->run();
+    return 0;
+}
+
+AsyncResourceLoader::AsyncResourceLoader() :
+    mJobs(),
+    mDocuments(),
+    mSurfaces(),
+    mSpritesPath(paths.getStringValue("sprites")),
+    mCurrentJob(),
+    mThread(nullptr),
+    mMutex(SDL_CreateMutex()),
+    mCondition(SDL_CreateCond()),
+    mRunning(true)
+{
+    mThread = SDL::createThread(&resourceLoaderThread, "resourceloader", this);
+    if (!mThread)
+        logger->log1("Unable to create resource loader thread");
+}
+
+AsyncResourceLoader::~AsyncResourceLoader()
+{
+    if (mThread)
+    {
+        SDL_mutexP(mMutex);
+        mRunning = false;
+        mJobs.clear();
+        SDL_CondSignal(mCondition);
+        SDL_mutexV(mMutex);
+        SDL_WaitThread(mThread, nullptr);
+        mThread = nullptr;
+    }
+    clearResults();
+    SDL_DestroyCond(mCondition);
+    mCondition = nullptr;
+    SDL_DestroyMutex(mMutex);
+    mMutex = nullptr;
+}
+
+void AsyncResourceLoader::addSprite(const std::string &fileName)
+{
+    if (!mThread)
+        return;
+
+    SDL_mutexP(mMutex);
+    if (fileName != mCurrentJob
+        && std::find(mJobs.begin(), mJobs.end(), fileName) == mJobs.end())
+    {
+        mJobs.push_back(fileName);
+        SDL_CondSignal(mCondition);
+    }
+    SDL_mutexV(mMutex);
+}
+
+bool AsyncResourceLoader::isLoaded(const std::string &fileName) const
+{
+    SDL_mutexP(mMutex);
+    const bool loaded = fileName != mCurrentJob
+        && std::find(mJobs.begin(), mJobs.end(), fileName) == mJobs.end();
+    SDL_mutexV(mMutex);
+    return loaded;
+}
+
+XML::Document *AsyncResourceLoader::takeDocument(const std::string &fileName)
+{
+    XML::Document *doc = nullptr;
+    SDL_mutexP(mMutex);
+    const DocumentsIter it = mDocuments.find(fileName);
+    if (it != mDocuments.end())
+    {
+        doc = (*it).second;
+        mDocuments.erase(it);
+    }
+    SDL_mutexV(mMutex);
+    return doc;
+}
+
+SDL_Surface *AsyncResourceLoader::takeSurface(const std::string &idPath)
+{
+    SDL_Surface *surface = nullptr;
+    SDL_mutexP(mMutex);
+    const SurfacesIter it = mSurfaces.find(idPath);
+    if (it != mSurfaces.end())
+    {
+        surface = (*it).second;
+        mSurfaces.erase(it);
+    }
+    SDL_mutexV(mMutex);
+    return surface;
+}
+
+void AsyncResourceLoader::clearResults()
+{
+    SDL_mutexP(mMutex);
+    FOR_EACH (DocumentsIter, it, mDocuments)
+        delete (*it).second;
+    mDocuments.clear();
+    FOR_EACH (SurfacesIter, it, mSurfaces)
+        MSDL_FreeSurface((*it).second);
+    mSurfaces.clear();
+    SDL_mutexV(mMutex);
+}
+
+void AsyncResourceLoader::run()
+{
+    SDL_mutexP(mMutex);
+    while (mRunning)
+    {
+        if (mJobs.empty())
+        {
+            SDL_CondWait(mCondition, mMutex);
+            continue;
+        }
+
+        mCurrentJob = mJobs.front();
+        mJobs.pop_front();
+        SDL_mutexV(mMutex);
+
+        const size_t pos = mCurrentJob.find('|');
+        std::string palettes;
+        if (pos != std::string::npos)
+            palettes = mCurrentJob.substr(pos + 1);
+        std::set<std::string> processedFiles;
+        loadSprite(mCurrentJob.substr(0, pos), palettes, processedFiles);
+
+        SDL_mutexP(mMutex);
+        mCurrentJob.clear();
+    }
+    SDL_mutexV(mMutex);
+}
+
+void AsyncResourceLoader::loadSprite(const std::string &fileName,
+                                     const std::string &palettes,
+                                     std::set<std::string> &processedFiles)
+{
+    if (processedFiles.find(fileName) != processedFiles.end())
+        return;
+    processedFiles.insert(fileName);
+
+    SDL_mutexP(mMutex);
+    const bool loaded = mDocuments.find(fileName) != mDocuments.end();
+    SDL_mutexV(mMutex);
+    if (loaded)
+        return;
+
+    XML::Document *const doc = loadDocument(fileName);
+    if (!doc)
+        return;
+
+    const XmlNodePtr rootNode = doc->rootNode();
+    if (rootNode && xmlNameEqual(rootNode, "sprite"))
+    {
+        for_each_xml_child_node(node, rootNode)
+        {
+            if (xmlNameEqual(node, "imageset"))
+            {
+                std::string imageSrc = XML::getProperty(node, "src", "");
+                Dye::instantiate(imageSrc, palettes);
+                loadImage(imageSrc);
+            }
+            else if (xmlNameEqual(node, "include"))
+            {
+                const std::string file = XML::getProperty(node, "file", "");
+                // SpriteDef loads included sprites without palettes
+                if (!file.empty())
+                {
+                    loadSprite(std::string(mSpritesPath).append(file),
+                        std::string(), processedFiles);
+                }
+            }
+        }
+    }
+
+    SDL_mutexP(mMutex);
+    Documents::iterator it = mDocuments.find(fileName);
+    if (it == mDocuments.end())
+        mDocuments[fileName] = doc;
+    else
+        delete doc;
+    SDL_mutexV(mMutex);
+}
+
+void AsyncResourceLoader::loadImage(const std::string &idPath)
+{
+    if (idPath.empty() || !imageHelper)
+        return;
+
+    SDL_mutexP(mMutex);
+    const bool loaded = mSurfaces.find(idPath) != mSurfaces.end();
+    SDL_mutexV(mMutex);
+    if (loaded)
+        return;
+
+    const size_t pos = idPath.find('|');
+    SDL_RWops *const rw = MPHYSFSRWOPS_openRead(
+        idPath.substr(0, pos).c_str());
+    if (!rw)
+        return;
+
+    SDL_Surface *surface = nullptr;
+    if (pos != std::string::npos)
+    {
+        const Dye dye(idPath.substr(pos + 1));
+        surface = imageHelper->loadCachedDyedSurface(rw, dye);
+    }
+    else
+    {
+        surface = ImageHelper::loadPng(rw);
+    }
+    if (!surface)
+        return;
+
+    SDL_mutexP(mMutex);
+    SurfacesIter it = mSurfaces.find(idPath);
+    if (it == mSurfaces.end())
+        mSurfaces[idPath] = surface;
+    else
+        MSDL_FreeSurface(surface);
+    SDL_mutexV(mMutex);
+}
+
+XML::Document *AsyncResourceLoader::loadDocument(const std::string &fileName)
+{
+    // PhysFs::loadFile logs from caller thread, so file read here
+    PHYSFS_file *const file = PhysFs::openRead(fileName.c_str());
+    if (!file)
+        return nullptr;
+
+    const int size = static_cast<int>(PHYSFS_fileLength(file));
+    if (size <= 0)
+    {
+        PHYSFS_close(file);
+        return nullptr;
+    }
+    char *const data = static_cast<char*>(calloc(size, 1));
+    if (!data)
+    {
+        PHYSFS_close(file);
+        return nullptr;
+    }
+    const PHYSFS_sint64 readSize = PHYSFS_read(file, data, 1, size);
+    PHYSFS_close(file);
+    if (readSize != size)
+    {
+        free(data);
+        return nullptr;
+    }
+
+    XML::Document *doc = new XML::Document(data, size);
+    free(data);
+    if (!doc->isLoaded())
+        delete2(doc);
+    return doc;
+}
@@ -0,0 +1,118 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_ASYNCRESOURCELOADER_H
+#define RESOURCES_ASYNCRESOURCELOADER_H
+
+#include <SDL_thread.h>
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+
+#include "localconsts.h"
+
+struct SDL_Surface;
+
+namespace XML
+{
+    class Document;
+}
+
+/**
+ * Prepares sprites in worker thread: reads and parses sprite xml files with
+ * includes, decodes and dyes images of sprite image sets. Prepared documents
+ * and surfaces are taken by SpriteDef and ResourceManager in main thread,
+ * so only texture upload left for main thread.
+ */
+class AsyncResourceLoader final
+{
+    public:
+        AsyncResourceLoader();
+
+        A_DELETE_COPY(AsyncResourceLoader)
+
+        ~AsyncResourceLoader();
+
+        /**
+         * Queues sprite file with optional palettes after '|'.
+         */
+        void addSprite(const std::string &fileName);
+
+        /**
+         * Returns true if sprite not waiting in queue and not processed
+         * by worker now.
+         */
+        bool isLoaded(const std::string &fileName) const A_WARN_UNUSED;
+
+        /**
+         * Returns prepared document or nullptr. Caller owns document.
+         */
+        XML::Document *takeDocument(const std::string &fileName)
+                                    A_WARN_UNUSED;
+
+        /**
+         * Returns prepared surface for image id path or nullptr. Caller
+         * must free surface.
+         */
+        SDL_Surface *takeSurface(const std::string &idPath) A_WARN_UNUSED;
+
+        /**
+         * Frees prepared data what nobody took.
+         */
+        void clearResults();
+
+    private:
+        friend int resourceLoaderThread(void *data);
+
+        typedef std::list<std::string> SpriteJobs;
+        typedef std::map<std::string, XML::Document*> Documents;
+        typedef Documents::iterator DocumentsIter;
+        typedef std::map<std::string, SDL_Surface*> Surfaces;
+        typedef Surfaces::iterator SurfacesIter;
+
+        void run();
+
+        void loadSprite(const std::string &fileName,
+                        const std::string &palettes,
+                        std::set<std::string> &processedFiles);
+
+        void loadImage(const std::string &idPath);
+
+        static XML::Document *loadDocument(const std::string &fileName)
+                                           A_WARN_UNUSED;
+
+        SpriteJobs mJobs;
+        Documents mDocuments;
+        Surfaces mSurfaces;
+        // sprites directory, copied for worker from paths config
+        std::string mSpritesPath;
+        // sprite processed by worker now
+        std::string mCurrentJob;
+        SDL_Thread *mThread;
+        SDL_mutex *mMutex;
+        SDL_cond *mCondition;
+        bool mRunning;
+};
+
+extern AsyncResourceLoader *asyncResourceLoader;
+
+#endif  // RESOURCES_ASYNCRESOURCELOADER_H
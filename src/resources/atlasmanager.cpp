@@ -22,16 +22,19 @@
 
 #include "resources/atlasmanager.h"
 
-#include "settings.h"
-
-#ifdef DEBUG_IMAGES
+#include "configuration.h"
 #include "logger.h"
-#endif
+#include "settings.h"
 
+#include "utils/files.h"
 #include "utils/mathutils.h"
+#include "utils/mkdir.h"
 #include "utils/physfscheckutils.h"
 #include "utils/physfsrwops.h"
+#include "utils/physfstools.h"
 #include "utils/sdlcheckutils.h"
+#include "utils/stringutils.h"
+#include "utils/surfacefile.h"
 
 #include "resources/atlasitem.h"
 #include "resources/atlasresource.h"
@@ -39,11 +42,179 @@
 #include "resources/imagehelper.h"
 #include "resources/openglimagehelper.h"
 #include "resources/resourcemanager.h"
+#include "resources/resourcetable.h"
 #include "resources/sdlimagehelper.h"
 #include "resources/textureatlas.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
 #include "debug.h"
 
+namespace
+{
+    const int atlasCacheMagic = 0x3143414D;  // "MAC1"
+
+    struct SkylineNode final
+    {
+        SkylineNode(const int x0, const int y0, const int width0) :
+            x(x0),
+            y(y0),
+            width(width0)
+        {
+        }
+
+        int x;
+        int y;
+        int width;
+    };
+
+    typedef std::vector<SkylineNode> Skyline;
+
+    bool compareImages(const Image *const img1, const Image *const img2)
+    {
+        if (img1->mBounds.h != img2->mBounds.h)
+            return img1->mBounds.h > img2->mBounds.h;
+        return img1->mBounds.w > img2->mBounds.w;
+    }
+
+    // returns lowest y for image placed at left side of skyline node
+    int fitSkyline(const Skyline &skyline,
+                   size_t index,
+                   const int width,
+                   const int binWidth)
+    {
+        if (skyline[index].x + width > binWidth)
+            return -1;
+
+        int y = 0;
+        int left = width;
+        while (left > 0 && index < skyline.size())
+        {
+            const SkylineNode &node = skyline[index];
+            if (node.y > y)
+                y = node.y;
+            left -= node.width;
+            index ++;
+        }
+        return y;
+    }
+
+    bool findSkylinePos(const Skyline &skyline,
+                        const int width,
+                        const int height,
+                        const int binWidth,
+                        const int binHeight,
+                        size_t &bestIndex,
+                        int &bestY)
+    {
+        int bestTop = binHeight + 1;
+        int bestWidth = binWidth + 1;
+        const size_t sz = skyline.size();
+        for (size_t f = 0; f < sz; f ++)
+        {
+            const int y = fitSkyline(skyline, f, width, binWidth);
+            if (y < 0)
+                continue;
+            const int top = y + height;
+            if (top > binHeight)
+                continue;
+            if (top < bestTop
+                || (top == bestTop && skyline[f].width < bestWidth))
+            {
+                bestTop = top;
+                bestWidth = skyline[f].width;
+                bestIndex = f;
+                bestY = y;
+            }
+        }
+        return bestTop <= binHeight;
+    }
+
+    void addSkylineLevel(Skyline &skyline,
+                         const size_t index,
+                         const int x,
+                         const int y,
+                         const int width)
+    {
+        skyline.insert(skyline.begin() + index, SkylineNode(x, y, width));
+
+        // cut nodes under new level
+        const int right = x + width;
+        size_t f = index + 1;
+        while (f < skyline.size())
+        {
+            SkylineNode &node = skyline[f];
+            if (node.x >= right)
+                break;
+            const int shrink = right - node.x;
+            node.x += shrink;
+            node.width -= shrink;
+            if (node.width > 0)
+                break;
+            skyline.erase(skyline.begin() + f);
+        }
+
+        // merge neighbour nodes with same height
+        f = 0;
+        while (f + 1 < skyline.size())
+        {
+            if (skyline[f].y == skyline[f + 1].y)
+            {
+                skyline[f].width += skyline[f + 1].width;
+                skyline.erase(skyline.begin() + f + 1);
+            }
+            else
+            {
+                f ++;
+            }
+        }
+    }
+
+    void deleteAtlas(TextureAtlas *const atlas)
+    {
+        FOR_EACH (std::vector<AtlasItem*>::iterator, it, atlas->items)
+        {
+            AtlasItem *const item = *it;
+            delete item->image;
+            delete item;
+        }
+        delete atlas;
+    }
+
+    bool writeInt(FILE *const file, const int value)
+    {
+        const int32_t val = value;
+        return fwrite(&val, sizeof(val), 1, file) == 1;
+    }
+
+    bool readInt(FILE *const file, int &value)
+    {
+        int32_t val = 0;
+        if (fread(&val, sizeof(val), 1, file) != 1)
+            return false;
+        value = val;
+        return true;
+    }
+
+    bool writeString(FILE *const file, const std::string &str)
+    {
+        const size_t sz = str.size();
+        return writeInt(file, static_cast<int>(sz))
+            && fwrite(str.data(), 1, sz, file) == sz;
+    }
+
+    bool readString(FILE *const file, std::string &str)
+    {
+        int sz = 0;
+        if (!readInt(file, sz) || sz < 0 || sz > 10000000)
+            return false;
+        str.resize(sz);
+        return !sz || fread(&str[0], 1, sz, file) == static_cast<size_t>(sz);
+    }
+}  // namespace
+
 AtlasManager::AtlasManager()
 {
 }
@@ -56,7 +227,6 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
     std::vector<Image*> images;
     AtlasResource *resource = new AtlasResource;
 
-    loadImages(files, images);
     int maxSize = OpenGLImageHelper::getTextureSize();
 #if !defined(ANDROID) && !defined(__APPLE__)
     int sz = settings.textureSize;
@@ -64,9 +234,28 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         maxSize = sz;
 #endif
 
+    moveOldImages(files);
+
+    const bool useCache = config.getBoolValue("enableAtlasCache");
+    std::string cacheKey;
+    if (useCache)
+    {
+        cacheKey = getCacheKey(files, maxSize);
+        if (loadCache(name, cacheKey, resource))
+        {
+            BLOCK_END("AtlasManager::loadTextureAtlas")
+            return resource;
+        }
+    }
+
+    loadImages(files, images);
+
     // sorting images on atlases.
-    simpleSort(name, atlases, images, maxSize);
+    skylineSort(name, atlases, images, maxSize);
 
+    std::vector<SDL_Surface*> surfaces;
+    int imagesArea = 0;
+    int atlasesArea = 0;
     FOR_EACH (std::vector<TextureAtlas*>::iterator, it, atlases)
     {
         TextureAtlas *const atlas = *it;
@@ -77,45 +266,74 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         SDL_Surface *const surface = createSDLAtlas(atlas);
 
         if (!surface)
+        {
+            deleteAtlas(atlas);
             continue;
+        }
 
         // debug save
 //        ImageWriter::writePNG(surface, settings.tempDir
 //            + "/atlas" + name + toString(k) + ".png");
 //        k ++;
 
+        FOR_EACH (std::vector<AtlasItem*>::const_iterator, it2, atlas->items)
+            imagesArea += (*it2)->width * (*it2)->height;
+        atlasesArea += atlas->width * atlas->height;
+
         // convert SDL images to OpenGL
         convertAtlas(atlas);
 
-        // free SDL atlas surface
-        MSDL_FreeSurface(surface);
-
+        surfaces.push_back(surface);
         resource->atlases.push_back(atlas);
     }
 
+    if (atlasesArea > 0)
+    {
+        logger->log("Atlas %s: %u images in %u atlases, %d%% filled",
+            name.c_str(),
+            static_cast<unsigned int>(images.size()),
+            static_cast<unsigned int>(resource->atlases.size()),
+            static_cast<int>(static_cast<int64_t>(imagesArea) * 100
+            / atlasesArea));
+    }
+
+    if (useCache)
+        saveCache(name, cacheKey, resource->atlases, surfaces);
+
+    // free SDL atlas surfaces
+    FOR_EACH (std::vector<SDL_Surface*>::iterator, it, surfaces)
+        MSDL_FreeSurface(*it);
+
     BLOCK_END("AtlasManager::loadTextureAtlas")
     return resource;
 }
 
-void AtlasManager::loadImages(const StringVect &files,
-                              std::vector<Image*> &images)
+void AtlasManager::moveOldImages(const StringVect &files)
 {
-    BLOCK_START("AtlasManager::loadImages")
     ResourceManager *const resman = ResourceManager::getInstance();
 
     FOR_EACH (StringVectCIter, it, files)
     {
-        const std::string str = *it;
         // check is image with same name already in cache
         // and if yes, move it to deleted set
-        Resource *const res = resman->getTempResource(str);
+        Resource *const res = resman->getTempResource(*it);
         if (res)
         {
             // increase counter because in moveToDeleted it will be decreased.
             res->incRef();
             resman->moveToDeleted(res);
         }
+    }
+}
+
+void AtlasManager::loadImages(const StringVect &files,
+                              std::vector<Image*> &images)
+{
+    BLOCK_START("AtlasManager::loadImages")
 
+    FOR_EACH (StringVectCIter, it, files)
+    {
+        const std::string str = *it;
         std::string path = str;
         const size_t p = path.find('|');
         Dye *d = nullptr;
@@ -146,75 +364,82 @@ void AtlasManager::loadImages(const StringVect &files,
     BLOCK_END("AtlasManager::loadImages")
 }
 
-void AtlasManager::simpleSort(const std::string &restrict name,
-                              std::vector<TextureAtlas*> &restrict atlases,
-                              const std::vector<Image*> &restrict images,
-                              int size)
+void AtlasManager::skylineSort(const std::string &restrict name,
+                               std::vector<TextureAtlas*> &restrict atlases,
+                               const std::vector<Image*> &restrict images,
+                               const int size)
 {
-    BLOCK_START("AtlasManager::simpleSort")
-    int x = 0;
-    int y = 0;
-    int tempHeight = 0;
-    TextureAtlas *atlas = new TextureAtlas();
-    std::vector<Image*>::const_iterator it = images.begin();
-    const std::vector<Image*>::const_iterator it_end = images.end();
-    for (it = images.begin(); it != it_end; ++ it)
-    {
-        const Image *const img = *it;
-        if (img)
-        {
-            atlas->name = std::string("atlas_").append(name).append(
-                "_").append(img->getIdPath());
-            break;
-        }
+    BLOCK_START("AtlasManager::skylineSort")
+    std::vector<Image*> sorted;
+    sorted.reserve(images.size());
+    int area = 0;
+    int maxWidth = 1;
+    FOR_EACH (std::vector<Image*>::const_iterator, it, images)
+    {
+        Image *const img = *it;
+        if (!img)
+            continue;
+        sorted.push_back(img);
+        area += img->mBounds.w * img->mBounds.h;
+        if (img->mBounds.w > maxWidth)
+            maxWidth = img->mBounds.w;
     }
-
-    for (it = images.begin(); it != it_end; ++ it)
+    std::stable_sort(sorted.begin(), sorted.end(), &compareImages);
+
+    // near square atlases waste less space after power of two rounding
+    int binWidth = powerOfTwo(static_cast<int>(sqrt(
+        static_cast<double>(area))) + 1);
+    if (binWidth < powerOfTwo(maxWidth))
+        binWidth = powerOfTwo(maxWidth);
+    if (binWidth > size)
+        binWidth = size;
+
+    TextureAtlas *atlas = nullptr;
+    Skyline skyline;
+    FOR_EACH (std::vector<Image*>::const_iterator, it, sorted)
     {
         Image *const img = *it;
-        if (img)
+        const int width = img->mBounds.w;
+        const int height = img->mBounds.h;
+        size_t index = 0;
+        int y = 0;
+        bool found = atlas && findSkylinePos(skyline, width, height,
+            binWidth, size, index, y);
+        if (!found)
         {
-            AtlasItem *const item = new AtlasItem(img);
-            item->name = img->getIdPath();
-            // start next line
-            if (x + img->mBounds.w > size)
-            {
-                x = 0;
-                y += tempHeight;
-                tempHeight = 0;
-            }
-
-            // can't put image with this height
-            if (y + img->mBounds.h > size)
-            {
-                x = 0;
-                y = 0;
+            if (atlas)
                 atlases.push_back(atlas);
-                atlas = new TextureAtlas();
-                atlas->name = std::string("atlas_").append(name).append(
-                    "_").append(img->getIdPath());
-            }
-
-            if (img->mBounds.h > tempHeight)
-                tempHeight = img->mBounds.h;
-
-            item->x = x;
-            item->y = y;
-            atlas->items.push_back(item);
+            atlas = new TextureAtlas();
+            atlas->name = std::string("atlas_").append(name).append(
+                "_").append(img->getIdPath());
+            skyline.clear();
+            skyline.push_back(SkylineNode(0, 0, binWidth));
+            found = findSkylinePos(skyline, width, height,
+                binWidth, size, index, y);
+        }
 
-            // continue put textures in line
-            x += img->mBounds.w;
-            if (x > atlas->width)
-                atlas->width = x;
-            if (y + img->mBounds.h > atlas->height)
-                atlas->height = y + img->mBounds.h;
+        AtlasItem *const item = new AtlasItem(img);
+        item->name = img->getIdPath();
+        atlas->items.push_back(item);
+        if (!found)
+        {
+            // image bigger than atlas, keep it alone
+            atlases.push_back(atlas);
+            atlas = nullptr;
+            continue;
         }
+
+        item->x = skyline[index].x;
+        item->y = y;
+        if (item->x + width > atlas->width)
+            atlas->width = item->x + width;
+        if (y + height > atlas->height)
+            atlas->height = y + height;
+        addSkylineLevel(skyline, index, item->x, y + height, width);
     }
-    if (!atlas->items.empty())
+    if (atlas)
         atlases.push_back(atlas);
-    else
-        delete atlas;
-    BLOCK_END("AtlasManager::simpleSort")
+    BLOCK_END("AtlasManager::skylineSort")
 }
 
 SDL_Surface *AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
@@ -256,23 +481,217 @@ SDL_Surface *AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
     }
     BLOCK_END("AtlasManager::createSDLAtlas create surface")
 
-    Image *image = imageHelper->load(surface);
-
-    // drawing SDL images to surface
+    // drawing SDL images to surface, so atlas uploaded at once
     FOR_EACH (std::vector<AtlasItem*>::iterator, it, atlas->items)
     {
         AtlasItem *const item = *it;
-        if (image)
+        SDL_Surface *const src = item->image->mSDLSurface;
+        if (!src)
+            continue;
+#ifdef USE_SDL2
+        SDL_SetSurfaceAlphaMod(src, SDL_ALPHA_OPAQUE);
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+        SDL_Rect rect =
         {
-            imageHelper->copySurfaceToImage(image, item->x, item->y,
-                item->image->mSDLSurface);
-        }
+            item->x, item->y,
+            src->w, src->h
+        };
+#else
+        // copy alpha channel instead of blending
+        SDL_SetAlpha(src, 0, SDL_ALPHA_OPAQUE);
+        SDL_Rect rect =
+        {
+            static_cast<int16_t>(item->x), static_cast<int16_t>(item->y),
+            static_cast<uint16_t>(src->w), static_cast<uint16_t>(src->h)
+        };
+#endif
+        SDL_BlitSurface(src, nullptr, surface, &rect);
+    }
+    atlas->atlasImage = imageHelper->load(surface);
+    if (!atlas->atlasImage)
+    {
+        MSDL_FreeSurface(surface);
+        BLOCK_END("AtlasManager::createSDLAtlas")
+        return nullptr;
     }
-    atlas->atlasImage = image;
     BLOCK_END("AtlasManager::createSDLAtlas")
     return surface;
 }
 
+std::string AtlasManager::getCacheKey(const StringVect &files,
+                                      const int size)
+{
+    std::string key = toString(size);
+    FOR_EACH (StringVectCIter, it, files)
+    {
+        const std::string &str = *it;
+        const std::string path = str.substr(0, str.find('|'));
+        const char *const dir = PhysFs::getRealDir(path.c_str());
+        key.append("\n").append(str).append("\n").append(
+            dir ? dir : "").append("\n").append(toString(
+            static_cast<int>(PHYSFS_getLastModTime(path.c_str()))));
+    }
+    return key;
+}
+
+std::string AtlasManager::getCacheFileName(const std::string &name)
+{
+    return strprintf("%s/atlascache/%08x.atlas",
+        settings.localDataDir.c_str(),
+        ResourceTable::hashId(name));
+}
+
+bool AtlasManager::loadCache(const std::string &name,
+                             const std::string &key,
+                             AtlasResource *const resource)
+{
+    BLOCK_START("AtlasManager::loadCache")
+    FILE *const file = fopen(getCacheFileName(name).c_str(), "rb");
+    if (!file)
+    {
+        BLOCK_END("AtlasManager::loadCache")
+        return false;
+    }
+
+    std::string fileKey;
+    int magic = 0;
+    int count = 0;
+    bool ok = readInt(file, magic)
+        && magic == atlasCacheMagic
+        && readString(file, fileKey)
+        && fileKey == key
+        && readInt(file, count)
+        && count > 0
+        && count < 1000;
+
+    std::vector<TextureAtlas*> atlases;
+    std::vector<SDL_Surface*> surfaces;
+    for (int f = 0; ok && f < count; f ++)
+    {
+        TextureAtlas *const atlas = new TextureAtlas;
+        atlases.push_back(atlas);
+        int items = 0;
+        ok = readString(file, atlas->name)
+            && readInt(file, atlas->width)
+            && readInt(file, atlas->height)
+            && readInt(file, items)
+            && items > 0
+            && items < 100000;
+        for (int i = 0; ok && i < items; i ++)
+        {
+            std::string itemName;
+            int x = 0;
+            int y = 0;
+            int width = 0;
+            int height = 0;
+            ok = readString(file, itemName)
+                && readInt(file, x)
+                && readInt(file, y)
+                && readInt(file, width)
+                && readInt(file, height);
+            if (ok)
+            {
+                atlas->items.push_back(new AtlasItem(itemName,
+                    x, y, width, height));
+            }
+        }
+        if (ok)
+        {
+            SDL_Surface *const surface = SurfaceFile::read(file);
+            ok = surface != nullptr;
+            if (ok)
+                surfaces.push_back(surface);
+        }
+    }
+    fclose(file);
+
+    for (size_t f = 0; f < atlases.size(); f ++)
+    {
+        TextureAtlas *const atlas = atlases[f];
+        if (ok)
+            atlas->atlasImage = imageHelper->load(surfaces[f]);
+        if (atlas->atlasImage)
+        {
+            convertAtlas(atlas);
+            resource->atlases.push_back(atlas);
+        }
+        else
+        {
+            deleteAtlas(atlas);
+        }
+    }
+    FOR_EACH (std::vector<SDL_Surface*>::iterator, it, surfaces)
+        MSDL_FreeSurface(*it);
+
+    if (ok)
+    {
+        logger->log("Atlas %s: loaded %u atlases from cache",
+            name.c_str(),
+            static_cast<unsigned int>(resource->atlases.size()));
+    }
+    BLOCK_END("AtlasManager::loadCache")
+    return ok;
+}
+
+void AtlasManager::saveCache(const std::string &name,
+                             const std::string &key,
+                             const std::vector<TextureAtlas*> &atlases,
+                             const std::vector<SDL_Surface*> &surfaces)
+{
+    if (atlases.empty() || atlases.size() != surfaces.size())
+        return;
+
+    BLOCK_START("AtlasManager::saveCache")
+    const std::string dir = settings.localDataDir + "/atlascache";
+    if (mkdir_r(dir.c_str()))
+    {
+        BLOCK_END("AtlasManager::saveCache")
+        return;
+    }
+
+    // write to unique temp file, so readers never see partial file
+    const std::string fileName = getCacheFileName(name);
+    const std::string tempName = Files::getTempName(fileName);
+    FILE *const file = fopen(tempName.c_str(), "wb");
+    if (!file)
+    {
+        BLOCK_END("AtlasManager::saveCache")
+        return;
+    }
+
+    bool ok = writeInt(file, atlasCacheMagic)
+        && writeString(file, key)
+        && writeInt(file, static_cast<int>(atlases.size()));
+    for (size_t f = 0; ok && f < atlases.size(); f ++)
+    {
+        const TextureAtlas *const atlas = atlases[f];
+        ok = writeString(file, atlas->name)
+            && writeInt(file, atlas->width)
+            && writeInt(file, atlas->height)
+            && writeInt(file, static_cast<int>(atlas->items.size()));
+        FOR_EACH (std::vector<AtlasItem*>::const_iterator, it, atlas->items)
+        {
+            const AtlasItem *const item = *it;
+            ok = ok
+                && writeString(file, item->name)
+                && writeInt(file, item->x)
+                && writeInt(file, item->y)
+                && writeInt(file, item->width)
+                && writeInt(file, item->height);
+        }
+        ok = ok && SurfaceFile::write(file, surfaces[f], true);
+    }
+    fclose(file);
+#ifdef WIN32
+    // rename on windows not replaces existing file
+    if (ok)
+        remove(fileName.c_str());
+#endif  // WIN32
+    if (!ok || rename(tempName.c_str(), fileName.c_str()))
+        remove(tempName.c_str());
+    BLOCK_END("AtlasManager::saveCache")
+}
+
 void AtlasManager::convertAtlas(TextureAtlas *const atlas)
 {
     // no check for null pointer in atlas because it was in caller
@@ -51,17 +51,43 @@ class AtlasManager final
         static void moveToDeleted(AtlasResource *const resource);
 
     private:
+        static void moveOldImages(const StringVect &files);
+
         static void loadImages(const StringVect &files,
                                std::vector<Image*> &images);
 
-        static void simpleSort(const std::string &restrict name,
-                               std::vector<TextureAtlas*> &restrict atlases,
-                               const std::vector<Image*> &restrict images,
-                               int size);
+        /**
+         * Packs images by skyline bottom left method, highest images first.
+         */
+        static void skylineSort(const std::string &restrict name,
+                                std::vector<TextureAtlas*> &restrict atlases,
+                                const std::vector<Image*> &restrict images,
+                                const int size);
 
         static SDL_Surface *createSDLAtlas(TextureAtlas *const atlas)
                                            A_WARN_UNUSED;
 
+        /**
+         * Returns string what changes if any atlas source image changed.
+         */
+        static std::string getCacheKey(const StringVect &files,
+                                       const int size) A_WARN_UNUSED;
+
+        static std::string getCacheFileName(const std::string &name)
+                                            A_WARN_UNUSED;
+
+        /**
+         * Loads packed atlases saved by saveCache, if cache key same.
+         */
+        static bool loadCache(const std::string &name,
+                              const std::string &key,
+                              AtlasResource *const resource) A_WARN_UNUSED;
+
+        static void saveCache(const std::string &name,
+                              const std::string &key,
+                              const std::vector<TextureAtlas*> &atlases,
+                              const std::vector<SDL_Surface*> &surfaces);
+
 
         static void convertAtlas(TextureAtlas *const atlas);
 };
@@ -22,10 +22,17 @@
 
 #include "animationdelayload.h"
 
+#include "resources/asyncresourceloader.h"
+
 #include "utils/timer.h"
 
 #include "debug.h"
 
+namespace
+{
+    const int maxLoads = 4;
+}  // namespace
+
 DelayedAnim DelayedManager::mDelayedAnimations;
 
 void DelayedManager::delayedLoad()
@@ -36,17 +43,26 @@ void DelayedManager::delayedLoad()
     {
         loadTime = tick_time;
 
+        // prepared sprites need only texture upload,
+        // so few of them can be loaded at once
         int k = 0;
         DelayedAnimIter it = mDelayedAnimations.begin();
         const DelayedAnimIter it_end = mDelayedAnimations.end();
-        while (it != it_end && k < 1)
+        while (it != it_end && k < maxLoads)
         {
+            if (!(*it)->isReady())
+            {
+                ++ it;
+                continue;
+            }
             (*it)->load();
             AnimationDelayLoad *tmp = *it;
             it = mDelayedAnimations.erase(it);
             delete tmp;
             k ++;
         }
+        if (mDelayedAnimations.empty() && asyncResourceLoader)
+            asyncResourceLoader->clearResults();
         const int time2 = tick_time;
         if (time2 > loadTime)
             loadTime = time2 + (time2 - loadTime) * 2 + 10;
@@ -24,17 +24,20 @@
 
 #include "logger.h"
 
+#include "resources/dyekernels.h"
 #include "resources/dyepalette.h"
 
 #include "utils/delete2.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <SDL_endian.h>
 
 #include "debug.h"
 
-Dye::Dye(const std::string &description)
+Dye::Dye(const std::string &description) :
+    mDescription(description)
 {
     for (int i = 0; i < dyePalateSize; ++i)
         mDyePalettes[i] = nullptr;
@@ -54,7 +57,7 @@ Dye::Dye(const std::string &description)
 
         if (next_pos <= pos + 3 || description[pos + 1] != ':')
         {
-            logger->log("Error, invalid dye: %s", description.c_str());
+            logger->log_r("Error, invalid dye: %s", description.c_str());
             return;
         }
 
@@ -72,7 +75,7 @@ Dye::Dye(const std::string &description)
             case 'S': i = 7; break;
             case 'A': i = 8; break;
             default:
-                logger->log("Error, invalid dye: %s", description.c_str());
+                logger->log_r("Error, invalid dye: %s", description.c_str());
                 return;
         }
         mDyePalettes[i] = new DyePalette(description.substr(
@@ -128,7 +131,7 @@ void Dye::instantiate(std::string &restrict target,
         }
         else
         {
-            logger->log("Error, invalid dye placeholder: %s", target.c_str());
+            logger->log_r("Error, invalid dye placeholder: %s", target.c_str());
             return;
         }
         s << target[next_pos];
@@ -150,114 +153,54 @@ int Dye::getType() const
 
 void Dye::normalDye(uint32_t *restrict pixels, const int bufSize) const
 {
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++ pixels)
-    {
-        const uint32_t p = *pixels;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = p & 0xff000000;
-#else
-        const int alpha = p & 0xff;
-#endif
-        if (!alpha)
-            continue;
-        unsigned int color[3];
+    DyeLut lut;
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        color[0] = (p) & 255U;
-        color[1] = (p >> 8U) & 255U;
-        color[2] = (p >> 16U) & 255U;
+    fillLut(lut, 0U, 8U, 16U, 0xff000000U);
 #else
-        color[0] = (p >> 24U) & 255U;
-        color[1] = (p >> 16U) & 255U;
-        color[2] = (p >> 8U) & 255U;
+    fillLut(lut, 24U, 16U, 8U, 0x000000ffU);
 #endif
-
-        const unsigned int cmax = std::max(
-            color[0], std::max(color[1], color[2]));
-        if (cmax == 0)
-            continue;
-
-        const unsigned int cmin = std::min(
-            color[0], std::min(color[1], color[2]));
-        const unsigned int intensity = color[0] + color[1] + color[2];
-
-        if (cmin != cmax && (cmin != 0 || (intensity != cmax
-            && intensity != 2 * cmax)))
-        {
-            // not pure
-            continue;
-        }
-
-        const unsigned int i = (color[0] != 0) | ((color[1] != 0) << 1)
-            | ((color[2] != 0) << 2);
-
-        if (mDyePalettes[i - 1])
-            mDyePalettes[i - 1]->getColor(cmax, color);
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        *pixels = (color[0]) | (color[1] << 8)
-            | (color[2] << 16) | alpha;
-#else
-        *pixels = (color[0] << 24) | (color[1] << 16)
-            | (color[2] << 8) | alpha;
-#endif
-    }
+    DyeKernels::normalDye(pixels, bufSize, lut);
 }
 
 void Dye::normalOGLDye(uint32_t *restrict pixels, const int bufSize) const
 {
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++ pixels)
-    {
-        const uint32_t p = *pixels;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = p & 255;
-#else
-        const int alpha = p & 0xff000000;
-#endif
-        if (!alpha)
-            continue;
-        unsigned int color[3];
+    DyeLut lut;
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        color[0] = (p >> 24U) & 255U;
-        color[1] = (p >> 16U) & 255U;
-        color[2] = (p >> 8U) & 255U;
+    fillLut(lut, 24U, 16U, 8U, 0x000000ffU);
 #else
-        color[0] = (p) & 255U;
-        color[1] = (p >> 8U) & 255U;
-        color[2] = (p >> 16U) & 255U;
+    fillLut(lut, 0U, 8U, 16U, 0xff000000U);
 #endif
+    DyeKernels::normalDye(pixels, bufSize, lut);
+}
 
-        const unsigned int cmax = std::max(
-            color[0], std::max(color[1], color[2]));
-        if (cmax == 0)
-            continue;
-
-        const unsigned int cmin = std::min(
-            color[0], std::min(color[1], color[2]));
-        const unsigned int intensity = color[0] + color[1] + color[2];
+void Dye::fillLut(DyeLut &lut,
+                  const unsigned int shift0,
+                  const unsigned int shift1,
+                  const unsigned int shift2,
+                  const uint32_t alphaMask) const
+{
+    lut.shift[0] = shift0;
+    lut.shift[1] = shift1;
+    lut.shift[2] = shift2;
+    lut.alphaMask = alphaMask;
 
-        if (cmin != cmax && (cmin != 0 || (intensity != cmax
-            && intensity != 2 * cmax)))
+    for (int f = 0; f < dyeLutPalettes; f ++)
+    {
+        uint32_t *const colors = lut.colors + f * 256;
+        const DyePalette *const palette = mDyePalettes[f];
+        if (!palette || palette->isEmpty())
         {
-            // not pure
+            std::fill(colors, colors + 256, alphaMask);
             continue;
         }
-
-        const unsigned int i = (color[0] != 0) | ((color[1] != 0) << 1)
-            | ((color[2] != 0) << 2);
-
-        if (mDyePalettes[i - 1])
-            mDyePalettes[i - 1]->getColor(cmax, color);
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        *pixels = (color[0] << 24) | (color[1] << 16)
-            | (color[2] << 8) | alpha;
-#else
-        *pixels = (color[0]) | (color[1] << 8)
-            | (color[2] << 16) | alpha;
-#endif
+        colors[0] = 0U;
+        for (unsigned int intensity = 1; intensity < 256; intensity ++)
+        {
+            unsigned int color[3];
+            palette->getColor(intensity, color);
+            colors[intensity] = (color[0] << shift0)
+                | (color[1] << shift1)
+                | (color[2] << shift2);
+        }
     }
 }
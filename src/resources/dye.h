@@ -29,6 +29,8 @@
 
 class DyePalette;
 
+struct DyeLut;
+
 const int dyePalateSize = 9;
 const int sPaleteIndex = 7;
 const int aPaleteIndex = 8;
@@ -77,17 +79,34 @@ class Dye final
          */
         int getType() const A_WARN_UNUSED;
 
+        /**
+         * Returns dye string what dye created from.
+         */
+        const std::string &getDescription() const A_WARN_UNUSED
+        { return mDescription; }
+
         void normalDye(uint32_t *restrict pixels, const int bufSize) const;
 
         void normalOGLDye(uint32_t *restrict pixels, const int bufSize) const;
 
     private:
+        /**
+         * Fills normal dye lut for pixel format with given channel shifts.
+         */
+        void fillLut(DyeLut &lut,
+                     const unsigned int shift0,
+                     const unsigned int shift1,
+                     const unsigned int shift2,
+                     const uint32_t alphaMask) const;
+
         /**
          * The order of the palettes, as well as their uppercase letter, is:
          *
          * Red, Green, Yellow, Blue, Magenta, White (or rather gray), Simple.
          */
         DyePalette *mDyePalettes[dyePalateSize];
+
+        std::string mDescription;
 };
 
 #endif  // RESOURCES_DYE_H
@@ -20,12 +20,187 @@
 
 #include "resources/dye.h"
 
+#include "logger.h"
+
+#include "resources/dyekernels.h"
 #include "resources/dyepalette.h"
 
+#include "utils/cpu.h"
+#include "utils/delete2.h"
+
 #include "gtest/gtest.h"
 
+#include <ctime>
+#include <vector>
+
 #include "debug.h"
 
+namespace
+{
+    // odd size to check tails of vector loops
+    const int pixelsSize = 1027;
+
+    const uint32_t paletteFrom[] =
+    {
+        0x10203040U, 0x10203000U, 0x00102030U, 0xff000080U, 0x00ff00ffU
+    };
+    const uint32_t paletteTo[] =
+    {
+        0x50607080U, 0x01020304U, 0xa0b0c0d0U, 0x11223344U, 0x55667788U
+    };
+    const int paletteCount = 5;
+
+    void initKernels()
+    {
+        if (!logger)
+            logger = new Logger();
+        Cpu::detect();
+    }
+
+    void fillPixels(std::vector<uint32_t> &pixels)
+    {
+        pixels.resize(pixelsSize);
+        unsigned int seed = 12345U;
+        for (int f = 0; f < pixelsSize; f ++)
+        {
+            seed = seed * 1103515245U + 12345U;
+            const uint32_t rnd = seed >> 8;
+            const uint32_t alpha = (f % 7 == 0) ? 0U : ((rnd & 3) ? 0xffU
+                : (rnd & 0xffU));
+            const uint32_t level = (rnd >> 8) & 0xffU;
+            switch (f % 6)
+            {
+                case 0:
+                    // palette colors with different alpha
+                    pixels[f] = (paletteFrom[(rnd >> 4) % paletteCount]
+                        & 0xffffff00U) | alpha;
+                    break;
+                case 1:
+                    pixels[f] = paletteFrom[(rnd >> 4) % paletteCount];
+                    break;
+                case 2:
+                    // pure colors for normal dye, both alpha positions
+                    pixels[f] = (level << (8 * ((rnd >> 16) % 4)))
+                        | (alpha << 24) | alpha;
+                    break;
+                case 3:
+                    // mixed pure colors
+                    pixels[f] = (level << 24) | (level << 16)
+                        | ((rnd & 0x10000U) ? (level << 8) : 0) | alpha;
+                    break;
+                case 4:
+                    pixels[f] = (level << 16) | (level << 8)
+                        | (level) | (alpha << 24);
+                    break;
+                default:
+                    pixels[f] = seed;
+                    break;
+            }
+        }
+    }
+
+    void fillLut(DyeLut &lut,
+                 const unsigned int shift0,
+                 const unsigned int shift1,
+                 const unsigned int shift2,
+                 const uint32_t alphaMask)
+    {
+        lut.shift[0] = shift0;
+        lut.shift[1] = shift1;
+        lut.shift[2] = shift2;
+        lut.alphaMask = alphaMask;
+        for (int f = 0; f < dyeLutSize; f ++)
+        {
+            const uint32_t val = static_cast<uint32_t>(f * 2654435761U);
+            // some palettes missing
+            if ((f / 256) % 3 == 1)
+                lut.colors[f] = alphaMask;
+            else
+                lut.colors[f] = val & ~alphaMask;
+        }
+    }
+
+    typedef void (*ReplaceFunc)(uint32_t *restrict pixels,
+                                const int bufSize,
+                                const uint32_t *restrict const from,
+                                const uint32_t *restrict const to,
+                                const int count,
+                                const uint32_t dataMask,
+                                const uint32_t alphaMask);
+
+    typedef void (*NormalFunc)(uint32_t *restrict pixels,
+                               const int bufSize,
+                               const DyeLut &lut);
+
+    void testReplace(const ReplaceFunc func)
+    {
+        const uint32_t masks[][2] =
+        {
+            { 0xffffff00U, 0x000000ffU },
+            { 0x00ffffffU, 0xff000000U },
+            { 0xffffff00U, 0xff000000U },
+            { 0xffffffffU, 0U }
+        };
+        for (int mask = 0; mask < 4; mask ++)
+        {
+            std::vector<uint32_t> pixels1;
+            std::vector<uint32_t> pixels2;
+            fillPixels(pixels1);
+            fillPixels(pixels2);
+            DyeKernels::replaceColorsScalar(&pixels1[0], pixelsSize,
+                paletteFrom, paletteTo, paletteCount,
+                masks[mask][0], masks[mask][1]);
+            func(&pixels2[0], pixelsSize,
+                paletteFrom, paletteTo, paletteCount,
+                masks[mask][0], masks[mask][1]);
+            for (int f = 0; f < pixelsSize; f ++)
+                EXPECT_EQ(pixels1[f], pixels2[f]);
+        }
+    }
+
+    void testNormal(const NormalFunc func)
+    {
+        for (int layout = 0; layout < 2; layout ++)
+        {
+            DyeLut lut;
+            if (layout)
+                fillLut(lut, 0U, 8U, 16U, 0xff000000U);
+            else
+                fillLut(lut, 24U, 16U, 8U, 0x000000ffU);
+            std::vector<uint32_t> pixels1;
+            std::vector<uint32_t> pixels2;
+            fillPixels(pixels1);
+            fillPixels(pixels2);
+            DyeKernels::normalDyeScalar(&pixels1[0], pixelsSize, lut);
+            func(&pixels2[0], pixelsSize, lut);
+            for (int f = 0; f < pixelsSize; f ++)
+                EXPECT_EQ(pixels1[f], pixels2[f]);
+        }
+    }
+
+    double benchmark(const NormalFunc normal,
+                     const ReplaceFunc replace)
+    {
+        const int size = 512 * 512;
+        std::vector<uint32_t> pixels(size);
+        std::vector<uint32_t> source;
+        fillPixels(source);
+        DyeLut lut;
+        fillLut(lut, 24U, 16U, 8U, 0x000000ffU);
+        const clock_t start = clock();
+        for (int n = 0; n < 20; n ++)
+        {
+            for (int f = 0; f < size; f ++)
+                pixels[f] = source[f % pixelsSize];
+            normal(&pixels[0], size, lut);
+            replace(&pixels[0], size, paletteFrom, paletteTo,
+                paletteCount, 0xffffff00U, 0x000000ffU);
+        }
+        return static_cast<double>(clock() - start) * 1000.0
+            / CLOCKS_PER_SEC;
+    }
+}  // namespace
+
 TEST(Dye, replaceSOGLColor1)
 {
     DyePalette palette("#00ff00,000011", 6);
@@ -253,3 +428,106 @@ TEST(Dye, normalOGLDye1)
     EXPECT_EQ(0x2a, data[2]);
     EXPECT_EQ(0x50, data[3]);
 }
+
+TEST(Dye, normalDyeMixed)
+{
+    Dye dye("R:#203040,506070;Y:#204060;W:#102030");
+    uint8_t data[12];
+    // pure red, yellow and white with alpha in lowest byte
+    data[0] = 0x55;
+    data[1] = 0x00;
+    data[2] = 0x00;
+    data[3] = 0x50;
+    data[4] = 0x33;
+    data[5] = 0x00;
+    data[6] = 0x80;
+    data[7] = 0x80;
+    data[8] = 0x00;
+    data[9] = 0xff;
+    data[10] = 0xff;
+    data[11] = 0xff;
+    dye.normalDye(reinterpret_cast<uint32_t*>(&data[0]), 3);
+    EXPECT_EQ(0x55, data[0]);
+    EXPECT_EQ(0x28, data[1]);
+    EXPECT_EQ(0x1e, data[2]);
+    EXPECT_EQ(0x14, data[3]);
+    EXPECT_EQ(0x33, data[4]);
+    EXPECT_EQ(0x30, data[5]);
+    EXPECT_EQ(0x20, data[6]);
+    EXPECT_EQ(0x10, data[7]);
+    // transparent pixel not changed
+    EXPECT_EQ(0x00, data[8]);
+    EXPECT_EQ(0xff, data[9]);
+    EXPECT_EQ(0xff, data[10]);
+    EXPECT_EQ(0xff, data[11]);
+}
+
+TEST(Dye, kernelsDispatch)
+{
+    initKernels();
+    DyeKernels::init();
+    testReplace(&DyeKernels::replaceColors);
+    testNormal(&DyeKernels::normalDye);
+    delete2(logger);
+}
+
+#ifdef DYE_SIMD
+TEST(Dye, kernelsSse2)
+{
+    initKernels();
+    if (Cpu::getFlags() & Cpu::FEATURE_SSE2)
+    {
+        testReplace(&DyeKernels::replaceColorsSse2);
+        testNormal(&DyeKernels::normalDyeSse2);
+    }
+    delete2(logger);
+}
+
+TEST(Dye, kernelsAvx2)
+{
+    initKernels();
+    if (Cpu::getFlags() & Cpu::FEATURE_AVX2)
+    {
+        testReplace(&DyeKernels::replaceColorsAvx2);
+        testNormal(&DyeKernels::normalDyeAvx2);
+    }
+    delete2(logger);
+}
+#endif  // DYE_SIMD
+
+#ifdef DYE_NEON
+TEST(Dye, kernelsNeon)
+{
+    testReplace(&DyeKernels::replaceColorsNeon);
+    testNormal(&DyeKernels::normalDyeNeon);
+}
+#endif  // DYE_NEON
+
+// run with --gtest_also_run_disabled_tests
+TEST(Dye, DISABLED_kernelsBenchmark)
+{
+    initKernels();
+    logger->log("Dye kernels scalar: %f ms",
+        benchmark(&DyeKernels::normalDyeScalar,
+        &DyeKernels::replaceColorsScalar));
+#ifdef DYE_SIMD
+    if (Cpu::getFlags() & Cpu::FEATURE_SSE2)
+    {
+        logger->log("Dye kernels sse2: %f ms",
+            benchmark(&DyeKernels::normalDyeSse2,
+            &DyeKernels::replaceColorsSse2));
+    }
+    if (Cpu::getFlags() & Cpu::FEATURE_AVX2)
+    {
+        logger->log("Dye kernels avx2: %f ms",
+            benchmark(&DyeKernels::normalDyeAvx2,
+            &DyeKernels::replaceColorsAvx2));
+    }
+#endif
+#ifdef DYE_NEON
+    logger->log("Dye kernels neon: %f ms",
+        benchmark(&DyeKernels::normalDyeNeon,
+        &DyeKernels::replaceColorsNeon));
+#endif
+    delete2(logger);
+}
@@ -0,0 +1,203 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/dyecache.h"
+
+#include "logger.h"
+
+#include "utils/files.h"
+#include "utils/mkdir.h"
+#include "utils/stringutils.h"
+#include "utils/surfacefile.h"
+
+#include <algorithm>
+#include <ctime>
+#include <dirent.h>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "debug.h"
+
+std::string DyeCache::mDir;
+bool DyeCache::mEnabled = false;
+bool DyeCache::mCompress = true;
+
+namespace
+{
+    uint64_t hashBytes(uint64_t hash,
+                       const char *const data,
+                       const size_t size)
+    {
+        // FNV-1a 64
+        for (size_t f = 0; f < size; f ++)
+        {
+            hash ^= static_cast<unsigned char>(data[f]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    struct CacheFile final
+    {
+        CacheFile(const std::string &name0,
+                  const time_t time0,
+                  const uint64_t size0) :
+            name(name0),
+            time(time0),
+            size(size0)
+        {
+        }
+
+        std::string name;
+        time_t time;
+        uint64_t size;
+    };
+
+    struct CacheFileSorter final
+    {
+        bool operator() (const CacheFile &file1,
+                         const CacheFile &file2) const
+        {
+            return file1.time < file2.time;
+        }
+    } cacheFileSorter;
+
+    // temp files older than it are left from interrupted writes
+    const time_t tempFileAge = 3600;
+}  // namespace
+
+void DyeCache::init(const std::string &dir,
+                    const bool compress,
+                    const int maxSize)
+{
+    mEnabled = false;
+    mCompress = compress;
+    mDir = dir;
+    if (mkdir_r(mDir.c_str()))
+    {
+        logger->log("Dye cache disabled, can't create directory: "
+            + mDir);
+        return;
+    }
+    mEnabled = true;
+    prune(maxSize);
+}
+
+void DyeCache::prune(const int maxSize)
+{
+    DIR *const dir = opendir(mDir.c_str());
+    if (!dir)
+        return;
+
+    const time_t now = time(nullptr);
+    std::vector<CacheFile> files;
+    uint64_t totalSize = 0;
+    const struct dirent *nextFile = nullptr;
+    while ((nextFile = readdir(dir)))
+    {
+        const std::string name = nextFile->d_name;
+        if (name == "." || name == "..")
+            continue;
+        const std::string path = std::string(mDir).append(
+            "/").append(name);
+        struct stat statbuf;
+        if (stat(path.c_str(), &statbuf))
+            continue;
+        if (!findLast(name, ".dye"))
+        {
+            if (statbuf.st_mtime + tempFileAge < now)
+                remove(path.c_str());
+            continue;
+        }
+        const uint64_t size = static_cast<uint64_t>(statbuf.st_size);
+        files.push_back(CacheFile(name, statbuf.st_mtime, size));
+        totalSize += size;
+    }
+    closedir(dir);
+
+    const uint64_t limit = static_cast<uint64_t>(maxSize) * 1024 * 1024;
+    if (totalSize <= limit)
+        return;
+
+    // remove oldest entries first
+    std::sort(files.begin(), files.end(), cacheFileSorter);
+    int removed = 0;
+    FOR_EACH (std::vector<CacheFile>::const_iterator, it, files)
+    {
+        if (totalSize <= limit)
+            break;
+        remove(std::string(mDir).append("/").append(
+            (*it).name).c_str());
+        totalSize -= (*it).size;
+        removed ++;
+    }
+    logger->log("Dye cache: removed %d old files", removed);
+}
+
+std::string DyeCache::getName(const char *const data,
+                              const int size,
+                              const std::string &dye,
+                              const char format)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hashBytes(hash, data, size);
+    hash = hashBytes(hash, dye.data(), dye.size() + 1);
+    hash = hashBytes(hash, &format, 1);
+    return strprintf("%08x%08x%08x.dye",
+        static_cast<unsigned int>(hash >> 32),
+        static_cast<unsigned int>(hash & 0xffffffffU),
+        static_cast<unsigned int>(size));
+}
+
+SDL_Surface *DyeCache::load(const std::string &name)
+{
+    if (!mEnabled)
+        return nullptr;
+
+    FILE *const file = fopen(std::string(mDir).append(
+        "/").append(name).c_str(), "rb");
+    if (!file)
+        return nullptr;
+
+    SDL_Surface *const surface = SurfaceFile::read(file);
+    fclose(file);
+    return surface;
+}
+
+void DyeCache::save(const std::string &name,
+                    const SDL_Surface *const surface)
+{
+    if (!mEnabled || !surface)
+        return;
+
+    // write to unique temp file, so readers never see partial file
+    const std::string fileName = std::string(mDir).append(
+        "/").append(name);
+    const std::string tempName = Files::getTempName(fileName);
+    FILE *const file = fopen(tempName.c_str(), "wb");
+    if (!file)
+        return;
+
+    const bool written = SurfaceFile::write(file, surface, mCompress);
+    fclose(file);
+    if (!written || rename(tempName.c_str(), fileName.c_str()))
+        remove(tempName.c_str());
+}
@@ -0,0 +1,75 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_DYECACHE_H
+#define RESOURCES_DYECACHE_H
+
+#include <string>
+
+#include "localconsts.h"
+
+struct SDL_Surface;
+
+/**
+ * Disk cache of dyed 32 bit surfaces. Files named by hash of source image
+ * data, dye string and surface format, so changed images never hit old
+ * entries. Can be used from resource loader thread.
+ */
+class DyeCache final
+{
+    public:
+        A_DELETE_COPY(DyeCache)
+
+        /**
+         * Enables cache in given directory, creating it if needed.
+         * Oldest entries removed if cache is bigger than maxSize MiB.
+         */
+        static void init(const std::string &dir,
+                         const bool compress,
+                         const int maxSize);
+
+        static bool isEnabled() A_WARN_UNUSED
+        { return mEnabled; }
+
+        /**
+         * Returns cache entry name for source image data.
+         */
+        static std::string getName(const char *const data,
+                                   const int size,
+                                   const std::string &dye,
+                                   const char format) A_WARN_UNUSED;
+
+        /**
+         * Returns cached surface or nullptr. Caller must free surface.
+         */
+        static SDL_Surface *load(const std::string &name) A_WARN_UNUSED;
+
+        static void save(const std::string &name,
+                         const SDL_Surface *const surface);
+
+    private:
+        static void prune(const int maxSize);
+
+        static std::string mDir;
+        static bool mEnabled;
+        static bool mCompress;
+};
+
+#endif  // RESOURCES_DYECACHE_H
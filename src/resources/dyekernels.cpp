@@ -0,0 +1,549 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/dyekernels.h"
+
+#include "logger.h"
+
+#ifndef DYECMD
+#include "utils/cpu.h"
+#endif
+
+#include <algorithm>
+
+#ifdef DYE_SIMD
+#include <immintrin.h>
+#endif
+#ifdef DYE_NEON
+#include <arm_neon.h>
+#endif
+
+#include "debug.h"
+
+namespace
+{
+    enum Implementation
+    {
+        SCALAR = 0,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    Implementation mImplementation = SCALAR;
+
+    // writes lut color for pixels marked in useMask, used after vector
+    // classification by implementations without gather
+    inline void applyLut(uint32_t *restrict const pixels,
+                         const uint32_t *restrict const idx,
+                         const int useMask,
+                         const int count,
+                         const DyeLut &lut)
+    {
+        const uint32_t alphaMask = lut.alphaMask;
+        for (int f = 0; f < count; f ++)
+        {
+            if (!(useMask & (1 << f)))
+                continue;
+            const uint32_t color = lut.colors[idx[f]];
+            if (color & alphaMask)
+                continue;
+            pixels[f] = color | (pixels[f] & alphaMask);
+        }
+    }
+}  // namespace
+
+void DyeKernels::init()
+{
+    mImplementation = SCALAR;
+#ifdef DYE_NEON
+    mImplementation = NEON;
+#endif
+#if defined(DYE_SIMD) && !defined(DYECMD)
+    const int flags = Cpu::getFlags();
+    if (flags & Cpu::FEATURE_AVX2)
+        mImplementation = AVX2;
+    else if (flags & Cpu::FEATURE_SSE2)
+        mImplementation = SSE2;
+#endif
+    logger->log("Dye kernels: %s", getName());
+}
+
+const char *DyeKernels::getName()
+{
+    switch (mImplementation)
+    {
+        case AVX2:
+            return "avx2";
+        case SSE2:
+            return "sse2";
+        case NEON:
+            return "neon";
+        case SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+void DyeKernels::replaceColors(uint32_t *restrict pixels,
+                               const int bufSize,
+                               const uint32_t *restrict const from,
+                               const uint32_t *restrict const to,
+                               const int count,
+                               const uint32_t dataMask,
+                               const uint32_t alphaMask)
+{
+    switch (mImplementation)
+    {
+#ifdef DYE_SIMD
+        case AVX2:
+            replaceColorsAvx2(pixels, bufSize, from, to, count,
+                dataMask, alphaMask);
+            break;
+        case SSE2:
+            replaceColorsSse2(pixels, bufSize, from, to, count,
+                dataMask, alphaMask);
+            break;
+#endif
+#ifdef DYE_NEON
+        case NEON:
+            replaceColorsNeon(pixels, bufSize, from, to, count,
+                dataMask, alphaMask);
+            break;
+#endif
+        case SCALAR:
+        default:
+            replaceColorsScalar(pixels, bufSize, from, to, count,
+                dataMask, alphaMask);
+            break;
+    }
+}
+
+void DyeKernels::normalDye(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const DyeLut &lut)
+{
+    switch (mImplementation)
+    {
+#ifdef DYE_SIMD
+        case AVX2:
+            normalDyeAvx2(pixels, bufSize, lut);
+            break;
+        case SSE2:
+            normalDyeSse2(pixels, bufSize, lut);
+            break;
+#endif
+#ifdef DYE_NEON
+        case NEON:
+            normalDyeNeon(pixels, bufSize, lut);
+            break;
+#endif
+        case SCALAR:
+        default:
+            normalDyeScalar(pixels, bufSize, lut);
+            break;
+    }
+}
+
+void DyeKernels::replaceColorsScalar(uint32_t *restrict pixels,
+                                     const int bufSize,
+                                     const uint32_t *restrict const from,
+                                     const uint32_t *restrict const to,
+                                     const int count,
+                                     const uint32_t dataMask,
+                                     const uint32_t alphaMask)
+{
+    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
+         pixels != p_end;
+         ++ pixels)
+    {
+        const uint32_t p = *pixels;
+        if (alphaMask && !(p & alphaMask))
+            continue;
+
+        const uint32_t data = p & dataMask;
+        for (int f = 0; f < count; f ++)
+        {
+            if (data == from[f])
+            {
+                *pixels = (p & ~dataMask) | to[f];
+                break;
+            }
+        }
+    }
+}
+
+void DyeKernels::normalDyeScalar(uint32_t *restrict pixels,
+                                 const int bufSize,
+                                 const DyeLut &lut)
+{
+    const uint32_t alphaMask = lut.alphaMask;
+    const unsigned int shift0 = lut.shift[0];
+    const unsigned int shift1 = lut.shift[1];
+    const unsigned int shift2 = lut.shift[2];
+
+    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
+         pixels != p_end;
+         ++ pixels)
+    {
+        const uint32_t p = *pixels;
+        const uint32_t alpha = p & alphaMask;
+        if (!alpha)
+            continue;
+
+        const unsigned int color0 = (p >> shift0) & 255U;
+        const unsigned int color1 = (p >> shift1) & 255U;
+        const unsigned int color2 = (p >> shift2) & 255U;
+
+        const unsigned int cmax = std::max(color0, std::max(color1, color2));
+        if (cmax == 0)
+            continue;
+
+        const unsigned int cmin = std::min(color0, std::min(color1, color2));
+        const unsigned int intensity = color0 + color1 + color2;
+
+        if (cmin != cmax && (cmin != 0 || (intensity != cmax
+            && intensity != 2 * cmax)))
+        {
+            // not pure
+            continue;
+        }
+
+        const unsigned int i = (color0 != 0) | ((color1 != 0) << 1)
+            | ((color2 != 0) << 2);
+
+        const uint32_t color = lut.colors[(i - 1) * 256 + cmax];
+        if (color & alphaMask)
+            continue;
+        *pixels = color | alpha;
+    }
+}
+
+#ifdef DYE_SIMD
+
+__attribute__((target("sse2")))
+void DyeKernels::replaceColorsSse2(uint32_t *restrict pixels,
+                                   const int bufSize,
+                                   const uint32_t *restrict const from,
+                                   const uint32_t *restrict const to,
+                                   const int count,
+                                   const uint32_t dataMask,
+                                   const uint32_t alphaMask)
+{
+    const int end = bufSize & ~3;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i dataMaskV = _mm_set1_epi32(dataMask);
+    const __m128i alphaMaskV = _mm_set1_epi32(alphaMask);
+
+    for (int f = 0; f < end; f += 4)
+    {
+        __m128i *const ptr = reinterpret_cast<__m128i*>(pixels + f);
+        const __m128i px = _mm_loadu_si128(ptr);
+        // lanes already replaced or skipped
+        __m128i done = zero;
+        if (alphaMask)
+            done = _mm_cmpeq_epi32(_mm_and_si128(px, alphaMaskV), zero);
+        if (_mm_movemask_epi8(done) == 0xffff)
+            continue;
+
+        const __m128i data = _mm_and_si128(px, dataMaskV);
+        const __m128i keep = _mm_andnot_si128(dataMaskV, px);
+        __m128i res = px;
+        for (int c = 0; c < count; c ++)
+        {
+            const __m128i match = _mm_andnot_si128(done,
+                _mm_cmpeq_epi32(data, _mm_set1_epi32(from[c])));
+            const __m128i val = _mm_or_si128(keep, _mm_set1_epi32(to[c]));
+            res = _mm_or_si128(_mm_andnot_si128(match, res),
+                _mm_and_si128(match, val));
+            done = _mm_or_si128(done, match);
+        }
+        _mm_storeu_si128(ptr, res);
+    }
+    replaceColorsScalar(pixels + end, bufSize - end, from, to, count,
+        dataMask, alphaMask);
+}
+
+__attribute__((target("avx2")))
+void DyeKernels::replaceColorsAvx2(uint32_t *restrict pixels,
+                                   const int bufSize,
+                                   const uint32_t *restrict const from,
+                                   const uint32_t *restrict const to,
+                                   const int count,
+                                   const uint32_t dataMask,
+                                   const uint32_t alphaMask)
+{
+    const int end = bufSize & ~7;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i dataMaskV = _mm256_set1_epi32(dataMask);
+    const __m256i alphaMaskV = _mm256_set1_epi32(alphaMask);
+
+    for (int f = 0; f < end; f += 8)
+    {
+        __m256i *const ptr = reinterpret_cast<__m256i*>(pixels + f);
+        const __m256i px = _mm256_loadu_si256(ptr);
+        __m256i done = zero;
+        if (alphaMask)
+        {
+            done = _mm256_cmpeq_epi32(_mm256_and_si256(px, alphaMaskV),
+                zero);
+        }
+        if (_mm256_movemask_epi8(done) == -1)
+            continue;
+
+        const __m256i data = _mm256_and_si256(px, dataMaskV);
+        const __m256i keep = _mm256_andnot_si256(dataMaskV, px);
+        __m256i res = px;
+        for (int c = 0; c < count; c ++)
+        {
+            const __m256i match = _mm256_andnot_si256(done,
+                _mm256_cmpeq_epi32(data, _mm256_set1_epi32(from[c])));
+            res = _mm256_blendv_epi8(res,
+                _mm256_or_si256(keep, _mm256_set1_epi32(to[c])),
+                match);
+            done = _mm256_or_si256(done, match);
+        }
+        _mm256_storeu_si256(ptr, res);
+    }
+    replaceColorsScalar(pixels + end, bufSize - end, from, to, count,
+        dataMask, alphaMask);
+}
+
+__attribute__((target("sse2")))
+void DyeKernels::normalDyeSse2(uint32_t *restrict pixels,
+                               const int bufSize,
+                               const DyeLut &lut)
+{
+    const int end = bufSize & ~3;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i byteMask = _mm_set1_epi32(255);
+    const __m128i alphaMaskV = _mm_set1_epi32(lut.alphaMask);
+    const __m128i shift0 = _mm_cvtsi32_si128(lut.shift[0]);
+    const __m128i shift1 = _mm_cvtsi32_si128(lut.shift[1]);
+    const __m128i shift2 = _mm_cvtsi32_si128(lut.shift[2]);
+    uint32_t idx[4];
+
+    for (int f = 0; f < end; f += 4)
+    {
+        const __m128i px = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pixels + f));
+        const __m128i alpha = _mm_and_si128(px, alphaMaskV);
+        const __m128i color0 = _mm_and_si128(_mm_srl_epi32(px, shift0),
+            byteMask);
+        const __m128i color1 = _mm_and_si128(_mm_srl_epi32(px, shift1),
+            byteMask);
+        const __m128i color2 = _mm_and_si128(_mm_srl_epi32(px, shift2),
+            byteMask);
+
+        // channels fit in low 16 bits, so 16 bit min/max is enough
+        const __m128i cmax = _mm_max_epi16(color0,
+            _mm_max_epi16(color1, color2));
+        const __m128i cmin = _mm_min_epi16(color0,
+            _mm_min_epi16(color1, color2));
+        const __m128i intensity = _mm_add_epi32(color0,
+            _mm_add_epi32(color1, color2));
+
+        const __m128i pure = _mm_or_si128(_mm_cmpeq_epi32(cmin, cmax),
+            _mm_and_si128(_mm_cmpeq_epi32(cmin, zero),
+            _mm_or_si128(_mm_cmpeq_epi32(intensity, cmax),
+            _mm_cmpeq_epi32(intensity, _mm_add_epi32(cmax, cmax)))));
+        const __m128i use = _mm_andnot_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(alpha, zero),
+            _mm_cmpeq_epi32(cmax, zero)), pure);
+        const int useMask = _mm_movemask_ps(_mm_castsi128_ps(use));
+        if (!useMask)
+            continue;
+
+        const __m128i i = _mm_or_si128(
+            _mm_andnot_si128(_mm_cmpeq_epi32(color0, zero), one),
+            _mm_or_si128(_mm_slli_epi32(
+            _mm_andnot_si128(_mm_cmpeq_epi32(color1, zero), one), 1),
+            _mm_slli_epi32(
+            _mm_andnot_si128(_mm_cmpeq_epi32(color2, zero), one), 2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(idx),
+            _mm_add_epi32(_mm_slli_epi32(_mm_sub_epi32(i, one), 8), cmax));
+        applyLut(pixels + f, idx, useMask, 4, lut);
+    }
+    normalDyeScalar(pixels + end, bufSize - end, lut);
+}
+
+__attribute__((target("avx2")))
+void DyeKernels::normalDyeAvx2(uint32_t *restrict pixels,
+                               const int bufSize,
+                               const DyeLut &lut)
+{
+    const int end = bufSize & ~7;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i byteMask = _mm256_set1_epi32(255);
+    const __m256i alphaMaskV = _mm256_set1_epi32(lut.alphaMask);
+    const __m128i shift0 = _mm_cvtsi32_si128(lut.shift[0]);
+    const __m128i shift1 = _mm_cvtsi32_si128(lut.shift[1]);
+    const __m128i shift2 = _mm_cvtsi32_si128(lut.shift[2]);
+    const int *const colors = reinterpret_cast<const int*>(lut.colors);
+
+    for (int f = 0; f < end; f += 8)
+    {
+        __m256i *const ptr = reinterpret_cast<__m256i*>(pixels + f);
+        const __m256i px = _mm256_loadu_si256(ptr);
+        const __m256i alpha = _mm256_and_si256(px, alphaMaskV);
+        const __m256i color0 = _mm256_and_si256(
+            _mm256_srl_epi32(px, shift0), byteMask);
+        const __m256i color1 = _mm256_and_si256(
+            _mm256_srl_epi32(px, shift1), byteMask);
+        const __m256i color2 = _mm256_and_si256(
+            _mm256_srl_epi32(px, shift2), byteMask);
+
+        const __m256i cmax = _mm256_max_epi32(color0,
+            _mm256_max_epi32(color1, color2));
+        const __m256i cmin = _mm256_min_epi32(color0,
+            _mm256_min_epi32(color1, color2));
+        const __m256i intensity = _mm256_add_epi32(color0,
+            _mm256_add_epi32(color1, color2));
+
+        const __m256i pure = _mm256_or_si256(
+            _mm256_cmpeq_epi32(cmin, cmax),
+            _mm256_and_si256(_mm256_cmpeq_epi32(cmin, zero),
+            _mm256_or_si256(_mm256_cmpeq_epi32(intensity, cmax),
+            _mm256_cmpeq_epi32(intensity, _mm256_add_epi32(cmax, cmax)))));
+        __m256i use = _mm256_andnot_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi32(alpha, zero),
+            _mm256_cmpeq_epi32(cmax, zero)), pure);
+        if (_mm256_testz_si256(use, use))
+            continue;
+
+        const __m256i i = _mm256_or_si256(
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(color0, zero), one),
+            _mm256_or_si256(_mm256_slli_epi32(
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(color1, zero), one), 1),
+            _mm256_slli_epi32(
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(color2, zero), one), 2)));
+        // unused lanes read first entry
+        const __m256i idx = _mm256_and_si256(use, _mm256_add_epi32(
+            _mm256_slli_epi32(_mm256_sub_epi32(i, one), 8), cmax));
+        const __m256i color = _mm256_mask_i32gather_epi32(zero,
+            colors, idx, use, 4);
+
+        // skip missing palettes
+        use = _mm256_and_si256(use, _mm256_cmpeq_epi32(
+            _mm256_and_si256(color, alphaMaskV), zero));
+        _mm256_storeu_si256(ptr, _mm256_blendv_epi8(px,
+            _mm256_or_si256(color, alpha), use));
+    }
+    normalDyeScalar(pixels + end, bufSize - end, lut);
+}
+
+#endif  // DYE_SIMD
+
+#ifdef DYE_NEON
+
+void DyeKernels::replaceColorsNeon(uint32_t *restrict pixels,
+                                   const int bufSize,
+                                   const uint32_t *restrict const from,
+                                   const uint32_t *restrict const to,
+                                   const int count,
+                                   const uint32_t dataMask,
+                                   const uint32_t alphaMask)
+{
+    const int end = bufSize & ~3;
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const uint32x4_t dataMaskV = vdupq_n_u32(dataMask);
+    const uint32x4_t alphaMaskV = vdupq_n_u32(alphaMask);
+
+    for (int f = 0; f < end; f += 4)
+    {
+        const uint32x4_t px = vld1q_u32(pixels + f);
+        uint32x4_t done = zero;
+        if (alphaMask)
+            done = vceqq_u32(vandq_u32(px, alphaMaskV), zero);
+
+        const uint32x4_t data = vandq_u32(px, dataMaskV);
+        const uint32x4_t keep = vbicq_u32(px, dataMaskV);
+        uint32x4_t res = px;
+        for (int c = 0; c < count; c ++)
+        {
+            const uint32x4_t match = vbicq_u32(
+                vceqq_u32(data, vdupq_n_u32(from[c])), done);
+            res = vbslq_u32(match,
+                vorrq_u32(keep, vdupq_n_u32(to[c])), res);
+            done = vorrq_u32(done, match);
+        }
+        vst1q_u32(pixels + f, res);
+    }
+    replaceColorsScalar(pixels + end, bufSize - end, from, to, count,
+        dataMask, alphaMask);
+}
+
+void DyeKernels::normalDyeNeon(uint32_t *restrict pixels,
+                               const int bufSize,
+                               const DyeLut &lut)
+{
+    const int end = bufSize & ~3;
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const uint32x4_t one = vdupq_n_u32(1);
+    const uint32x4_t byteMask = vdupq_n_u32(255);
+    const uint32x4_t alphaMaskV = vdupq_n_u32(lut.alphaMask);
+    // negative shift count shifts right
+    const int32x4_t shift0 = vdupq_n_s32(-static_cast<int>(lut.shift[0]));
+    const int32x4_t shift1 = vdupq_n_s32(-static_cast<int>(lut.shift[1]));
+    const int32x4_t shift2 = vdupq_n_s32(-static_cast<int>(lut.shift[2]));
+    const uint32x4_t laneBits = { 1U, 2U, 4U, 8U };
+    uint32_t idx[4];
+    uint32_t bits[4];
+
+    for (int f = 0; f < end; f += 4)
+    {
+        const uint32x4_t px = vld1q_u32(pixels + f);
+        const uint32x4_t alpha = vandq_u32(px, alphaMaskV);
+        const uint32x4_t color0 = vandq_u32(vshlq_u32(px, shift0),
+            byteMask);
+        const uint32x4_t color1 = vandq_u32(vshlq_u32(px, shift1),
+            byteMask);
+        const uint32x4_t color2 = vandq_u32(vshlq_u32(px, shift2),
+            byteMask);
+
+        const uint32x4_t cmax = vmaxq_u32(color0, vmaxq_u32(color1, color2));
+        const uint32x4_t cmin = vminq_u32(color0, vminq_u32(color1, color2));
+        const uint32x4_t intensity = vaddq_u32(color0,
+            vaddq_u32(color1, color2));
+
+        const uint32x4_t pure = vorrq_u32(vceqq_u32(cmin, cmax),
+            vandq_u32(vceqq_u32(cmin, zero),
+            vorrq_u32(vceqq_u32(intensity, cmax),
+            vceqq_u32(intensity, vaddq_u32(cmax, cmax)))));
+        const uint32x4_t use = vbicq_u32(pure,
+            vorrq_u32(vceqq_u32(alpha, zero), vceqq_u32(cmax, zero)));
+        vst1q_u32(bits, vandq_u32(use, laneBits));
+        const int useMask = static_cast<int>(
+            bits[0] | bits[1] | bits[2] | bits[3]);
+        if (!useMask)
+            continue;
+
+        const uint32x4_t i = vorrq_u32(vbicq_u32(one, vceqq_u32(color0, zero)),
+            vorrq_u32(vshlq_n_u32(vbicq_u32(one, vceqq_u32(color1, zero)), 1),
+            vshlq_n_u32(vbicq_u32(one, vceqq_u32(color2, zero)), 2)));
+        vst1q_u32(idx, vaddq_u32(vshlq_n_u32(vsubq_u32(i, one), 8), cmax));
+        applyLut(pixels + f, idx, useMask, 4, lut);
+    }
+    normalDyeScalar(pixels + end, bufSize - end, lut);
+}
+
+#endif  // DYE_NEON
@@ -0,0 +1,135 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_DYEKERNELS_H
+#define RESOURCES_DYEKERNELS_H
+
+#include <stdint.h>
+
+#include "localconsts.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && (GCC_VERSION >= 40900) \
+    && (defined(__x86_64__) || defined(__i386__)) && !defined(ANDROID)
+#define DYE_SIMD
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define DYE_NEON
+#endif
+
+const int dyeLutPalettes = 7;
+const int dyeLutSize = dyeLutPalettes * 256;
+
+/**
+ * Colors for normal dye by palette index and pixel intensity, packed in
+ * pixel format. Entries of missing palettes have all alpha bits set.
+ */
+struct DyeLut final
+{
+    uint32_t colors[dyeLutSize];
+    // bit positions of red, green and blue channels
+    unsigned int shift[3];
+    uint32_t alphaMask;
+};
+
+/**
+ * Pixel loops of Dye and DyePalette. Implementation selected at runtime
+ * from detected cpu features, all implementations give same results.
+ */
+namespace DyeKernels
+{
+    void init();
+
+    const char *getName() A_WARN_UNUSED;
+
+    /**
+     * Replaces pixels what have (pixel & dataMask) equal to from[n] by
+     * (pixel & ~dataMask) | to[n], first match wins. If alphaMask is not
+     * zero, pixels without alpha bits skipped.
+     */
+    void replaceColors(uint32_t *restrict pixels,
+                       const int bufSize,
+                       const uint32_t *restrict const from,
+                       const uint32_t *restrict const to,
+                       const int count,
+                       const uint32_t dataMask,
+                       const uint32_t alphaMask);
+
+    /**
+     * Recolors pure red, green, blue and mixed color pixels from lut.
+     */
+    void normalDye(uint32_t *restrict pixels,
+                   const int bufSize,
+                   const DyeLut &lut);
+
+    void replaceColorsScalar(uint32_t *restrict pixels,
+                             const int bufSize,
+                             const uint32_t *restrict const from,
+                             const uint32_t *restrict const to,
+                             const int count,
+                             const uint32_t dataMask,
+                             const uint32_t alphaMask);
+
+    void normalDyeScalar(uint32_t *restrict pixels,
+                         const int bufSize,
+                         const DyeLut &lut);
+
+#ifdef DYE_SIMD
+    void replaceColorsSse2(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const uint32_t *restrict const from,
+                           const uint32_t *restrict const to,
+                           const int count,
+                           const uint32_t dataMask,
+                           const uint32_t alphaMask);
+
+    void replaceColorsAvx2(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const uint32_t *restrict const from,
+                           const uint32_t *restrict const to,
+                           const int count,
+                           const uint32_t dataMask,
+                           const uint32_t alphaMask);
+
+    void normalDyeSse2(uint32_t *restrict pixels,
+                       const int bufSize,
+                       const DyeLut &lut);
+
+    void normalDyeAvx2(uint32_t *restrict pixels,
+                       const int bufSize,
+                       const DyeLut &lut);
+#endif  // DYE_SIMD
+
+#ifdef DYE_NEON
+    void replaceColorsNeon(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const uint32_t *restrict const from,
+                           const uint32_t *restrict const to,
+                           const int count,
+                           const uint32_t dataMask,
+                           const uint32_t alphaMask);
+
+    void normalDyeNeon(uint32_t *restrict pixels,
+                       const int bufSize,
+                       const DyeLut &lut);
+#endif  // DYE_NEON
+}  // namespace DyeKernels
+
+#endif  // RESOURCES_DYEKERNELS_H
@@ -24,6 +24,8 @@
 
 #include "logger.h"
 
+#include "resources/dyekernels.h"
+
 #include "resources/db/palettedb.h"
 
 #include <cmath>
@@ -84,7 +86,7 @@ DyePalette::DyePalette(const std::string &description,
         }
     }
 
-    logger->log("Error, invalid embedded palette: %s", description.c_str());
+    logger->log_r("Error, invalid embedded palette: %s", description.c_str());
 }
 
 unsigned int DyePalette::hexDecode(const signed char c)
@@ -200,209 +202,80 @@ void DyePalette::getColor(double intensity, int color[3]) const
 void DyePalette::replaceSColor(uint32_t *restrict pixels,
                                const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
-    if (!sz)
-        return;
-    if (sz % 2)
-        -- it_end;
-
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++pixels)
-    {
-        uint8_t *const p = reinterpret_cast<uint8_t *>(pixels);
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = *pixels & 0xff000000;
-        const unsigned int data = (*pixels) & 0x00ffffff;
-#else
-        const int alpha = *p & 0xff;
-        const unsigned int data = (*pixels) & 0xffffff00;
-#endif
-//        logger->log("c:%04d   %08x", c, *pixels);
-//        logger->log("data:    %08x", data);
-        if (!alpha)
-        {
-//            logger->log("skip:    %08x", *pixels);
-            continue;
-        }
-
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
-        {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[2] << 16U)
-                | (col.value[1] << 8U) | (col.value[0]);
+    replaceColors(pixels, bufSize, false, false, 0x00ffffffU, 0xff000000U);
 #else
-            const unsigned int coldata = (col.value[2] << 8U)
-                | (col.value[1] << 16U) | (col.value[0] << 24U);
+    replaceColors(pixels, bufSize, true, false, 0xffffff00U, 0x000000ffU);
 #endif
-//            logger->log("coldata: %08x", coldata);
-            if (data == coldata)
-            {
-//                logger->log("correct");
-                p[3] = col2.value[0];
-                p[2] = col2.value[1];
-                p[1] = col2.value[2];
-                break;
-            }
-
-            ++ it;
-        }
-    }
 }
 
 void DyePalette::replaceAColor(uint32_t *restrict pixels,
                                const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
-    if (!sz)
-        return;
-    if (sz % 2)
-        -- it_end;
-
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++pixels)
-    {
-        uint8_t *const p = reinterpret_cast<uint8_t *>(pixels);
-        const unsigned int data = *pixels;
-
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
-        {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[3] << 24U)
-                | (col.value[2] << 16U)
-                | (col.value[1] << 8U)
-                | (col.value[0]);
+    replaceColors(pixels, bufSize, false, true, 0xffffffffU, 0U);
 #else
-            const unsigned int coldata = (col.value[3])
-                | (col.value[2] << 8U)
-                | (col.value[1] << 16U) |
-                (col.value[0] << 24U);
+    replaceColors(pixels, bufSize, true, true, 0xffffffffU, 0U);
 #endif
-
-            if (data == coldata)
-            {
-                p[3] = col2.value[0];
-                p[2] = col2.value[1];
-                p[1] = col2.value[2];
-                p[0] = col2.value[3];
-                break;
-            }
-
-            ++ it;
-        }
-    }
 }
 
 void DyePalette::replaceSOGLColor(uint32_t *restrict pixels,
                                   const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
-    if (!sz)
-        return;
-    if (sz % 2)
-        -- it_end;
-
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++pixels)
-    {
-        uint8_t *const p = reinterpret_cast<uint8_t *>(pixels);
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = *p & 0xff;
-        const unsigned int data = (*pixels) & 0xffffff00;
+    replaceColors(pixels, bufSize, true, false, 0xffffff00U, 0xff000000U);
 #else
-        const int alpha = *pixels & 0xff000000;
-        const unsigned int data = (*pixels) & 0x00ffffff;
+    replaceColors(pixels, bufSize, false, false, 0x00ffffffU, 0xff000000U);
 #endif
-        if (!alpha)
-            continue;
-
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
-        {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
+}
 
+void DyePalette::replaceAOGLColor(uint32_t *restrict pixels,
+                                  const int bufSize) const
+{
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[0] << 24)
-                | (col.value[1] << 16) | (col.value[2] << 8);
+    replaceColors(pixels, bufSize, true, true, 0xffffffffU, 0U);
 #else
-            const unsigned int coldata = (col.value[0])
-                | (col.value[1] << 8) | (col.value[2] << 16);
+    replaceColors(pixels, bufSize, false, true, 0xffffffffU, 0U);
 #endif
-            if (data == coldata)
-            {
-                p[0] = col2.value[0];
-                p[1] = col2.value[1];
-                p[2] = col2.value[2];
-                break;
-            }
-
-            ++ it;
-        }
-    }
 }
 
-void DyePalette::replaceAOGLColor(uint32_t *restrict pixels,
-                                  const int bufSize) const
+void DyePalette::replaceColors(uint32_t *restrict pixels,
+                               const int bufSize,
+                               const bool redFirst,
+                               const bool withAlpha,
+                               const uint32_t dataMask,
+                               const uint32_t alphaMask) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
-    if (!sz)
+    // colors go in pairs, odd last color ignored
+    const int count = static_cast<int>(mColors.size() / 2);
+    if (!count)
         return;
-    if (sz % 2)
-        -- it_end;
 
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++pixels)
+    std::vector<uint32_t> from(count);
+    std::vector<uint32_t> to(count);
+    for (int f = 0; f < count; f ++)
     {
-        uint8_t *const p = reinterpret_cast<uint8_t *>(pixels);
-        const unsigned int data = *pixels;
-
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
-        {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[0] << 24U)
-                | (col.value[1] << 16U)
-                | (col.value[2] << 8U)
-                | col.value[3];
-#else
-            const unsigned int coldata = (col.value[0])
-                | (col.value[1] << 8U)
-                | (col.value[2] << 16U)
-                | (col.value[3] << 24U);
-#endif
-            if (data == coldata)
-            {
-                p[0] = col2.value[0];
-                p[1] = col2.value[1];
-                p[2] = col2.value[2];
-                p[3] = col2.value[3];
-                break;
-            }
+        from[f] = packColor(mColors[f * 2], redFirst, withAlpha);
+        to[f] = packColor(mColors[f * 2 + 1], redFirst, withAlpha);
+    }
+    DyeKernels::replaceColors(pixels, bufSize, &from[0], &to[0], count,
+        dataMask, alphaMask);
+}
 
-            ++ it;
-        }
+uint32_t DyePalette::packColor(const DyeColor &color,
+                               const bool redFirst,
+                               const bool withAlpha)
+{
+    const uint32_t alpha = withAlpha ? color.value[3] : 0U;
+    if (redFirst)
+    {
+        return (color.value[0] << 24U)
+            | (color.value[1] << 16U)
+            | (color.value[2] << 8U)
+            | alpha;
     }
+    return color.value[0]
+        | (color.value[1] << 8U)
+        | (color.value[2] << 16U)
+        | (alpha << 24U);
 }
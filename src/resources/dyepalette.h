@@ -79,9 +79,27 @@ class DyePalette final
         void replaceAOGLColor(uint32_t *restrict pixels,
                               const int bufSize) const;
 
+        bool isEmpty() const A_WARN_UNUSED
+        { return mColors.empty(); }
+
         static unsigned int hexDecode(const signed char c) A_WARN_UNUSED;
 
     private:
+        /**
+         * Replaces pixels equal to first color of pair by second color.
+         * Colors packed with red in highest byte if redFirst set.
+         */
+        void replaceColors(uint32_t *restrict pixels,
+                           const int bufSize,
+                           const bool redFirst,
+                           const bool withAlpha,
+                           const uint32_t dataMask,
+                           const uint32_t alphaMask) const;
+
+        static uint32_t packColor(const DyeColor &color,
+                                  const bool redFirst,
+                                  const bool withAlpha) A_WARN_UNUSED;
+
         std::vector<DyeColor> mColors;
 };
 
@@ -27,6 +27,8 @@
 #include "logger.h"
 
 #ifdef USE_OPENGL
+#include "render/graphics.h"
+
 #include "resources/openglimagehelper.h"
 #endif
 #include "resources/sdlimagehelper.h"
@@ -223,6 +225,9 @@ void Image::unload()
 #ifdef USE_OPENGL
     if (mGLImage)
     {
+        // batched quads may still reference this texture
+        if (mainGraphics)
+            mainGraphics->completeCache();
         glDeleteTextures(1, &mGLImage);
         mGLImage = 0;
 #ifdef DEBUG_OPENGL_LEAKS
@@ -469,6 +474,37 @@ void Image::SDLTerminateAlphaCache()
     mUseAlphaCache = false;
 }
 
+int Image::getMemorySize() const
+{
+    int size = 0;
+    if (mSDLSurface)
+        size += mSDLSurface->pitch * mSDLSurface->h;
+    if (mAlphaChannel)
+        size += mBounds.w * mBounds.h;
+    for (std::map<float, SDL_Surface*>::const_iterator
+         i = mAlphaCache.begin(), i_end = mAlphaCache.end();
+         i != i_end; ++i)
+    {
+        const SDL_Surface *const surface = i->second;
+        if (surface && surface != mSDLSurface)
+            size += surface->pitch * surface->h;
+    }
+    return size;
+}
+
+int Image::getVideoMemorySize() const
+{
+#ifdef USE_OPENGL
+    if (mGLImage)
+        return mTexWidth * mTexHeight * 4;
+#endif
+#ifdef USE_SDL2
+    if (mTexture)
+        return mBounds.w * mBounds.h * 4;
+#endif
+    return 0;
+}
+
 #ifdef USE_OPENGL
 void Image::decRef()
 {
@@ -154,6 +154,10 @@ class Image notfinal : public Resource
 
         void SDLCleanCache();
 
+        int getMemorySize() const override A_WARN_UNUSED;
+
+        int getVideoMemorySize() const override A_WARN_UNUSED;
+
         void SDLTerminateAlphaCache();
 
 #ifdef USE_OPENGL
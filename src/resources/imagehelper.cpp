@@ -25,6 +25,7 @@
 #include "logger.h"
 
 #include "resources/dye.h"
+#include "resources/dyecache.h"
 #include "resources/dyepalette.h"
 
 #include "utils/sdlcheckutils.h"
@@ -57,11 +58,26 @@ Image *ImageHelper::load(SDL_RWops *const rw)
 Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
 {
     BLOCK_START("ImageHelper::load")
+    SDL_Surface *const surf = loadCachedDyedSurface(rw, dye);
+    if (!surf)
+    {
+        BLOCK_END("ImageHelper::load")
+        return nullptr;
+    }
+
+    Image *const image = load(surf);
+    MSDL_FreeSurface(surf);
+    BLOCK_END("ImageHelper::load")
+    return image;
+}
+
+SDL_Surface *ImageHelper::loadDyedSurface(SDL_RWops *const rw,
+                                          Dye const &dye) const
+{
     SDL_Surface *const tmpImage = loadPng(rw);
     if (!tmpImage)
     {
-        logger->log("Error, image load failed: %s", IMG_GetError());
-        BLOCK_END("ImageHelper::load")
+        logger->log_r("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
@@ -113,10 +129,44 @@ Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         }
     }
 
-    Image *const image = load(surf);
-    MSDL_FreeSurface(surf);
-    BLOCK_END("ImageHelper::load")
-    return image;
+    return surf;
+}
+
+SDL_Surface *ImageHelper::loadCachedDyedSurface(SDL_RWops *const rw,
+                                                Dye const &dye) const
+{
+    if (!DyeCache::isEnabled() || !rw)
+        return loadDyedSurface(rw, dye);
+
+    const int size = static_cast<int>(SDL_RWseek(rw, 0, RW_SEEK_END));
+    if (size <= 0 || SDL_RWseek(rw, 0, RW_SEEK_SET) != 0)
+        return loadDyedSurface(rw, dye);
+
+    char *const data = static_cast<char*>(malloc(size));
+    if (!data)
+        return loadDyedSurface(rw, dye);
+    if (static_cast<int>(SDL_RWread(rw, data, 1, size)) != size)
+    {
+        free(data);
+        SDL_RWseek(rw, 0, RW_SEEK_SET);
+        return loadDyedSurface(rw, dye);
+    }
+
+    const std::string name = DyeCache::getName(data, size,
+        dye.getDescription(), getDyeFormat());
+    SDL_Surface *surf = DyeCache::load(name);
+    if (surf)
+    {
+        free(data);
+        SDL_RWclose(rw);
+        return surf;
+    }
+
+    SDL_RWclose(rw);
+    surf = loadDyedSurface(SDL_RWFromConstMem(data, size), dye);
+    free(data);
+    DyeCache::save(name, surf);
+    return surf;
 }
 
 SDL_Surface* ImageHelper::convertTo32Bit(SDL_Surface *const tmpImage)
@@ -204,7 +254,7 @@ SDL_Surface *ImageHelper::loadPng(SDL_RWops *const rw)
         return tmpImage;
     }
 
-    logger->log("Error, image is not png");
+    logger->log_r("Error, image is not png");
     SDL_RWclose(rw);
     return nullptr;
 }
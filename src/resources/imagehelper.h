@@ -56,7 +56,29 @@ class ImageHelper notfinal
          */
         Image *load(SDL_RWops *const rw) A_WARN_UNUSED;
 
-        virtual Image *load(SDL_RWops *const rw, Dye const &dye) A_WARN_UNUSED;
+        /**
+         * Loads an image from an SDL_RWops structure and recolors it.
+         */
+        Image *load(SDL_RWops *const rw, Dye const &dye) A_WARN_UNUSED;
+
+        /**
+         * Decodes and recolors image into 32 bit surface without creating
+         * image. Can be called from loader thread.
+         *
+         * @return <code>NULL</code> if an error occurred, surface what
+         *         caller must free otherwise.
+         */
+        virtual SDL_Surface *loadDyedSurface(SDL_RWops *const rw,
+                                             Dye const &dye)
+                                             const A_WARN_UNUSED;
+
+        /**
+         * Same as loadDyedSurface, but takes surface from dye cache if
+         * possible and stores new dyed surfaces in it.
+         */
+        SDL_Surface *loadCachedDyedSurface(SDL_RWops *const rw,
+                                           Dye const &dye)
+                                           const A_WARN_UNUSED;
 
 #ifdef __GNUC__
         virtual Image *load(SDL_Surface *const) A_WARN_UNUSED = 0;
@@ -107,6 +129,12 @@ class ImageHelper notfinal
         ImageHelper()
         { }
 
+        /**
+         * Returns id of surface format made by loadDyedSurface.
+         */
+        virtual char getDyeFormat() const A_WARN_UNUSED
+        { return 'S'; }
+
         static bool mEnableAlpha;
         static RenderType mUseOpenGL;
 };
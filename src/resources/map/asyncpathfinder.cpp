@@ -0,0 +1,233 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/asyncpathfinder.h"
+
+#include "logger.h"
+
+#include "listeners/pathlistener.h"
+
+#include "resources/map/metatile.h"
+
+#include "utils/sdlhelper.h"
+
+#include "debug.h"
+
+int pathFinderThread(void *data)
+{
+    AsyncPathFinder *const finder = static_cast<AsyncPathFinder*>(data);
+    if (!finder)
+        return -1;
+
+    finder->run();
+    return 0;
+}
+
+AsyncPathFinder::AsyncPathFinder(const int width, const int height) :
+    mPathFinder(width, height),
+    mRequests(),
+    mResults(),
+    mTiles(new MetaTile[width * height]),
+    mNewTiles(new MetaTile[width * height]),
+    mWalkLayer(nullptr),
+    mCurrentListener(nullptr),
+    mThread(nullptr),
+    mMutex(SDL_CreateMutex()),
+    mCondition(SDL_CreateCond()),
+    mSize(width * height),
+    mTilesChanged(false),
+    mJumpPointSearch(false),
+    mCurrentCancelled(false),
+    mRunning(true)
+{
+    mThread = SDL::createThread(&pathFinderThread, "pathfinder", this);
+    if (!mThread)
+        logger->log1("Unable to create path finder thread");
+}
+
+AsyncPathFinder::~AsyncPathFinder()
+{
+    if (mThread)
+    {
+        SDL_mutexP(mMutex);
+        mRunning = false;
+        SDL_CondSignal(mCondition);
+        SDL_mutexV(mMutex);
+        SDL_WaitThread(mThread, nullptr);
+        mThread = nullptr;
+    }
+    SDL_DestroyCond(mCondition);
+    mCondition = nullptr;
+    SDL_DestroyMutex(mMutex);
+    mMutex = nullptr;
+    delete [] mTiles;
+    delete [] mNewTiles;
+}
+
+void AsyncPathFinder::setTiles(const MetaTile *const tiles)
+{
+    SDL_mutexP(mMutex);
+    for (int f = 0; f < mSize; f ++)
+        mNewTiles[f].blockmask = tiles[f].blockmask;
+    mTilesChanged = true;
+    SDL_mutexV(mMutex);
+}
+
+void AsyncPathFinder::setWalkLayer(const WalkLayer *const layer)
+{
+    SDL_mutexP(mMutex);
+    mWalkLayer = layer;
+    SDL_mutexV(mMutex);
+}
+
+void AsyncPathFinder::setJumpPointSearch(const bool enabled)
+{
+    SDL_mutexP(mMutex);
+    mJumpPointSearch = enabled;
+    SDL_mutexV(mMutex);
+}
+
+void AsyncPathFinder::removeRequests(PathRequests &requests,
+                                     const PathListener *const listener)
+{
+    PathRequestsIter it = requests.begin();
+    while (it != requests.end())
+    {
+        if ((*it).listener == listener)
+            it = requests.erase(it);
+        else
+            ++ it;
+    }
+}
+
+void AsyncPathFinder::addRequest(PathListener *const listener,
+                                 const int startX, const int startY,
+                                 const int destX, const int destY,
+                                 const unsigned char blockWalkMask,
+                                 const int maxCost)
+{
+    PathRequest request;
+    request.listener = listener;
+    request.startX = startX;
+    request.startY = startY;
+    request.destX = destX;
+    request.destY = destY;
+    request.blockWalkMask = blockWalkMask;
+    request.maxCost = maxCost;
+
+    SDL_mutexP(mMutex);
+    removeRequests(mRequests, listener);
+    removeRequests(mResults, listener);
+    if (mCurrentListener == listener)
+        mCurrentCancelled = true;
+    mRequests.push_back(request);
+    SDL_CondSignal(mCondition);
+    SDL_mutexV(mMutex);
+}
+
+void AsyncPathFinder::cancel(const PathListener *const listener)
+{
+    SDL_mutexP(mMutex);
+    removeRequests(mRequests, listener);
+    removeRequests(mResults, listener);
+    if (mCurrentListener == listener)
+        mCurrentCancelled = true;
+    SDL_mutexV(mMutex);
+}
+
+void AsyncPathFinder::run()
+{
+    SDL_mutexP(mMutex);
+    while (mRunning)
+    {
+        if (mRequests.empty())
+        {
+            SDL_CondWait(mCondition, mMutex);
+            continue;
+        }
+
+        PathRequest request = mRequests.front();
+        mRequests.pop_front();
+        if (mTilesChanged)
+        {
+            MetaTile *const tiles = mTiles;
+            mTiles = mNewTiles;
+            mNewTiles = tiles;
+            mTilesChanged = false;
+        }
+        mPathFinder.setWalkLayer(mWalkLayer);
+        mPathFinder.setJumpPointSearch(mJumpPointSearch);
+        mCurrentListener = request.listener;
+        mCurrentCancelled = false;
+        SDL_mutexV(mMutex);
+
+        request.path = mPathFinder.findPath(mTiles,
+            request.startX, request.startY,
+            request.destX, request.destY,
+            request.blockWalkMask,
+            request.maxCost);
+
+        SDL_mutexP(mMutex);
+        if (!mCurrentCancelled)
+            mResults.push_back(request);
+        mCurrentListener = nullptr;
+    }
+    SDL_mutexV(mMutex);
+}
+
+void AsyncPathFinder::processResults()
+{
+    BLOCK_START("AsyncPathFinder::processResults")
+    if (!mThread)
+    {
+        // without worker search in main thread
+        while (!mRequests.empty())
+        {
+            PathRequest request = mRequests.front();
+            mRequests.pop_front();
+            mPathFinder.setWalkLayer(mWalkLayer);
+            mPathFinder.setJumpPointSearch(mJumpPointSearch);
+            request.path = mPathFinder.findPath(mNewTiles,
+                request.startX, request.startY,
+                request.destX, request.destY,
+                request.blockWalkMask,
+                request.maxCost);
+            mResults.push_back(request);
+        }
+    }
+
+    // listener can cancel other requests, so results taken one by one
+    for (;;)
+    {
+        SDL_mutexP(mMutex);
+        if (mResults.empty())
+        {
+            SDL_mutexV(mMutex);
+            break;
+        }
+        const PathRequest request = mResults.front();
+        mResults.pop_front();
+        SDL_mutexV(mMutex);
+        request.listener->pathFound(request.path,
+            request.startX, request.startY,
+            request.destX, request.destY);
+    }
+    BLOCK_END("AsyncPathFinder::processResults")
+}
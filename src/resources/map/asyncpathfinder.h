@@ -0,0 +1,131 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_ASYNCPATHFINDER_H
+#define RESOURCES_MAP_ASYNCPATHFINDER_H
+
+#include "resources/map/pathfinder.h"
+
+#include <SDL_thread.h>
+
+#include <list>
+
+#include "localconsts.h"
+
+class PathListener;
+
+/**
+ * Runs path searches in worker thread. Worker searches over own copy of
+ * map tiles, new copy is taken with setTiles. Results delivered to
+ * listeners from processResults, called from game loop.
+ */
+class AsyncPathFinder final
+{
+    public:
+        AsyncPathFinder(const int width, const int height);
+
+        A_DELETE_COPY(AsyncPathFinder)
+
+        ~AsyncPathFinder();
+
+        /**
+         * Copies tiles for next searches.
+         */
+        void setTiles(const MetaTile *const tiles);
+
+        void setWalkLayer(const WalkLayer *const layer);
+
+        void setJumpPointSearch(const bool enabled);
+
+        /**
+         * Queues path search. Previous request of this listener is
+         * cancelled.
+         */
+        void addRequest(PathListener *const listener,
+                        const int startX, const int startY,
+                        const int destX, const int destY,
+                        const unsigned char blockWalkMask,
+                        const int maxCost);
+
+        /**
+         * Drops queued request and not delivered result of listener.
+         */
+        void cancel(const PathListener *const listener);
+
+        /**
+         * Sends finished paths to listeners.
+         */
+        void processResults();
+
+    private:
+        friend int pathFinderThread(void *data);
+
+        struct PathRequest final
+        {
+            PathRequest() :
+                listener(nullptr),
+                path(),
+                startX(0),
+                startY(0),
+                destX(0),
+                destY(0),
+                maxCost(0),
+                blockWalkMask(0)
+            {
+            }
+
+            PathListener *listener;
+            Path path;
+            int startX;
+            int startY;
+            int destX;
+            int destY;
+            int maxCost;
+            unsigned char blockWalkMask;
+        };
+
+        typedef std::list<PathRequest> PathRequests;
+        typedef PathRequests::iterator PathRequestsIter;
+
+        void run();
+
+        static void removeRequests(PathRequests &requests,
+                                   const PathListener *const listener);
+
+        PathFinder mPathFinder;
+        PathRequests mRequests;
+        PathRequests mResults;
+        // tiles used by worker and new tiles copy from main thread
+        MetaTile *mTiles;
+        MetaTile *mNewTiles;
+        const WalkLayer *mWalkLayer;
+        // listener of request processed by worker now
+        const PathListener *mCurrentListener;
+        SDL_Thread *mThread;
+        SDL_mutex *mMutex;
+        SDL_cond *mCondition;
+        int mSize;
+        bool mTilesChanged;
+        bool mJumpPointSearch;
+        bool mCurrentCancelled;
+        bool mRunning;
+};
+
+#endif  // RESOURCES_MAP_ASYNCPATHFINDER_H
@@ -27,10 +27,12 @@
 #include "notifymanager.h"
 #include "settings.h"
 
+#include "resources/map/asyncpathfinder.h"
 #include "resources/map/mapheights.h"
 #include "resources/map/maplayer.h"
 #include "resources/map/mapitem.h"
 #include "resources/map/objectslayer.h"
+#include "resources/map/pathfinder.h"
 #include "resources/map/speciallayer.h"
 #include "resources/map/tileset.h"
 #include "resources/map/walklayer.h"
@@ -45,8 +47,8 @@
 #include "resources/resourcemanager.h"
 #include "resources/subimage.h"
 
-#include "resources/map/location.h"
 #include "resources/map/mapobjectlist.h"
+#include "resources/map/metatile.h"
 #include "resources/map/tileanimation.h"
 
 #ifdef USE_OPENGL
@@ -59,10 +61,9 @@
 #include "utils/physfstools.h"
 #include "utils/timer.h"
 
-#include <queue>
-
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <climits>
 
 #include "debug.h"
@@ -70,14 +71,28 @@
 class ActorFunctuator final
 {
     public:
-        bool operator()(const Actor *const a, const Actor *const b) const
+        bool operator()(const std::pair<int, Actor*> &a,
+                        const std::pair<int, Actor*> &b) const
         {
-            if (!a || !b)
-                return false;
-            return a->getSortPixelY() < b->getSortPixelY();
+            return a.first < b.first;
         }
 } actorCompare;
 
+namespace
+{
+    // blockmask bit for each BlockType
+    const unsigned char blockTypeMasks[BlockType::NB_BLOCKTYPES] =
+    {
+        BlockMask::WALL,
+        BlockMask::CHARACTER,
+        BlockMask::MONSTER,
+        BlockMask::AIR,
+        BlockMask::WATER,
+        BlockMask::GROUND,
+        BlockMask::GROUNDTOP
+    };
+}  // namespace
+
 Map::Map(const int width, const int height,
          const int tileWidth, const int tileHeight) :
     Properties(),
@@ -85,14 +100,19 @@ Map::Map(const int width, const int height,
     mTileWidth(tileWidth), mTileHeight(tileHeight),
     mMaxTileHeight(height),
     mMetaTiles(new MetaTile[mWidth * mHeight]),
+    mPathFinder(new PathFinder(width, height)),
+    mAsyncPathFinder(nullptr),
     mWalkLayer(nullptr),
     mLayers(),
     mTilesets(),
     mActors(),
+    mActorsY(),
+    mNewActors(),
+    mSortedActors(0),
+    mRemovedActors(0),
     mHasWarps(false),
+    mPathTilesChanged(true),
     mDrawLayersFlags(MapType::NORMAL),
-    mOnClosedList(1),
-    mOnOpenList(2),
     mBackgrounds(),
     mForegrounds(),
     mLastAScrollX(0.0F),
@@ -133,22 +153,17 @@ Map::Map(const int width, const int height,
     mBeingOpacity(false),
     mCustom(false)
 {
-    const int size = mWidth * mHeight;
-    for (int i = 0; i < BlockType::NB_BLOCKTYPES; i++)
-    {
-        mOccupation[i] = new unsigned[static_cast<size_t>(size)];
-        memset(mOccupation[i], 0, static_cast<size_t>(size)
-            * sizeof(unsigned));
-    }
-
     config.addListener("OverlayDetail", this);
     config.addListener("guialpha", this);
     config.addListener("beingopacity", this);
+    config.addListener("useJumpPointSearch", this);
 
     if (mOpacity != 1.0F)
         mBeingOpacity = config.getBoolValue("beingopacity");
     else
         mBeingOpacity = false;
+    mPathFinder->setJumpPointSearch(config.getBoolValue(
+        "useJumpPointSearch"));
 }
 
 Map::~Map()
@@ -156,9 +171,10 @@ Map::~Map()
     config.removeListeners(this);
     CHECKLISTENERS
 
+    // stop path finder thread before tiles and walk layer removed
+    delete2(mAsyncPathFinder);
     delete [] mMetaTiles;
-    for (int i = 0; i < BlockType::NB_BLOCKTYPES; i++)
-        delete [] mOccupation[i];
+    delete2(mPathFinder);
 
     if (mWalkLayer)
     {
@@ -204,6 +220,14 @@ void Map::optionChanged(const std::string &value)
         else
             mBeingOpacity = false;
     }
+    else if (value == "useJumpPointSearch")
+    {
+        const bool jumpPointSearch = config.getBoolValue(
+            "useJumpPointSearch");
+        mPathFinder->setJumpPointSearch(jumpPointSearch);
+        if (mAsyncPathFinder)
+            mAsyncPathFinder->setJumpPointSearch(jumpPointSearch);
+    }
 }
 
 void Map::initializeAmbientLayers()
@@ -304,6 +328,9 @@ void Map::addTileset(Tileset *const tileset)
 
 void Map::update(const int ticks)
 {
+    if (mAsyncPathFinder)
+        mAsyncPathFinder->processResults();
+
     // Update animated tiles
     FOR_EACH (TileAnimationMapCIter, iAni, mTileAnimations)
     {
@@ -331,7 +358,7 @@ void Map::draw(Graphics *const graphics, int scrollX, int scrollY)
     // Make sure actors are sorted ascending by Y-coordinate
     // so that they overlap correctly
     BLOCK_START("Map::draw sort")
-        mActors.sort(actorCompare);
+    sortActors();
     BLOCK_END("Map::draw sort")
 
     // update scrolling of all ambient layers
@@ -415,9 +442,13 @@ void Map::draw(Graphics *const graphics, int scrollX, int scrollY)
             else
             {
 #ifdef USE_OPENGL
-                if (mOpenGL == RENDER_NORMAL_OPENGL
-                    || mOpenGL == RENDER_GLES_OPENGL
-                    || mOpenGL == RENDER_MODERN_OPENGL)
+                if (mOpenGL == RENDER_MODERN_OPENGL)
+                {
+                    layer->drawStatic(graphics, startX, startY,
+                        endX, endY, scrollX, scrollY, mDrawLayersFlags);
+                }
+                else if (mOpenGL == RENDER_NORMAL_OPENGL
+                         || mOpenGL == RENDER_GLES_OPENGL)
                 {
                     if (updateFlag)
                     {
@@ -634,43 +665,20 @@ const Tileset *Map::getTilesetWithGid(const int gid) const
 void Map::blockTile(const int x, const int y,
                     const BlockType::BlockType type)
 {
-    if (type == BlockType::NONE || !contains(x, y))
+    if (type == BlockType::NONE
+        || type >= BlockType::NB_BLOCKTYPES
+        || !contains(x, y))
+    {
         return;
+    }
 
-    const int tileNum = x + y * mWidth;
-
-    if (mOccupation[static_cast<size_t>(type)][tileNum] < UINT_MAX &&
-        (++mOccupation[static_cast<size_t>(type)][tileNum]) > 0)
+    // collision kept only in blockmask byte per tile, blocks never removed
+    MetaTile &tile = mMetaTiles[x + y * mWidth];
+    const unsigned char mask = blockTypeMasks[static_cast<size_t>(type)];
+    if (!(tile.blockmask & mask))
     {
-        switch (type)
-        {
-            case BlockType::WALL:
-                mMetaTiles[tileNum].blockmask |= BlockMask::WALL;
-                break;
-            case BlockType::CHARACTER:
-                mMetaTiles[tileNum].blockmask |= BlockMask::CHARACTER;
-                break;
-            case BlockType::MONSTER:
-                mMetaTiles[tileNum].blockmask |= BlockMask::MONSTER;
-                break;
-            case BlockType::AIR:
-                mMetaTiles[tileNum].blockmask |= BlockMask::AIR;
-                break;
-            case BlockType::WATER:
-                mMetaTiles[tileNum].blockmask |= BlockMask::WATER;
-                break;
-            case BlockType::GROUND:
-                mMetaTiles[tileNum].blockmask |= BlockMask::GROUND;
-                break;
-            case BlockType::GROUNDTOP:
-                mMetaTiles[tileNum].blockmask |= BlockMask::GROUNDTOP;
-                break;
-            default:
-            case BlockType::NONE:
-            case BlockType::NB_BLOCKTYPES:
-                // Do nothing.
-                break;
-        }
+        tile.blockmask |= mask;
+        mPathTilesChanged = true;
     }
 }
 
@@ -710,19 +718,103 @@ const MetaTile *Map::getMetaTile(const int x, const int y) const
     return &mMetaTiles[x + y * mWidth];
 }
 
-Actors::iterator Map::addActor(Actor *const actor)
+int Map::addActor(Actor *const actor)
 {
-    mActors.push_front(actor);
+    mActors.push_back(actor);
+    mActorsY.push_back(0);
 //    mSpritesUpdated = true;
-    return mActors.begin();
+    return static_cast<int>(mActors.size() - 1);
 }
 
-void Map::removeActor(const Actors::iterator &iterator)
+void Map::removeActor(const int index)
 {
-    mActors.erase(iterator);
+    // removed actors dropped in sortActors, to keep indexes valid
+    mActors[index] = nullptr;
+    mRemovedActors ++;
 //    mSpritesUpdated = true;
 }
 
+void Map::sortActors()
+{
+    const size_t sz = mActors.size();
+    size_t sorted = 0;
+    size_t cnt = 0;
+    for (size_t src = 0; src < sz; src ++)
+    {
+        if (src == mSortedActors)
+            sorted = cnt;
+        Actor *const actor = mActors[src];
+        if (!actor)
+            continue;
+        mActors[cnt] = actor;
+        mActorsY[cnt] = actor->getSortPixelY();
+        cnt ++;
+    }
+    if (mSortedActors >= sz)
+        sorted = cnt;
+    mActors.resize(cnt);
+    mActorsY.resize(cnt);
+    mRemovedActors = 0;
+
+    // actors sorted in previous frame moved only a bit,
+    // so insertion sort is near linear here.
+    for (size_t f = 1; f < sorted; f ++)
+    {
+        const int y = mActorsY[f];
+        if (mActorsY[f - 1] <= y)
+            continue;
+        Actor *const actor = mActors[f];
+        size_t k = f;
+        do
+        {
+            mActors[k] = mActors[k - 1];
+            mActorsY[k] = mActorsY[k - 1];
+            k --;
+        }
+        while (k > 0 && mActorsY[k - 1] > y);
+        mActors[k] = actor;
+        mActorsY[k] = y;
+    }
+
+    // sort new actors and merge them from end
+    if (sorted < cnt)
+    {
+        mNewActors.clear();
+        for (size_t f = sorted; f < cnt; f ++)
+        {
+            mNewActors.push_back(std::pair<int, Actor*>(
+                mActorsY[f], mActors[f]));
+        }
+        std::stable_sort(mNewActors.begin(), mNewActors.end(),
+            actorCompare);
+
+        size_t oldPos = sorted;
+        size_t newPos = mNewActors.size();
+        size_t dst = cnt;
+        while (newPos > 0)
+        {
+            dst --;
+            if (oldPos > 0
+                && mActorsY[oldPos - 1] > mNewActors[newPos - 1].first)
+            {
+                oldPos --;
+                mActors[dst] = mActors[oldPos];
+                mActorsY[dst] = mActorsY[oldPos];
+            }
+            else
+            {
+                newPos --;
+                mActors[dst] = mNewActors[newPos].second;
+                mActorsY[dst] = mNewActors[newPos].first;
+            }
+        }
+    }
+
+    for (size_t f = 0; f < cnt; f ++)
+        mActors[f]->mMapActor = static_cast<int>(f);
+    mSortedActors = cnt;
+}
+
 const std::string Map::getMusicFile() const
 {
     return getProperty("music");
@@ -749,234 +841,53 @@ Path Map::findPath(const int startX, const int startY,
                    const int maxCost)
 {
     BLOCK_START("Map::findPath")
-    // The basic walking cost of a tile.
-    static const int basicCost = 100;
-    const int basicCost2 = 100 * 362 / 256;
-    const float basicCostF = 100.0 * 362 / 256;
-
-    // Path to be built up (empty by default)
-    Path path;
-
-    if (startX >= mWidth || startY >= mHeight || startX < 0 || startY < 0)
-    {
-        BLOCK_END("Map::findPath")
-        return path;
-    }
-
-    // Return when destination not walkable
-    if (!getWalk(destX, destY, blockWalkMask))
-    {
-        BLOCK_END("Map::findPath")
-        return path;
-    }
-
-    // Reset starting tile's G cost to 0
-    MetaTile *const startTile = &mMetaTiles[startX + startY * mWidth];
-    if (!startTile)
-    {
-        BLOCK_END("Map::findPath")
-        return path;
-    }
-
-    startTile->Gcost = 0;
-
-    // Declare open list, a list with open tiles sorted on F cost
-    std::priority_queue<Location> openList;
-
-    // Add the start point to the open list
-    openList.push(Location(startX, startY, startTile));
-
-    bool foundPath = false;
-
-    // Keep trying new open tiles until no more tiles to try or target found
-    while (!openList.empty() && !foundPath)
-    {
-        // Take the location with the lowest F cost from the open list.
-        const Location curr = openList.top();
-        openList.pop();
-
-        const MetaTile *const tile = curr.tile;
-
-        // If the tile is already on the closed list, this means it has already
-        // been processed with a shorter path to the start point (lower G cost)
-        if (tile->whichList == mOnClosedList)
-            continue;
-
-        // Put the current tile on the closed list
-        curr.tile->whichList = mOnClosedList;
-
-        const int curWidth = curr.y * mWidth;
-        const int tileGcost = tile->Gcost;
-
-        // Check the adjacent tiles
-        for (int dy = -1; dy <= 1; dy++)
-        {
-            const int y = curr.y + dy;
-            if (y < 0 || y >= mHeight)
-                continue;
-
-            const int yWidth = y * mWidth;
-            const int dy1 = std::abs(y - destY);
-
-            for (int dx = -1; dx <= 1; dx++)
-            {
-                // Calculate location of tile to check
-                const int x = curr.x + dx;
-
-                // Skip if if we're checking the same tile we're leaving from,
-                // or if the new location falls outside of the map boundaries
-                if ((dx == 0 && dy == 0) || x < 0 || x >= mWidth)
-                    continue;
-
-                MetaTile *const newTile = &mMetaTiles[x + yWidth];
-
-                // Skip if the tile is on the closed list or is not walkable
-                // unless its the destination tile
-                // +++ here need check block must depend on player abilities.
-                if (newTile->whichList == mOnClosedList ||
-                    ((newTile->blockmask & blockWalkMask)
-                    && !(x == destX && y == destY))
-                    || (newTile->blockmask & BlockMask::WALL))
-                {
-                    continue;
-                }
-
-                // When taking a diagonal step, verify that we can skip the
-                // corner.
-                if (dx != 0 && dy != 0)
-                {
-                    const MetaTile *const t1 = &mMetaTiles[curr.x +
-                        (curr.y + dy) * mWidth];
-                    const MetaTile *const t2 = &mMetaTiles[curr.x +
-                        dx + curWidth];
-
-                    // +++ here need check block must depend
-                    // on player abilities.
-                    if (((t1->blockmask | t2->blockmask) & BlockMask::WALL))
-                        continue;
-                }
-
-                // Calculate G cost for this route, ~sqrt(2) for moving diagonal
-                int Gcost = tileGcost + (dx == 0 || dy == 0
-                    ? basicCost : basicCost2);
-
-                /* Demote an arbitrary direction to speed pathfinding by
-                   adding a defect (TODO: change depending on the desired
-                   visual effect, e.g. a cross-product defect toward
-                   destination).
-                   Important: as long as the total defect along any path is
-                   less than the basicCost, the pathfinder will still find one
-                   of the shortest paths! */
-                if (dx == 0 || dy == 0)
-                {
-                    // Demote horizontal and vertical directions, so that two
-                    // consecutive directions cannot have the same Fcost.
-                    ++Gcost;
-                }
-
-                // It costs extra to walk through a being (needs to be enough
-                // to make it more attractive to walk around).
-//                if (occupied(x, y))
-//                {
-//                    Gcost += 3 * basicCost;
-//                }
-
-                // Skip if Gcost becomes too much
-                // Warning: probably not entirely accurate
-                if (maxCost > 0 && Gcost > maxCost * basicCost)
-                    continue;
-
-                if (newTile->whichList != mOnOpenList)
-                {
-                    // Found a new tile (not on open nor on closed list)
-
-                    /* Update Hcost of the new tile. The pathfinder does not
-                       work reliably if the heuristic cost is higher than the
-                       real cost. In particular, using Manhattan distance is
-                       forbidden here. */
-                    const int dx1 = std::abs(x - destX);
-                    newTile->Hcost = std::abs(dx1 - dy1) * basicCost +
-                        std::min(dx1, dy1) * (basicCostF);
-
-                    // Set the current tile as the parent of the new tile
-                    newTile->parentX = curr.x;
-                    newTile->parentY = curr.y;
-
-                    // Update Gcost and Fcost of new tile
-                    newTile->Gcost = Gcost;
-                    newTile->Fcost = Gcost + newTile->Hcost;
-
-                    if (x != destX || y != destY)
-                    {
-                        // Add this tile to the open list
-                        newTile->whichList = mOnOpenList;
-                        openList.push(Location(x, y, newTile));
-                    }
-                    else
-                    {
-                        // Target location was found
-                        foundPath = true;
-                    }
-                }
-                else if (Gcost < newTile->Gcost)
-                {
-                    // Found a shorter route.
-                    // Update Gcost and Fcost of the new tile
-                    newTile->Gcost = Gcost;
-                    newTile->Fcost = Gcost + newTile->Hcost;
-
-                    // Set the current tile as the parent of the new tile
-                    newTile->parentX = curr.x;
-                    newTile->parentY = curr.y;
-
-                    // Add this tile to the open list (it's already
-                    // there, but this instance has a lower F score)
-                    openList.push(Location(x, y, newTile));
-                }
-            }
-        }
-    }
+    const Path path = mPathFinder->findPath(mMetaTiles,
+        startX, startY,
+        destX, destY,
+        blockWalkMask,
+        maxCost);
+    BLOCK_END("Map::findPath")
+    return path;
+}
 
-    // Two new values to indicate whether a tile is on the open or closed list,
-    // this way we don't have to clear all the values between each pathfinding.
-    if (mOnOpenList > UINT_MAX - 2)
+void Map::findPathAsync(PathListener *const listener,
+                        const int startX, const int startY,
+                        const int destX, const int destY,
+                        const unsigned char blockWalkMask,
+                        const int maxCost)
+{
+    if (!mAsyncPathFinder)
     {
-        // We reset the list memebers value.
-        mOnClosedList = 1;
-        mOnOpenList = 2;
-
-        // Clean up the metaTiles
-        const int size = mWidth * mHeight;
-        for (int i = 0; i < size; ++i)
-            mMetaTiles[i].whichList = 0;
+        mAsyncPathFinder = new AsyncPathFinder(mWidth, mHeight);
+        mAsyncPathFinder->setWalkLayer(mWalkLayer);
+        mAsyncPathFinder->setJumpPointSearch(config.getBoolValue(
+            "useJumpPointSearch"));
+        mPathTilesChanged = true;
     }
-    else
+    if (mPathTilesChanged)
     {
-        mOnClosedList += 2;
-        mOnOpenList += 2;
+        mAsyncPathFinder->setTiles(mMetaTiles);
+        mPathTilesChanged = false;
     }
+    mAsyncPathFinder->addRequest(listener,
+        startX, startY,
+        destX, destY,
+        blockWalkMask,
+        maxCost);
+}
 
-    // If a path has been found, iterate backwards using the parent locations
-    // to extract it.
-    if (foundPath)
-    {
-        int pathX = destX;
-        int pathY = destY;
-
-        while (pathX != startX || pathY != startY)
-        {
-            // Add the new path node to the start of the path list
-            path.push_front(Position(pathX, pathY));
-
-            // Find out the next parent
-            const MetaTile *const tile = &mMetaTiles[pathX + pathY * mWidth];
-            pathX = tile->parentX;
-            pathY = tile->parentY;
-        }
-    }
+void Map::cancelPath(const PathListener *const listener)
+{
+    if (mAsyncPathFinder)
+        mAsyncPathFinder->cancel(listener);
+}
 
-    BLOCK_END("Map::findPath")
-    return path;
+void Map::setWalkLayer(WalkLayer *const layer)
+{
+    mWalkLayer = layer;
+    mPathFinder->setWalkLayer(layer);
+    if (mAsyncPathFinder)
+        mAsyncPathFinder->setWalkLayer(layer);
 }
 
 void Map::addParticleEffect(const std::string &effectFile,
@@ -43,7 +43,10 @@ class MapHeights;
 class MapItem;
 class MapLayer;
 class ObjectsLayer;
+class AsyncPathFinder;
 class Particle;
+class PathFinder;
+class PathListener;
 class Resource;
 class SpecialLayer;
 class Tileset;
@@ -199,6 +202,21 @@ class Map final : public Properties, public ConfigListener
                       const unsigned char blockWalkmask,
                       const int maxCost = 20) A_WARN_UNUSED;
 
+        /**
+         * Find a path in path finder thread. Path is sent to listener
+         * from update. Previous request of listener is cancelled.
+         */
+        void findPathAsync(PathListener *const listener,
+                           const int startX, const int startY,
+                           const int destX, const int destY,
+                           const unsigned char blockWalkmask,
+                           const int maxCost = 20);
+
+        /**
+         * Cancels async path request of listener.
+         */
+        void cancelPath(const PathListener *const listener);
+
         /**
          * Adds a particle effect
          */
@@ -267,7 +285,7 @@ class Map final : public Properties, public ConfigListener
         MapItem *findPortalXY(const int x, const int y) const A_WARN_UNUSED;
 
         int getActorsCount() const A_WARN_UNUSED
-        { return static_cast<int>(mActors.size()); }
+        { return static_cast<int>(mActors.size()) - mRemovedActors; }
 
         void setPvpMode(const int mode);
 
@@ -316,8 +334,7 @@ class Map final : public Properties, public ConfigListener
         WalkLayer *getWalkLayer()
         { return mWalkLayer; }
 
-        void setWalkLayer(WalkLayer *const layer)
-        { mWalkLayer = layer; }
+        void setWalkLayer(WalkLayer *const layer);
 
         void addHeights(MapHeights *const heights);
 
@@ -330,14 +347,20 @@ class Map final : public Properties, public ConfigListener
         friend class Minimap;
 
         /**
-         * Adds an actor to the map.
+         * Adds an actor to the map, returns actor index.
          */
-        Actors::iterator addActor(Actor *const actor);
+        int addActor(Actor *const actor);
 
         /**
          * Removes an actor from the map.
          */
-        void removeActor(const Actors::iterator &iterator);
+        void removeActor(const int index);
+
+        /**
+         * Sorts actors ascending by sort Y coordinate, so that they
+         * overlap correctly.
+         */
+        void sortActors();
 
     private:
         enum LayerType
@@ -362,29 +385,30 @@ class Map final : public Properties, public ConfigListener
          */
         bool contains(const int x, const int y) const A_WARN_UNUSED;
 
-        /**
-         * Blockmasks for different entities
-         */
-        unsigned *mOccupation[BlockType::NB_BLOCKTYPES];
-
         int mWidth;
         int mHeight;
         int mTileWidth, mTileHeight;
         int mMaxTileHeight;
         MetaTile *mMetaTiles;
+        PathFinder *mPathFinder;
+        AsyncPathFinder *mAsyncPathFinder;
         WalkLayer *mWalkLayer;
         Layers mLayers;
         Tilesets mTilesets;
         Actors mActors;
+        // sort Y of actors from last sortActors call
+        std::vector<int> mActorsY;
+        // actors added after last sortActors call
+        std::vector<std::pair<int, Actor*> > mNewActors;
+        size_t mSortedActors;
+        int mRemovedActors;
         bool mHasWarps;
+        // tiles changed after last copy to async path finder
+        bool mPathTilesChanged;
 
         // draw flags
         MapType::MapType mDrawLayersFlags;
 
-        // Pathfinding members
-        unsigned int mOnClosedList;
-        unsigned int mOnOpenList;
-
         // Overlay data
         AmbientLayerVector mBackgrounds;
         AmbientLayerVector mForegrounds;
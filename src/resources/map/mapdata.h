@@ -0,0 +1,172 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_MAPDATA_H
+#define RESOURCES_MAP_MAPDATA_H
+
+#include "resources/map/maplayer.h"
+
+#include "utils/delete2.h"
+#include "utils/dtor.h"
+#include "utils/mappedfile.h"
+
+#include <string>
+#include <vector>
+
+#include "localconsts.h"
+
+/**
+ * Tile layer decoded from map file. Gids point to own tiles vector or to
+ * compiled map file memory.
+ */
+struct MapLayerData final
+{
+    MapLayerData() :
+        name(),
+        tiles(),
+        gids(nullptr),
+        type(MapLayer::TILES),
+        offsetX(0),
+        offsetY(0),
+        width(0),
+        height(0),
+        mask(1),
+        isFringe(false),
+        hasData(false)
+    {
+    }
+
+    A_DELETE_COPY(MapLayerData)
+
+    std::string name;
+    std::vector<int> tiles;
+    const int *gids;
+    MapLayer::Type type;
+    int offsetX;
+    int offsetY;
+    int width;
+    int height;
+    int mask;
+    bool isFringe;
+    // false for hidden layers and layers without data
+    bool hasData;
+};
+
+struct MapObjectData final
+{
+    MapObjectData() :
+        type(),
+        name(),
+        x(0),
+        y(0),
+        width(0),
+        height(0)
+    {
+    }
+
+    std::string type;
+    std::string name;
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+namespace MapDataEntryType
+{
+    enum Type
+    {
+        TILESET = 0,
+        LAYER,
+        PROPERTIES,
+        OBJECTGROUP
+    };
+}  // namespace MapDataEntryType
+
+typedef std::pair<std::string, std::string> MapPropertyData;
+
+/**
+ * Top level element of map file. Only fields of own type used.
+ */
+struct MapDataEntry final
+{
+    explicit MapDataEntry(const MapDataEntryType::Type type0) :
+        text(),
+        properties(),
+        objects(),
+        layer(nullptr),
+        type(type0),
+        offsetX(0),
+        offsetY(0)
+    {
+    }
+
+    A_DELETE_COPY(MapDataEntry)
+
+    ~MapDataEntry()
+    {
+        delete2(layer);
+    }
+
+    // tileset xml
+    std::string text;
+    std::vector<MapPropertyData> properties;
+    std::vector<MapObjectData> objects;
+    MapLayerData *layer;
+    MapDataEntryType::Type type;
+    // object group offset in tiles
+    int offsetX;
+    int offsetY;
+};
+
+/**
+ * Map file contents after xml parsing and layer decoding, in file order.
+ * Can be stored in compiled map cache.
+ */
+struct MapData final
+{
+    MapData() :
+        entries(),
+        file(nullptr),
+        width(0),
+        height(0),
+        tileWidth(0),
+        tileHeight(0)
+    {
+    }
+
+    A_DELETE_COPY(MapData)
+
+    ~MapData()
+    {
+        delete_all(entries);
+        delete2(file);
+    }
+
+    std::vector<MapDataEntry*> entries;
+    // compiled map file what layer gids point to
+    MappedFile *file;
+    int width;
+    int height;
+    int tileWidth;
+    int tileHeight;
+};
+
+#endif  // RESOURCES_MAP_MAPDATA_H
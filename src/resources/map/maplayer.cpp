@@ -40,8 +40,16 @@
 #include "resources/map/maptype.h"
 #include "resources/map/speciallayer.h"
 
+#include "utils/delete2.h"
+
 #include "debug.h"
 
+namespace
+{
+    // tiles per side of static layer chunk
+    const int staticChunkSize = 32;
+}  // namespace
+
 MapLayer::MapLayer(const int x, const int y,
                    const int width, const int height,
                    const bool fringeLayer,
@@ -54,6 +62,9 @@ MapLayer::MapLayer(const int x, const int y,
     mSpecialLayer(nullptr),
     mTempLayer(nullptr),
     mTempRows(),
+    mStaticChunks(),
+    mStaticChunksX(0),
+    mStaticDrawFlags(-1),
     mMask(mask),
     mIsFringeLayer(fringeLayer),
     mHighlightAttackRange(config.getBoolValue("highlightAttackRange"))
@@ -70,6 +81,8 @@ MapLayer::~MapLayer()
     delete [] mTiles;
     delete_all(mTempRows);
     mTempRows.clear();
+    delete_all(mStaticChunks);
+    mStaticChunks.clear();
 }
 
 void MapLayer::optionChanged(const std::string &value)
@@ -84,6 +97,16 @@ void MapLayer::optionChanged(const std::string &value)
 void MapLayer::setTile(const int x, const int y, Image *const img)
 {
     mTiles[x + y * mWidth] = img;
+    if (!mStaticChunks.empty())
+        resetStaticChunk(x, y);
+}
+
+void MapLayer::resetStaticChunk(const int x, const int y)
+{
+    // animated tiles change layer after upload, chunk rebuilt on next draw
+    MapRowVertexes *&chunk = mStaticChunks[x / staticChunkSize
+        + y / staticChunkSize * mStaticChunksX];
+    delete2(chunk);
 }
 
 void MapLayer::draw(Graphics *const graphics,
@@ -359,6 +382,131 @@ void MapLayer::drawOGL(Graphics *const graphics)
     BLOCK_END("MapLayer::drawOGL")
 //    logger->log("draws: %d", k);
 }
+
+MapRowVertexes *MapLayer::updateStaticChunk(Graphics *const graphics,
+                                            const int chunkX,
+                                            const int chunkY)
+{
+    BLOCK_START("MapLayer::updateStaticChunk")
+    const int startX = chunkX * staticChunkSize;
+    const int startY = chunkY * staticChunkSize;
+    const int endX = std::min(startX + staticChunkSize, mWidth);
+    const int endY = std::min(startY + staticChunkSize, mHeight);
+
+    // vertexes kept in layer coordinates, clip area offset added by
+    // calcTileVertexes removed here and applied again on draw
+    const ClipRect *const clipArea = graphics->getCurrentClipArea();
+    const int offsetX = clipArea ? clipArea->xOffset : 0;
+    const int offsetY = clipArea ? clipArea->yOffset : 0;
+    const bool flag = (mStaticDrawFlags != MapType::SPECIAL
+        && mStaticDrawFlags != MapType::SPECIAL2
+        && mStaticDrawFlags != MapType::SPECIAL4);
+
+    MapRowVertexes *const chunk = new MapRowVertexes();
+    mStaticChunks[chunkX + chunkY * mStaticChunksX] = chunk;
+    Image *lastImage = nullptr;
+    ImageVertexes *imgVert = nullptr;
+    typedef std::map<int, ImageVertexes*> ImageVertexesMap;
+    ImageVertexesMap imgSet;
+
+    for (int y = startY; y < endY; y++)
+    {
+        const int py0 = (y + 1) * mapTileSize - offsetY;
+        Image **tilePtr = mTiles + static_cast<size_t>(startX + y * mWidth);
+        for (int x = startX; x < endX; x++, tilePtr++)
+        {
+            Image *const img = *tilePtr;
+            if (!img || (!flag && img->mBounds.h > mapTileSize))
+                continue;
+
+            const GLuint imgGlImage = img->mGLImage;
+            if (!lastImage || lastImage->mGLImage != imgGlImage)
+            {
+                if (img->mBounds.w > mapTileSize)
+                    imgSet.clear();
+
+                if (imgSet.find(imgGlImage) != imgSet.end())
+                {
+                    imgVert = imgSet[imgGlImage];
+                }
+                else
+                {
+                    if (lastImage)
+                        imgSet[lastImage->mGLImage] = imgVert;
+                    imgVert = new ImageVertexes();
+                    imgVert->ogl.init();
+                    imgVert->image = img;
+                    chunk->images.push_back(imgVert);
+                }
+            }
+            lastImage = img;
+            graphics->calcTileVertexes(imgVert, img,
+                x * mapTileSize - offsetX,
+                py0 - img->mBounds.h);
+        }
+    }
+    FOR_EACH (MapRowImages::iterator, it, chunk->images)
+        graphics->finalize(*it);
+    BLOCK_END("MapLayer::updateStaticChunk")
+    return chunk;
+}
+
+void MapLayer::drawStatic(Graphics *const graphics,
+                          int startX, int startY,
+                          int endX, int endY,
+                          const int scrollX, const int scrollY,
+                          const int layerDrawFlags)
+{
+    BLOCK_START("MapLayer::drawStatic")
+    if (mStaticDrawFlags != layerDrawFlags || mStaticChunks.empty())
+    {
+        // chunks built on first draw, so only visible parts uploaded
+        delete_all(mStaticChunks);
+        mStaticChunksX = (mWidth + staticChunkSize - 1) / staticChunkSize;
+        mStaticChunks.assign(mStaticChunksX * ((mHeight + staticChunkSize
+            - 1) / staticChunkSize), static_cast<MapRowVertexes*>(nullptr));
+        mStaticDrawFlags = layerDrawFlags;
+    }
+
+    startX -= mX;
+    startY -= mY;
+    endX -= mX;
+    endY -= mY;
+
+    if (startX < 0)
+        startX = 0;
+    if (startY < 0)
+        startY = 0;
+    if (endX > mWidth)
+        endX = mWidth;
+    if (endY > mHeight)
+        endY = mHeight;
+
+    if (startX >= endX || startY >= endY)
+    {
+        BLOCK_END("MapLayer::drawStatic")
+        return;
+    }
+
+    const int dx = (mX * mapTileSize) - scrollX;
+    const int dy = (mY * mapTileSize) - scrollY;
+    const int chunkEndX = (endX - 1) / staticChunkSize;
+    const int chunkEndY = (endY - 1) / staticChunkSize;
+
+    for (int cy = startY / staticChunkSize; cy <= chunkEndY; cy ++)
+    {
+        for (int cx = startX / staticChunkSize; cx <= chunkEndX; cx ++)
+        {
+            const MapRowVertexes *chunk = mStaticChunks[
+                cx + cy * mStaticChunksX];
+            if (!chunk)
+                chunk = updateStaticChunk(graphics, cx, cy);
+            FOR_EACH (MapRowImages::const_iterator, it, chunk->images)
+                graphics->drawStaticVertexes(*it, dx, dy);
+        }
+    }
+    BLOCK_END("MapLayer::drawStatic")
+}
 #endif
 
 void MapLayer::drawFringe(Graphics *const graphics, int startX, int startY,
@@ -73,7 +73,11 @@ class MapLayer final: public ConfigListener
          * Set tile image with x + y * width already known.
          */
         void setTile(const int index, Image *const img)
-        { mTiles[index] = img; }
+        {
+            mTiles[index] = img;
+            if (!mStaticChunks.empty())
+                resetStaticChunk(index % mWidth, index / mWidth);
+        }
 
         /**
          * Draws this layer to the given graphics context. The coordinates are
@@ -98,6 +102,17 @@ class MapLayer final: public ConfigListener
                        int endX, int endY,
                        const int scrollX, const int scrollY,
                        const int layerDrawFlags);
+
+        /**
+         * Draws layer from vertexes uploaded once per map in chunks of
+         * fixed size. Only chunks inside given tiles range are drawn,
+         * scrolling applied as draw offset.
+         */
+        void drawStatic(Graphics *const graphics,
+                        int startX, int startY,
+                        int endX, int endY,
+                        const int scrollX, const int scrollY,
+                        const int layerDrawFlags);
 #endif
 
         void updateSDL(const Graphics *const graphics,
@@ -135,6 +150,14 @@ class MapLayer final: public ConfigListener
                                     int &width) A_WARN_UNUSED;
 
     private:
+#ifdef USE_OPENGL
+        MapRowVertexes *updateStaticChunk(Graphics *const graphics,
+                                          const int chunkX,
+                                          const int chunkY);
+#endif
+
+        void resetStaticChunk(const int x, const int y);
+
         int mX;
         int mY;
         int mWidth;
@@ -144,6 +167,9 @@ class MapLayer final: public ConfigListener
         SpecialLayer *mTempLayer;
         typedef std::vector<MapRowVertexes*> MapRows;
         MapRows mTempRows;
+        MapRows mStaticChunks;
+        int mStaticChunksX;
+        int mStaticDrawFlags;
         int mMask;
         bool mIsFringeLayer;    /**< Whether the actors are drawn. */
         bool mHighlightAttackRange;
@@ -35,19 +35,12 @@ struct MetaTile final
     /**
      * Constructor.
      */
-    MetaTile() : Fcost(0), Gcost(0), Hcost(0), whichList(0),
-        parentX(0), parentY(0), blockmask(0)
+    MetaTile() : blockmask(0)
     {}
 
     A_DELETE_COPY(MetaTile)
 
-    // Pathfinding members
-    int Fcost;               /**< Estimation of total path cost */
-    int Gcost;               /**< Cost from start to this location */
-    int Hcost;               /**< Estimated cost to goal */
-    unsigned whichList;      /**< No list, open list or closed list */
-    int parentX;             /**< X coordinate of parent tile */
-    int parentY;             /**< Y coordinate of parent tile */
+    // Pathfinding state stored in PathFinder
     unsigned char blockmask; /**< Blocking properties of this tile */
 };
 #endif  // RESOURCES_MAP_METATILE_H
@@ -0,0 +1,588 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/pathfinder.h"
+
+#include "navigationmanager.h"
+
+#include "resources/map/blockmask.h"
+#include "resources/map/metatile.h"
+#include "resources/map/walklayer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "debug.h"
+
+// heapIndex of nodes already processed in current search
+static const int CLOSED = -1;
+
+// The basic walking cost of a tile.
+static const int basicCost = 100;
+// ~sqrt(2) for moving diagonal
+static const int basicCost2 = 100 * 362 / 256;
+static const float basicCostF = 100.0 * 362 / 256;
+
+/* Estimated cost to goal. The pathfinder does not work reliably if the
+   heuristic cost is higher than the real cost. In particular, using
+   Manhattan distance is forbidden here. */
+static int getHcost(const int dx, const int dy) A_WARN_UNUSED;
+static int getHcost(const int dx, const int dy)
+{
+    return std::abs(dx - dy) * basicCost +
+        static_cast<int>(std::min(dx, dy) * (basicCostF));
+}
+
+PathFinder::PathFinder(const int width, const int height) :
+    mWidth(width),
+    mHeight(height),
+    mGeneration(0),
+    mNodes(),
+    mHeap(),
+    mTiles(nullptr),
+    mWalkLayer(nullptr),
+    mWalkMask(0),
+    mJumpPointSearch(false)
+{
+}
+
+void PathFinder::heapUp(int pos)
+{
+    const int tile = mHeap[pos];
+    const int Fcost = mNodes[tile].Fcost;
+    while (pos > 0)
+    {
+        const int parentPos = (pos - 1) / 2;
+        const int parentTile = mHeap[parentPos];
+        if (mNodes[parentTile].Fcost <= Fcost)
+            break;
+        mHeap[pos] = parentTile;
+        mNodes[parentTile].heapIndex = pos;
+        pos = parentPos;
+    }
+    mHeap[pos] = tile;
+    mNodes[tile].heapIndex = pos;
+}
+
+void PathFinder::heapDown(int pos)
+{
+    const int size = static_cast<int>(mHeap.size());
+    const int tile = mHeap[pos];
+    const int Fcost = mNodes[tile].Fcost;
+    for (;;)
+    {
+        int child = pos * 2 + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && mNodes[mHeap[child + 1]].Fcost
+            < mNodes[mHeap[child]].Fcost)
+        {
+            child ++;
+        }
+        const int childTile = mHeap[child];
+        if (mNodes[childTile].Fcost >= Fcost)
+            break;
+        mHeap[pos] = childTile;
+        mNodes[childTile].heapIndex = pos;
+        pos = child;
+    }
+    mHeap[pos] = tile;
+    mNodes[tile].heapIndex = pos;
+}
+
+void PathFinder::heapPush(const int tile)
+{
+    mHeap.push_back(tile);
+    heapUp(static_cast<int>(mHeap.size()) - 1);
+}
+
+int PathFinder::heapPop()
+{
+    const int tile = mHeap[0];
+    const int last = mHeap.back();
+    mHeap.pop_back();
+    if (!mHeap.empty())
+    {
+        mHeap[0] = last;
+        heapDown(0);
+    }
+    return tile;
+}
+
+Path PathFinder::findPath(const MetaTile *const tiles,
+                          const int startX, const int startY,
+                          const int destX, const int destY,
+                          const unsigned char blockWalkMask,
+                          const int maxCost)
+{
+    // Path to be built up (empty by default)
+    Path path;
+
+    if (!tiles || startX >= mWidth || startY >= mHeight
+        || startX < 0 || startY < 0)
+    {
+        return path;
+    }
+
+    // Return when destination not walkable
+    if (destX < 0 || destY < 0 || destX >= mWidth || destY >= mHeight
+        || (tiles[destX + destY * mWidth].blockmask & blockWalkMask))
+    {
+        return path;
+    }
+
+    // Walk layer regions connected with more permissive mask, so tiles
+    // from different regions never connected for this mask.
+    if (mWalkLayer && (blockWalkMask & NavigationManager::blockWalkMask)
+        == NavigationManager::blockWalkMask)
+    {
+        const int startRegion = mWalkLayer->getDataAt(startX, startY);
+        const int destRegion = mWalkLayer->getDataAt(destX, destY);
+        if (startRegion > 0 && destRegion > 0 && startRegion != destRegion)
+            return path;
+    }
+
+    if (mNodes.empty())
+        mNodes.resize(static_cast<size_t>(mWidth * mHeight));
+
+    // New generation value marks all nodes as untouched, this way we don't
+    // have to clear all the values between each pathfinding.
+    mGeneration ++;
+    if (!mGeneration)
+    {
+        const size_t size = mNodes.size();
+        for (size_t f = 0; f < size; f ++)
+            mNodes[f].generation = 0;
+        mGeneration = 1;
+    }
+    mHeap.clear();
+
+    const int startTile = startX + startY * mWidth;
+    const int destTile = destX + destY * mWidth;
+    Node &startNode = mNodes[startTile];
+    startNode.Gcost = 0;
+    startNode.Fcost = 0;
+    startNode.parent = startTile;
+    startNode.generation = mGeneration;
+    heapPush(startTile);
+
+    bool foundPath;
+    if (mJumpPointSearch)
+    {
+        foundPath = searchJumpPoints(tiles, destTile,
+            blockWalkMask, maxCost);
+    }
+    else
+    {
+        foundPath = searchAStar(tiles, destTile,
+            blockWalkMask, maxCost);
+    }
+
+    // If a path has been found, iterate backwards using the parent locations
+    // to extract it. Jump points expanded to all tiles between them.
+    if (foundPath)
+    {
+        int tile = destTile;
+        while (tile != startTile)
+        {
+            const int parent = mNodes[tile].parent;
+            const int parentX = parent % mWidth;
+            const int parentY = parent / mWidth;
+            int x = tile % mWidth;
+            int y = tile / mWidth;
+            const int dx = (x > parentX) - (x < parentX);
+            const int dy = (y > parentY) - (y < parentY);
+            while (x != parentX || y != parentY)
+            {
+                // Add the new path node to the start of the path list
+                path.push_front(Position(x, y));
+                x -= dx;
+                y -= dy;
+            }
+
+            // Find out the next parent
+            tile = parent;
+        }
+    }
+
+    return path;
+}
+
+bool PathFinder::searchAStar(const MetaTile *const tiles,
+                             const int destTile,
+                             const unsigned char blockWalkMask,
+                             const int maxCost)
+{
+    const unsigned generation = mGeneration;
+    const int destX = destTile % mWidth;
+    const int destY = destTile / mWidth;
+    bool foundPath = false;
+
+    // Keep trying new open tiles until no more tiles to try or target found
+    while (!mHeap.empty() && !foundPath)
+    {
+        // Take the location with the lowest F cost from the open list.
+        const int currTile = heapPop();
+        Node &curr = mNodes[currTile];
+        const int currX = currTile % mWidth;
+        const int currY = currTile / mWidth;
+
+        // Put the current tile on the closed list
+        curr.heapIndex = CLOSED;
+        const int tileGcost = curr.Gcost;
+
+        // Check the adjacent tiles
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            const int y = currY + dy;
+            if (y < 0 || y >= mHeight)
+                continue;
+
+            const int yWidth = y * mWidth;
+            const int dy1 = std::abs(y - destY);
+
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                // Calculate location of tile to check
+                const int x = currX + dx;
+
+                // Skip if if we're checking the same tile we're leaving from,
+                // or if the new location falls outside of the map boundaries
+                if ((dx == 0 && dy == 0) || x < 0 || x >= mWidth)
+                    continue;
+
+                const int newTile = x + yWidth;
+                Node &node = mNodes[newTile];
+                const bool touched = node.generation == generation;
+
+                // Skip if the tile is on the closed list or is not walkable
+                // unless its the destination tile
+                // +++ here need check block must depend on player abilities.
+                const unsigned char blockmask = tiles[newTile].blockmask;
+                if ((touched && node.heapIndex == CLOSED) ||
+                    ((blockmask & blockWalkMask) && newTile != destTile)
+                    || (blockmask & BlockMask::WALL))
+                {
+                    continue;
+                }
+
+                // When taking a diagonal step, verify that we can skip the
+                // corner.
+                if (dx != 0 && dy != 0)
+                {
+                    // +++ here need check block must depend
+                    // on player abilities.
+                    if ((tiles[currX + yWidth].blockmask
+                        | tiles[currTile + dx].blockmask) & BlockMask::WALL)
+                    {
+                        continue;
+                    }
+                }
+
+                // Calculate G cost for this route, ~sqrt(2) for moving diagonal
+                int Gcost = tileGcost + (dx == 0 || dy == 0
+                    ? basicCost : basicCost2);
+
+                /* Demote an arbitrary direction to speed pathfinding by
+                   adding a defect.
+                   Important: as long as the total defect along any path is
+                   less than the basicCost, the pathfinder will still find one
+                   of the shortest paths! */
+                if (dx == 0 || dy == 0)
+                {
+                    // Demote horizontal and vertical directions, so that two
+                    // consecutive directions cannot have the same Fcost.
+                    ++Gcost;
+                }
+
+                // Skip if Gcost becomes too much
+                // Warning: probably not entirely accurate
+                if (maxCost > 0 && Gcost > maxCost * basicCost)
+                    continue;
+
+                if (!touched)
+                {
+                    // Found a new tile (not on open nor on closed list)
+
+                    node.generation = generation;
+                    node.parent = currTile;
+                    node.Gcost = Gcost;
+                    node.Fcost = Gcost + getHcost(std::abs(x - destX), dy1);
+
+                    if (newTile != destTile)
+                    {
+                        // Add this tile to the open list
+                        heapPush(newTile);
+                    }
+                    else
+                    {
+                        // Target location was found
+                        node.heapIndex = CLOSED;
+                        foundPath = true;
+                    }
+                }
+                else if (Gcost < node.Gcost)
+                {
+                    // Found a shorter route, update costs and move tile
+                    // up in the open list.
+                    node.Fcost += Gcost - node.Gcost;
+                    node.Gcost = Gcost;
+                    node.parent = currTile;
+                    heapUp(node.heapIndex);
+                }
+            }
+        }
+    }
+
+    return foundPath;
+}
+
+bool PathFinder::isWalkable(const int x, const int y) const
+{
+    return x >= 0 && y >= 0 && x < mWidth && y < mHeight
+        && !(mTiles[x + y * mWidth].blockmask & mWalkMask);
+}
+
+bool PathFinder::isWall(const int x, const int y) const
+{
+    return x < 0 || y < 0 || x >= mWidth || y >= mHeight
+        || (mTiles[x + y * mWidth].blockmask & BlockMask::WALL);
+}
+
+bool PathFinder::isSoftBlocked(const int x, const int y) const
+{
+    return !isWalkable(x, y) && !isWall(x, y);
+}
+
+bool PathFinder::canStep(const int x, const int y,
+                         const int dx, const int dy) const
+{
+    // same rule as in searchAStar: diagonal corners blocked only by walls
+    return isWalkable(x + dx, y + dy)
+        && (!dx || !dy || (!isWall(x + dx, y) && !isWall(x, y + dy)));
+}
+
+int PathFinder::jumpStraight(int x, int y,
+                             const int dx, const int dy,
+                             const int destTile) const
+{
+    // side direction, perpendicular to move
+    const int sx = dy;
+    const int sy = dx;
+    for (;;)
+    {
+        if (!isWalkable(x + dx, y + dy))
+            return -1;
+        x += dx;
+        y += dy;
+        const int tile = x + y * mWidth;
+        if (tile == destTile)
+            return tile;
+
+        // Stop if side tile can not be reached from previous tile
+        // diagonally, or if diagonal step forward can pass blocked side.
+        for (int side = -1; side <= 1; side += 2)
+        {
+            const int x1 = x + side * sx;
+            const int y1 = y + side * sy;
+            if ((isWalkable(x1, y1) && isWall(x1 - dx, y1 - dy))
+                || (isSoftBlocked(x1, y1)
+                && canStep(x, y, dx + side * sx, dy + side * sy)))
+            {
+                return tile;
+            }
+        }
+    }
+}
+
+int PathFinder::jump(int x, int y,
+                     const int dx, const int dy,
+                     const int destTile) const
+{
+    if (!dx || !dy)
+        return jumpStraight(x, y, dx, dy, destTile);
+
+    for (;;)
+    {
+        if (!canStep(x, y, dx, dy))
+            return -1;
+        x += dx;
+        y += dy;
+        const int tile = x + y * mWidth;
+        if (tile == destTile)
+            return tile;
+        // diagonal step backward passing blocked corner
+        if ((isSoftBlocked(x - dx, y) && canStep(x, y, -dx, dy))
+            || (isSoftBlocked(x, y - dy) && canStep(x, y, dx, -dy)))
+        {
+            return tile;
+        }
+        if (jumpStraight(x, y, dx, 0, destTile) >= 0
+            || jumpStraight(x, y, 0, dy, destTile) >= 0)
+        {
+            return tile;
+        }
+    }
+}
+
+bool PathFinder::searchJumpPoints(const MetaTile *const tiles,
+                                  const int destTile,
+                                  const unsigned char blockWalkMask,
+                                  const int maxCost)
+{
+    const unsigned generation = mGeneration;
+    const int destX = destTile % mWidth;
+    const int destY = destTile / mWidth;
+    mTiles = tiles;
+    mWalkMask = static_cast<unsigned char>(blockWalkMask | BlockMask::WALL);
+
+    while (!mHeap.empty())
+    {
+        const int currTile = heapPop();
+        Node &curr = mNodes[currTile];
+        curr.heapIndex = CLOSED;
+        if (currTile == destTile)
+            return true;
+
+        const int currX = currTile % mWidth;
+        const int currY = currTile / mWidth;
+        const int tileGcost = curr.Gcost;
+
+        // Directions worth to check from this tile. Without parent all
+        // directions, else only natural and forced neighbours.
+        int dirs[8][2];
+        int dirsCount = 0;
+        const int parent = curr.parent;
+        const int px = parent % mWidth;
+        const int py = parent / mWidth;
+        const int dx = (currX > px) - (currX < px);
+        const int dy = (currY > py) - (currY < py);
+        if (!dx && !dy)
+        {
+            for (int y = -1; y <= 1; y ++)
+            {
+                for (int x = -1; x <= 1; x ++)
+                {
+                    if (x || y)
+                    {
+                        dirs[dirsCount][0] = x;
+                        dirs[dirsCount][1] = y;
+                        dirsCount ++;
+                    }
+                }
+            }
+        }
+        else if (dx && dy)
+        {
+            dirs[0][0] = dx;
+            dirs[0][1] = 0;
+            dirs[1][0] = 0;
+            dirs[1][1] = dy;
+            dirs[2][0] = dx;
+            dirs[2][1] = dy;
+            dirsCount = 3;
+            if (isSoftBlocked(currX - dx, currY))
+            {
+                dirs[dirsCount][0] = -dx;
+                dirs[dirsCount][1] = dy;
+                dirsCount ++;
+            }
+            if (isSoftBlocked(currX, currY - dy))
+            {
+                dirs[dirsCount][0] = dx;
+                dirs[dirsCount][1] = -dy;
+                dirsCount ++;
+            }
+        }
+        else
+        {
+            dirs[0][0] = dx;
+            dirs[0][1] = dy;
+            dirsCount = 1;
+            // side directions, perpendicular to move
+            for (int side = -1; side <= 1; side += 2)
+            {
+                const int sx = side * dy;
+                const int sy = side * dx;
+                const int x1 = currX + sx;
+                const int y1 = currY + sy;
+                const bool walkSide = isWalkable(x1, y1);
+                if (walkSide && isWall(x1 - dx, y1 - dy))
+                {
+                    dirs[dirsCount][0] = sx;
+                    dirs[dirsCount][1] = sy;
+                    dirsCount ++;
+                }
+                if ((walkSide && isWall(x1 - dx, y1 - dy))
+                    || isSoftBlocked(x1, y1))
+                {
+                    dirs[dirsCount][0] = dx + sx;
+                    dirs[dirsCount][1] = dy + sy;
+                    dirsCount ++;
+                }
+            }
+        }
+
+        for (int f = 0; f < dirsCount; f ++)
+        {
+            const int dirX = dirs[f][0];
+            const int dirY = dirs[f][1];
+            const int newTile = jump(currX, currY,
+                dirX, dirY, destTile);
+            if (newTile < 0)
+                continue;
+
+            Node &node = mNodes[newTile];
+            const bool touched = node.generation == generation;
+            if (touched && node.heapIndex == CLOSED)
+                continue;
+
+            const int x = newTile % mWidth;
+            const int y = newTile / mWidth;
+            const int steps = std::max(std::abs(x - currX),
+                std::abs(y - currY));
+            // same costs as in searchAStar
+            const int Gcost = tileGcost + steps * (dirX && dirY
+                ? basicCost2 : basicCost + 1);
+
+            // Skip if Gcost becomes too much
+            if (maxCost > 0 && Gcost > maxCost * basicCost)
+                continue;
+
+            if (!touched)
+            {
+                node.generation = generation;
+                node.parent = currTile;
+                node.Gcost = Gcost;
+                node.Fcost = Gcost + getHcost(std::abs(x - destX),
+                    std::abs(y - destY));
+                heapPush(newTile);
+            }
+            else if (Gcost < node.Gcost)
+            {
+                node.Fcost += Gcost - node.Gcost;
+                node.Gcost = Gcost;
+                node.parent = currTile;
+                heapUp(node.heapIndex);
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,136 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAP_PATHFINDER_H
+#define RESOURCES_MAP_PATHFINDER_H
+
+#include "position.h"
+
+#include <vector>
+
+#include "localconsts.h"
+
+class WalkLayer;
+
+struct MetaTile;
+
+/**
+ * A* or jump point search over map tiles. Search state is kept between
+ * calls and marked with search generation, so it never needs clearing.
+ */
+class PathFinder final
+{
+    public:
+        PathFinder(const int width, const int height);
+
+        A_DELETE_COPY(PathFinder)
+
+        /**
+         * Find a path from one location to the next.
+         */
+        Path findPath(const MetaTile *const tiles,
+                      const int startX, const int startY,
+                      const int destX, const int destY,
+                      const unsigned char blockWalkMask,
+                      const int maxCost) A_WARN_UNUSED;
+
+        /**
+         * Walk layer regions used for fast reject of unreachable
+         * destinations.
+         */
+        void setWalkLayer(const WalkLayer *const layer)
+        { mWalkLayer = layer; }
+
+        /**
+         * Enables jump point search. It expands only tiles where
+         * direction can change. Moves follow the same rules as A*,
+         * so found paths have the same cost.
+         */
+        void setJumpPointSearch(const bool enabled)
+        { mJumpPointSearch = enabled; }
+
+    private:
+        struct Node final
+        {
+            Node() :
+                Fcost(0),
+                Gcost(0),
+                parent(0),
+                heapIndex(0),
+                generation(0)
+            {
+            }
+
+            int Fcost;               /**< Estimation of total path cost */
+            int Gcost;               /**< Cost from start to this location */
+            int parent;              /**< Index of parent tile */
+            int heapIndex;           /**< Position in open list or CLOSED */
+            unsigned generation;     /**< Search where node was touched */
+        };
+
+        bool searchAStar(const MetaTile *const tiles,
+                         const int destTile,
+                         const unsigned char blockWalkMask,
+                         const int maxCost);
+
+        bool searchJumpPoints(const MetaTile *const tiles,
+                              const int destTile,
+                              const unsigned char blockWalkMask,
+                              const int maxCost);
+
+        int jump(int x, int y,
+                 const int dx, const int dy,
+                 const int destTile) const A_WARN_UNUSED;
+
+        int jumpStraight(int x, int y,
+                         const int dx, const int dy,
+                         const int destTile) const A_WARN_UNUSED;
+
+        bool isWalkable(const int x, const int y) const A_WARN_UNUSED;
+
+        bool isWall(const int x, const int y) const A_WARN_UNUSED;
+
+        bool isSoftBlocked(const int x, const int y) const A_WARN_UNUSED;
+
+        bool canStep(const int x, const int y,
+                     const int dx, const int dy) const A_WARN_UNUSED;
+
+        void heapPush(const int tile);
+
+        int heapPop() A_WARN_UNUSED;
+
+        void heapUp(int pos);
+
+        void heapDown(int pos);
+
+        int mWidth;
+        int mHeight;
+        unsigned mGeneration;
+        std::vector<Node> mNodes;
+        // open list, tile indexes ordered by Fcost
+        std::vector<int> mHeap;
+        // tiles and mask of current jump point search
+        const MetaTile *mTiles;
+        const WalkLayer *mWalkLayer;
+        unsigned char mWalkMask;
+        bool mJumpPointSearch;
+};
+
+#endif  // RESOURCES_MAP_PATHFINDER_H
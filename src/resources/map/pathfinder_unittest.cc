@@ -0,0 +1,143 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/map/pathfinder.h"
+
+#include "resources/map/blockmask.h"
+#include "resources/map/metatile.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+#include "debug.h"
+
+static const unsigned char walkMask = BlockMask::WALL
+    | BlockMask::AIR | BlockMask::WATER | BlockMask::MONSTER;
+
+// path cost with same step costs as in PathFinder
+static int getCost(const Path &path, int x, int y)
+{
+    int cost = 0;
+    FOR_EACH (Path::const_iterator, it, path)
+    {
+        cost += (it->x != x && it->y != y) ? 141 : 101;
+        x = it->x;
+        y = it->y;
+    }
+    return cost;
+}
+
+static void comparePaths(const MetaTile *const tiles,
+                         const int width, const int height,
+                         const int startX, const int startY,
+                         const int destX, const int destY)
+{
+    PathFinder astar(width, height);
+    PathFinder jps(width, height);
+    jps.setJumpPointSearch(true);
+    const Path path1 = astar.findPath(tiles, startX, startY,
+        destX, destY, walkMask, 0);
+    const Path path2 = jps.findPath(tiles, startX, startY,
+        destX, destY, walkMask, 0);
+    EXPECT_EQ(path1.empty(), path2.empty());
+    EXPECT_EQ(getCost(path1, startX, startY),
+        getCost(path2, startX, startY));
+}
+
+TEST(PathFinder, jumpPointSearchCorners)
+{
+    // . free, # wall, w water, m monster
+    static const char *const map[] =
+    {
+        "..........",
+        ".w.m..#...",
+        "..m.w.#.w.",
+        ".w.m..#..m",
+        "...w..w...",
+        "..m...#.w.",
+        "......#...",
+    };
+    const int width = 10;
+    const int height = 7;
+    MetaTile tiles[width * height];
+    for (int y = 0; y < height; y ++)
+    {
+        for (int x = 0; x < width; x ++)
+        {
+            unsigned char &mask = tiles[x + y * width].blockmask;
+            switch (map[y][x])
+            {
+                case '#':
+                    mask = BlockMask::WALL;
+                    break;
+                case 'w':
+                    mask = BlockMask::WATER;
+                    break;
+                case 'm':
+                    mask = BlockMask::MONSTER;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // diagonal steps between blocked corners
+    PathFinder jps(width, height);
+    jps.setJumpPointSearch(true);
+    EXPECT_EQ(2U, jps.findPath(tiles, 2, 1, 4, 3, walkMask, 0).size());
+
+    for (int start = 0; start < width * height; start ++)
+    {
+        for (int dest = 0; dest < width * height; dest ++)
+        {
+            comparePaths(tiles, width, height,
+                start % width, start / width,
+                dest % width, dest / width);
+        }
+    }
+}
+
+TEST(PathFinder, jumpPointSearchRandom)
+{
+    srand(1);
+    for (int f = 0; f < 200; f ++)
+    {
+        const int width = 3 + rand() % 20;
+        const int height = 3 + rand() % 20;
+        MetaTile *const tiles = new MetaTile[width * height];
+        for (int i = 0; i < width * height; i ++)
+        {
+            const int val = rand() % 10;
+            if (val == 0)
+                tiles[i].blockmask = BlockMask::WALL;
+            else if (val < 3)
+                tiles[i].blockmask = BlockMask::MONSTER;
+        }
+        for (int i = 0; i < 20; i ++)
+        {
+            comparePaths(tiles, width, height,
+                rand() % width, rand() % height,
+                rand() % width, rand() % height);
+        }
+        delete [] tiles;
+    }
+}
@@ -0,0 +1,410 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/mapcache.h"
+
+#include "logger.h"
+#include "main.h"
+
+#include "resources/resourcetable.h"
+
+#include "resources/map/mapdata.h"
+
+#include "utils/files.h"
+#include "utils/mkdir.h"
+#include "utils/stringutils.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "debug.h"
+
+std::string MapCache::mDir;
+bool MapCache::mEnabled = false;
+
+namespace
+{
+    const int mapCacheMagic = 0x434D504D;  // "MPMC"
+    const int mapCacheVersion = 1;
+    const int maxLayerSize = 65535;
+
+    // all blocks 4 bytes aligned, so layer gids can be used from mapping
+    size_t alignSize(const size_t size)
+    {
+        return (size + 3) & ~static_cast<size_t>(3);
+    }
+
+    size_t layerSize(const MapLayerData *const layer)
+    {
+        if (layer->width <= 0 || layer->height <= 0)
+            return 0;
+        return static_cast<size_t>(layer->width)
+            * static_cast<size_t>(layer->height);
+    }
+
+    class CacheReader final
+    {
+        public:
+            CacheReader(const char *const data, const size_t size) :
+                mData(data),
+                mSize(size),
+                mPos(0)
+            {
+            }
+
+            A_DELETE_COPY(CacheReader)
+
+            bool readInt(int &value)
+            {
+                int32_t val = 0;
+                if (mSize - mPos < sizeof(val))
+                    return false;
+                memcpy(&val, mData + mPos, sizeof(val));
+                mPos += sizeof(val);
+                value = val;
+                return true;
+            }
+
+            bool readString(std::string &str)
+            {
+                int sz = 0;
+                if (!readInt(sz) || sz < 0 || alignSize(sz) > mSize - mPos)
+                    return false;
+                str.assign(mData + mPos, sz);
+                mPos += alignSize(sz);
+                return true;
+            }
+
+            const int *readInts(const size_t count)
+            {
+                // compare count first, so size can't overflow
+                if (count > (mSize - mPos) / sizeof(int32_t))
+                    return nullptr;
+                const int *const ptr = reinterpret_cast<const int*>(
+                    mData + mPos);
+                mPos += count * sizeof(int32_t);
+                return ptr;
+            }
+
+        private:
+            const char *const mData;
+            const size_t mSize;
+            size_t mPos;
+    };
+
+    bool writeInt(FILE *const file, const int value)
+    {
+        const int32_t val = value;
+        return fwrite(&val, sizeof(val), 1, file) == 1;
+    }
+
+    bool writeString(FILE *const file, const std::string &str)
+    {
+        static const char padding[4] = {0, 0, 0, 0};
+        const size_t sz = str.size();
+        const size_t pad = alignSize(sz) - sz;
+        return writeInt(file, static_cast<int>(sz))
+            && fwrite(str.data(), 1, sz, file) == sz
+            && fwrite(padding, 1, pad, file) == pad;
+    }
+
+    bool readLayer(CacheReader &reader, MapLayerData *const layer)
+    {
+        int type = 0;
+        int isFringe = 0;
+        int hasData = 0;
+        if (!reader.readString(layer->name)
+            || !reader.readInt(type)
+            || !reader.readInt(layer->offsetX)
+            || !reader.readInt(layer->offsetY)
+            || !reader.readInt(layer->width)
+            || !reader.readInt(layer->height)
+            || !reader.readInt(layer->mask)
+            || !reader.readInt(isFringe)
+            || !reader.readInt(hasData)
+            || type < MapLayer::TILES
+            || type > MapLayer::HEIGHTS
+            || layer->width > maxLayerSize
+            || layer->height > maxLayerSize)
+        {
+            return false;
+        }
+        layer->type = static_cast<MapLayer::Type>(type);
+        layer->isFringe = isFringe != 0;
+        layer->hasData = hasData != 0;
+        if (!layer->hasData)
+            return true;
+        layer->gids = reader.readInts(layerSize(layer));
+        return layer->gids != nullptr;
+    }
+
+    bool writeLayer(FILE *const file, const MapLayerData *const layer)
+    {
+        if (layer->width > maxLayerSize || layer->height > maxLayerSize)
+            return false;
+        bool ok = writeString(file, layer->name)
+            && writeInt(file, static_cast<int>(layer->type))
+            && writeInt(file, layer->offsetX)
+            && writeInt(file, layer->offsetY)
+            && writeInt(file, layer->width)
+            && writeInt(file, layer->height)
+            && writeInt(file, layer->mask)
+            && writeInt(file, layer->isFringe ? 1 : 0)
+            && writeInt(file, layer->hasData ? 1 : 0);
+        if (ok && layer->hasData)
+        {
+            const size_t sz = layerSize(layer);
+            ok = fwrite(layer->gids, sizeof(int32_t), sz, file) == sz;
+        }
+        return ok;
+    }
+}  // namespace
+
+void MapCache::init(const std::string &dir)
+{
+    mEnabled = false;
+    mDir = dir;
+    if (mkdir_r(mDir.c_str()))
+    {
+        logger->log("Map cache disabled, can't create directory: "
+            + mDir);
+        return;
+    }
+    mEnabled = true;
+}
+
+std::string MapCache::getCacheFileName(const std::string &fileName)
+{
+    return strprintf("%s/%08x.map",
+        mDir.c_str(),
+        ResourceTable::hashId(fileName));
+}
+
+MapData *MapCache::load(const std::string &fileName,
+                        const int size,
+                        const unsigned int crc)
+{
+    if (!mEnabled)
+        return nullptr;
+
+    BLOCK_START("MapCache::load")
+    MappedFile *const file = new MappedFile;
+    if (!file->open(getCacheFileName(fileName)))
+    {
+        delete file;
+        BLOCK_END("MapCache::load")
+        return nullptr;
+    }
+
+    CacheReader reader(file->getData(), file->getSize());
+    MapData *const data = new MapData;
+    data->file = file;
+    std::string version;
+    std::string name;
+    int magic = 0;
+    int cacheVersion = 0;
+    int fileSize = 0;
+    int fileCrc = 0;
+    int count = 0;
+    bool ok = reader.readInt(magic)
+        && magic == mapCacheMagic
+        && reader.readInt(cacheVersion)
+        && cacheVersion == mapCacheVersion
+        && reader.readString(version)
+        && version == CHECK_VERSION
+        && reader.readString(name)
+        && name == fileName
+        && reader.readInt(fileSize)
+        && fileSize == size
+        && reader.readInt(fileCrc)
+        && static_cast<unsigned int>(fileCrc) == crc
+        && reader.readInt(data->width)
+        && reader.readInt(data->height)
+        && reader.readInt(data->tileWidth)
+        && reader.readInt(data->tileHeight)
+        && reader.readInt(count)
+        && count >= 0;
+
+    for (int f = 0; ok && f < count; f ++)
+    {
+        int type = 0;
+        ok = reader.readInt(type)
+            && type >= MapDataEntryType::TILESET
+            && type <= MapDataEntryType::OBJECTGROUP;
+        if (!ok)
+            break;
+
+        MapDataEntry *const entry = new MapDataEntry(
+            static_cast<MapDataEntryType::Type>(type));
+        data->entries.push_back(entry);
+        switch (entry->type)
+        {
+            case MapDataEntryType::TILESET:
+                ok = reader.readString(entry->text);
+                break;
+            case MapDataEntryType::LAYER:
+                entry->layer = new MapLayerData;
+                ok = readLayer(reader, entry->layer);
+                break;
+            case MapDataEntryType::PROPERTIES:
+            {
+                int props = 0;
+                ok = reader.readInt(props) && props >= 0;
+                for (int i = 0; ok && i < props; i ++)
+                {
+                    MapPropertyData prop;
+                    ok = reader.readString(prop.first)
+                        && reader.readString(prop.second);
+                    entry->properties.push_back(prop);
+                }
+                break;
+            }
+            case MapDataEntryType::OBJECTGROUP:
+            {
+                int objects = 0;
+                ok = reader.readInt(entry->offsetX)
+                    && reader.readInt(entry->offsetY)
+                    && reader.readInt(objects)
+                    && objects >= 0;
+                for (int i = 0; ok && i < objects; i ++)
+                {
+                    MapObjectData object;
+                    ok = reader.readString(object.type)
+                        && reader.readString(object.name)
+                        && reader.readInt(object.x)
+                        && reader.readInt(object.y)
+                        && reader.readInt(object.width)
+                        && reader.readInt(object.height);
+                    entry->objects.push_back(object);
+                }
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+    }
+
+    if (!ok)
+    {
+        delete data;
+        BLOCK_END("MapCache::load")
+        return nullptr;
+    }
+    logger->log("Map %s loaded from cache", fileName.c_str());
+    BLOCK_END("MapCache::load")
+    return data;
+}
+
+void MapCache::save(const std::string &fileName,
+                    const int size,
+                    const unsigned int crc,
+                    const MapData &data)
+{
+    if (!mEnabled)
+        return;
+
+    BLOCK_START("MapCache::save")
+    // write to unique temp file, so readers never see partial file
+    const std::string cacheName = getCacheFileName(fileName);
+    const std::string tempName = Files::getTempName(cacheName);
+    FILE *const file = fopen(tempName.c_str(), "wb");
+    if (!file)
+    {
+        BLOCK_END("MapCache::save")
+        return;
+    }
+
+    bool ok = writeInt(file, mapCacheMagic)
+        && writeInt(file, mapCacheVersion)
+        && writeString(file, CHECK_VERSION)
+        && writeString(file, fileName)
+        && writeInt(file, size)
+        && writeInt(file, static_cast<int>(crc))
+        && writeInt(file, data.width)
+        && writeInt(file, data.height)
+        && writeInt(file, data.tileWidth)
+        && writeInt(file, data.tileHeight)
+        && writeInt(file, static_cast<int>(data.entries.size()));
+
+    FOR_EACH (std::vector<MapDataEntry*>::const_iterator, it, data.entries)
+    {
+        if (!ok)
+            break;
+        const MapDataEntry *const entry = *it;
+        ok = writeInt(file, static_cast<int>(entry->type));
+        switch (entry->type)
+        {
+            case MapDataEntryType::TILESET:
+                ok = ok && writeString(file, entry->text);
+                break;
+            case MapDataEntryType::LAYER:
+                ok = ok && entry->layer && writeLayer(file, entry->layer);
+                break;
+            case MapDataEntryType::PROPERTIES:
+            {
+                ok = ok && writeInt(file,
+                    static_cast<int>(entry->properties.size()));
+                FOR_EACH (std::vector<MapPropertyData>::const_iterator,
+                          it2, entry->properties)
+                {
+                    ok = ok
+                        && writeString(file, (*it2).first)
+                        && writeString(file, (*it2).second);
+                }
+                break;
+            }
+            case MapDataEntryType::OBJECTGROUP:
+            {
+                ok = ok
+                    && writeInt(file, entry->offsetX)
+                    && writeInt(file, entry->offsetY)
+                    && writeInt(file,
+                    static_cast<int>(entry->objects.size()));
+                FOR_EACH (std::vector<MapObjectData>::const_iterator,
+                          it2, entry->objects)
+                {
+                    const MapObjectData &object = *it2;
+                    ok = ok
+                        && writeString(file, object.type)
+                        && writeString(file, object.name)
+                        && writeInt(file, object.x)
+                        && writeInt(file, object.y)
+                        && writeInt(file, object.width)
+                        && writeInt(file, object.height);
+                }
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+    }
+
+    fclose(file);
+#ifdef WIN32
+    // rename on windows not replaces existing file
+    if (ok)
+        remove(cacheName.c_str());
+#endif  // WIN32
+    if (!ok || rename(tempName.c_str(), cacheName.c_str()))
+        remove(tempName.c_str());
+    BLOCK_END("MapCache::save")
+}
@@ -0,0 +1,68 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_MAPCACHE_H
+#define RESOURCES_MAPCACHE_H
+
+#include <string>
+
+#include "localconsts.h"
+
+struct MapData;
+
+/**
+ * Compiled maps on disk. Stores decoded map layers, properties, objects and
+ * tilesets xml in native binary format, loaded by memory mapping without
+ * xml parsing. Entries checked against size and crc of source map file.
+ */
+class MapCache final
+{
+    public:
+        A_DELETE_COPY(MapCache)
+
+        /**
+         * Enables cache in given directory, creating it if needed.
+         */
+        static void init(const std::string &dir);
+
+        static bool isEnabled() A_WARN_UNUSED
+        { return mEnabled; }
+
+        /**
+         * Returns compiled map or nullptr if missing or outdated.
+         */
+        static MapData *load(const std::string &fileName,
+                             const int size,
+                             const unsigned int crc) A_WARN_UNUSED;
+
+        static void save(const std::string &fileName,
+                         const int size,
+                         const unsigned int crc,
+                         const MapData &data);
+
+    private:
+        static std::string getCacheFileName(const std::string &fileName)
+                                            A_WARN_UNUSED;
+
+        static std::string mDir;
+        static bool mEnabled;
+};
+
+#endif  // RESOURCES_MAPCACHE_H
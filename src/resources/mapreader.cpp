@@ -30,12 +30,14 @@
 
 #include "resources/map/map.h"
 #include "resources/map/mapconsts.h"
+#include "resources/map/mapdata.h"
 #include "resources/map/mapheights.h"
 #include "resources/map/tileset.h"
 
 #include "resources/animation.h"
 #include "resources/beingcommon.h"
 #include "resources/image.h"
+#include "resources/mapcache.h"
 #include "resources/mapitemtype.h"
 #include "resources/resourcemanager.h"
 
@@ -46,9 +48,15 @@
 #include "resources/map/tileanimation.h"
 
 #include "utils/base64.h"
+#include "utils/cpu.h"
 #include "utils/delete2.h"
+#include "utils/physfstools.h"
+#include "utils/sdlhelper.h"
 #include "utils/stringmap.h"
 
+#include <SDL_mutex.h>
+
+#include <algorithm>
 #include <zlib.h>
 
 #include "debug.h"
@@ -56,10 +64,49 @@
 typedef std::map<std::string, XmlNodePtr>::iterator LayerInfoIterator;
 typedef std::set<XML::Document*>::iterator DocIterator;
 
+struct LayerDecodeQueue final
+{
+    LayerDecodeQueue(const std::vector<LayerDecodeJob> &jobs0,
+                     const int mapWidth0,
+                     const int mapHeight0) :
+        jobs(jobs0),
+        mutex(SDL_CreateMutex()),
+        next(0U),
+        mapWidth(mapWidth0),
+        mapHeight(mapHeight0)
+    {
+    }
+
+    A_DELETE_COPY(LayerDecodeQueue)
+
+    ~LayerDecodeQueue()
+    {
+        SDL_DestroyMutex(mutex);
+    }
+
+    const std::vector<LayerDecodeJob> &jobs;
+    SDL_mutex *mutex;
+    size_t next;
+    const int mapWidth;
+    const int mapHeight;
+};
+
+int decodeLayersThread(void *data)
+{
+    LayerDecodeQueue *const queue = static_cast<LayerDecodeQueue*>(data);
+    if (!queue)
+        return -1;
+
+    MapReader::decodeLayers(queue);
+    return 0;
+}
+
 namespace
 {
     std::map<std::string, XmlNodePtr> mKnownLayers;
     std::set<XML::Document*> mKnownDocs;
+    // usual maps have less layers than this
+    const int maxDecodeThreads = 8;
 }  // namespace
 
 static int inflateMemory(unsigned char *restrict const in,
@@ -179,19 +226,19 @@ int inflateMemory(unsigned char *restrict const in,
     {
         if (ret == Z_MEM_ERROR)
         {
-            logger->log1("Error: Out of memory while decompressing map data!");
+            logger->log_r("Error: Out of memory while decompressing map data!");
         }
         else if (ret == Z_VERSION_ERROR)
         {
-            logger->log1("Error: Incompatible zlib version!");
+            logger->log_r("Error: Incompatible zlib version!");
         }
         else if (ret == Z_DATA_ERROR)
         {
-            logger->log1("Error: Incorrect zlib compressed data!");
+            logger->log_r("Error: Incorrect zlib compressed data!");
         }
         else
         {
-            logger->log1("Error: Unknown error while decompressing map data!");
+            logger->log_r("Error: Unknown error while decompressing map data!");
         }
 
         free(out);
@@ -236,28 +283,64 @@ Map *MapReader::readMap(const std::string &restrict filename,
     BLOCK_START("MapReader::readMap str")
     logger->log("Attempting to read map %s", realFilename.c_str());
 
-    XML::Document doc(realFilename, true, false);
-    if (!doc.isLoaded())
+    int size = 0;
+    char *const fileData = static_cast<char*>(
+        PhysFs::loadFile(realFilename, size));
+    if (!fileData)
     {
         BLOCK_END("MapReader::readMap str")
         return createEmptyMap(filename, realFilename);
     }
 
-    XmlNodePtrConst node = doc.rootNode();
+    MapData *data = nullptr;
+    unsigned int crc = 0;
+    if (MapCache::isEnabled())
+    {
+        crc = static_cast<unsigned int>(crc32(0,
+            reinterpret_cast<Bytef*>(fileData), size));
+        data = MapCache::load(realFilename, size, crc);
+    }
 
-    Map *map = nullptr;
-    // Parse the inflated map data
-    if (node)
+    if (!data)
     {
-        if (!xmlNameEqual(node, "map"))
-            logger->log("Error: Not a map file (%s)!", realFilename.c_str());
+        XML::Document doc(fileData, size);
+        if (!doc.isLoaded())
+        {
+            logger->log("Error parsing XML file %s", realFilename.c_str());
+            free(fileData);
+            BLOCK_END("MapReader::readMap str")
+            return createEmptyMap(filename, realFilename);
+        }
+
+        XmlNodePtrConst node = doc.rootNode();
+        // Parse the inflated map data
+        if (node)
+        {
+            if (!xmlNameEqual(node, "map"))
+            {
+                logger->log("Error: Not a map file (%s)!",
+                    realFilename.c_str());
+            }
+            else
+            {
+                data = compileMap(node, realFilename);
+                if (data)
+                    MapCache::save(realFilename, size, crc, *data);
+            }
+        }
         else
-            map = readMap(node, realFilename);
+        {
+            logger->log("Error while parsing map file (%s)!",
+                        realFilename.c_str());
+        }
     }
-    else
+    free(fileData);
+
+    Map *map = nullptr;
+    if (data)
     {
-        logger->log("Error while parsing map file (%s)!",
-                    realFilename.c_str());
+        map = buildMap(*data, realFilename);
+        delete data;
     }
 
     if (map)
@@ -295,35 +378,164 @@ static void loadReplaceLayer(const LayerInfoIterator &it, Map *const map)
 
 Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
 {
-    if (!node)
+    MapData *const data = compileMap(node, path);
+    if (!data)
         return nullptr;
+    Map *const map = buildMap(*data, path);
+    delete data;
+    return map;
+}
 
-    BLOCK_START("MapReader::readMap xml")
-    // Take the filename off the path
-    const std::string pathDir = path.substr(0, path.rfind("/") + 1);
+MapData *MapReader::compileMap(XmlNodePtrConst node, const std::string &path)
+{
+    if (!node)
+        return nullptr;
 
+    BLOCK_START("MapReader::compileMap")
     const int w = XML::getProperty(node, "width", 0);
     const int h = XML::getProperty(node, "height", 0);
     const int tilew = XML::getProperty(node, "tilewidth", -1);
     const int tileh = XML::getProperty(node, "tileheight", -1);
 
-    const bool showWarps = config.getBoolValue("warpParticle");
-    const std::string warpPath = paths.getStringValue("particles")
-        .append(paths.getStringValue("portalEffectFile"));
-
     if (tilew < 0 || tileh < 0)
     {
         logger->log("MapReader: Warning: "
                     "Unitialized tile width or height value for map: %s",
                     path.c_str());
-        BLOCK_END("MapReader::readMap xml")
+        BLOCK_END("MapReader::compileMap")
         return nullptr;
     }
 
+    MapData *const data = new MapData;
+    data->width = w;
+    data->height = h;
+    data->tileWidth = tilew;
+    data->tileHeight = tileh;
+
+    std::vector<LayerDecodeJob> jobs;
+    for_each_xml_child_node(childNode, node)
+    {
+        if (xmlNameEqual(childNode, "tileset"))
+        {
+            // tilesets need resource manager, keep them as xml
+            MapDataEntry *const entry = new MapDataEntry(
+                MapDataEntryType::TILESET);
+            data->entries.push_back(entry);
+            xmlBufferPtr buffer = xmlBufferCreate();
+            xmlNodeDump(buffer, childNode->doc, childNode, 0, 0);
+            entry->text.assign(reinterpret_cast<const char*>(
+                xmlBufferContent(buffer)), xmlBufferLength(buffer));
+            xmlBufferFree(buffer);
+        }
+        else if (xmlNameEqual(childNode, "layer"))
+        {
+            MapDataEntry *const entry = new MapDataEntry(
+                MapDataEntryType::LAYER);
+            data->entries.push_back(entry);
+            entry->layer = new MapLayerData;
+            jobs.push_back(LayerDecodeJob(childNode, entry->layer));
+        }
+        else if (xmlNameEqual(childNode, "properties"))
+        {
+            MapDataEntry *const entry = new MapDataEntry(
+                MapDataEntryType::PROPERTIES);
+            data->entries.push_back(entry);
+            readProperties(childNode, entry->properties);
+        }
+        else if (xmlNameEqual(childNode, "objectgroup"))
+        {
+            MapDataEntry *const entry = new MapDataEntry(
+                MapDataEntryType::OBJECTGROUP);
+            data->entries.push_back(entry);
+            entry->offsetX = XML::getProperty(childNode, "x", 0);
+            entry->offsetY = XML::getProperty(childNode, "y", 0);
+
+            for_each_xml_child_node(objectNode, childNode)
+            {
+                if (!xmlNameEqual(objectNode, "object"))
+                    continue;
+
+                MapObjectData object;
+                std::string objType = XML::getProperty(
+                    objectNode, "type", "");
+                object.type = toUpper(objType);
+                object.name = XML::getProperty(objectNode, "name", "");
+                object.x = XML::getProperty(objectNode, "x", 0);
+                object.y = XML::getProperty(objectNode, "y", 0);
+                object.width = XML::getProperty(objectNode, "width", 0);
+                object.height = XML::getProperty(objectNode, "height", 0);
+                entry->objects.push_back(object);
+            }
+        }
+    }
+
+    // layers independent and decoded to own MapLayerData in file order,
+    // so result not depends on threads count
+    int threads = 0;
+    if (config.getBoolValue("parallelMapLoading"))
+    {
+        threads = std::min(std::min(Cpu::getCount(), maxDecodeThreads),
+            static_cast<int>(jobs.size())) - 1;
+    }
+    LayerDecodeQueue queue(jobs, w, h);
+    std::vector<SDL_Thread*> workers;
+    for (int f = 0; f < threads && queue.mutex; f ++)
+    {
+        SDL_Thread *const thread = SDL::createThread(&decodeLayersThread,
+            "mapdecode", &queue);
+        if (!thread)
+            break;
+        workers.push_back(thread);
+    }
+    decodeLayers(&queue);
+    FOR_EACH (std::vector<SDL_Thread*>::iterator, it, workers)
+        SDL_WaitThread(*it, nullptr);
+
+    BLOCK_END("MapReader::compileMap")
+    return data;
+}
+
+void MapReader::decodeLayers(LayerDecodeQueue *const queue)
+{
+    const size_t sz = queue->jobs.size();
+    for (;;)
+    {
+        size_t idx = sz;
+        if (queue->mutex)
+            SDL_mutexP(queue->mutex);
+        if (queue->next < sz)
+        {
+            idx = queue->next;
+            queue->next ++;
+        }
+        if (queue->mutex)
+            SDL_mutexV(queue->mutex);
+        if (idx >= sz)
+            break;
+
+        const LayerDecodeJob &job = queue->jobs[idx];
+        decodeLayer(job.first, job.second,
+            queue->mapWidth, queue->mapHeight);
+    }
+}
+
+Map *MapReader::buildMap(const MapData &data, const std::string &path)
+{
+    BLOCK_START("MapReader::buildMap")
+    // Take the filename off the path
+    const std::string pathDir = path.substr(0, path.rfind("/") + 1);
+
+    const int tilew = data.tileWidth;
+    const int tileh = data.tileHeight;
+
+    const bool showWarps = config.getBoolValue("warpParticle");
+    const std::string warpPath = paths.getStringValue("particles")
+        .append(paths.getStringValue("portalEffectFile"));
+
     logger->log("loading replace layer list");
     loadLayers(path + "_replace.d");
 
-    Map *const map = new Map(w, h, tilew, tileh);
+    Map *const map = new Map(data.width, data.height, tilew, tileh);
 
     const std::string fileName = path.substr(path.rfind("/") + 1);
     map->setProperty("shortName", fileName);
@@ -343,51 +555,69 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     BLOCK_END("MapReader::readMap load atlas")
 #endif
 
-    for_each_xml_child_node(childNode, node)
+    FOR_EACH (std::vector<MapDataEntry*>::const_iterator, it, data.entries)
     {
-        if (xmlNameEqual(childNode, "tileset"))
+        const MapDataEntry *const entry = *it;
+        switch (entry->type)
         {
-            Tileset *const tileset = readTileset(childNode, pathDir, map);
-            if (tileset)
-                map->addTileset(tileset);
-        }
-        else if (xmlNameEqual(childNode, "layer"))
-        {
-            std::string name = XML::getProperty(childNode, "name", "");
-            name = toLower(name);
-            LayerInfoIterator it = mKnownLayers.find(name);
-            if (it == mKnownLayers.end())
+            case MapDataEntryType::TILESET:
             {
-                readLayer(childNode, map);
+                XML::Document doc(entry->text.c_str(),
+                    static_cast<int>(entry->text.size()));
+                XmlNodePtr tilesetNode = doc.rootNode();
+                if (!tilesetNode)
+                    break;
+                Tileset *const tileset = readTileset(tilesetNode,
+                    pathDir, map);
+                if (tileset)
+                    map->addTileset(tileset);
+                break;
             }
-            else
+            case MapDataEntryType::LAYER:
             {
-                logger->log("load replace layer: " + name);
-                loadReplaceLayer(it, map);
+                const MapLayerData *const layer = entry->layer;
+                if (!layer)
+                    break;
+                LayerInfoIterator it2 = mKnownLayers.find(layer->name);
+                if (it2 == mKnownLayers.end())
+                {
+                    addLayer(*layer, map);
+                }
+                else
+                {
+                    logger->log("load replace layer: " + layer->name);
+                    loadReplaceLayer(it2, map);
+                }
+                break;
             }
-        }
-        else if (xmlNameEqual(childNode, "properties"))
-        {
-            readProperties(childNode, map);
-            map->setVersion(atoi(map->getProperty(
-                "manaplus version").c_str()));
-        }
-        else if (xmlNameEqual(childNode, "objectgroup"))
-        {
-            // The object group offset is applied to each object individually
-            const int tileOffsetX = XML::getProperty(childNode, "x", 0);
-            const int tileOffsetY = XML::getProperty(childNode, "y", 0);
-            const int offsetX = tileOffsetX * tilew;
-            const int offsetY = tileOffsetY * tileh;
-
-            for_each_xml_child_node(objectNode, childNode)
+            case MapDataEntryType::PROPERTIES:
             {
-                if (xmlNameEqual(objectNode, "object"))
+                FOR_EACH (std::vector<MapPropertyData>::const_iterator,
+                          it2, entry->properties)
                 {
-                    std::string objType = XML::getProperty(
-                        objectNode, "type", "");
+                    map->setProperty((*it2).first, (*it2).second);
+                }
+                map->setVersion(atoi(map->getProperty(
+                    "manaplus version").c_str()));
+                break;
+            }
+            case MapDataEntryType::OBJECTGROUP:
+            {
+                // The object group offset is applied to each object
+                // individually
+                const int offsetX = entry->offsetX * tilew;
+                const int offsetY = entry->offsetY * tileh;
 
-                    objType = toUpper(objType);
+                FOR_EACH (std::vector<MapObjectData>::const_iterator,
+                          it2, entry->objects)
+                {
+                    const MapObjectData &object = *it2;
+                    const std::string &objType = object.type;
+                    const std::string &objName = object.name;
+                    const int objX = object.x;
+                    const int objY = object.y;
+                    const int objW = object.width;
+                    const int objH = object.height;
 
 /*
                     if (objType == "NPC" ||
@@ -399,13 +629,6 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
                     }
 */
 
-                    const std::string objName = XML::getProperty(
-                        objectNode, "name", "");
-                    const int objX = XML::getProperty(objectNode, "x", 0);
-                    const int objY = XML::getProperty(objectNode, "y", 0);
-                    const int objW = XML::getProperty(objectNode, "width", 0);
-                    const int objH = XML::getProperty(objectNode, "height", 0);
-
                     logger->log("- Loading object name: %s type: %s at %d:%d"
                         " (%dx%d)", objName.c_str(), objType.c_str(),
                         objX, objY, objW, objH);
@@ -449,7 +672,10 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
                         logger->log1("   Warning: Unknown object type");
                     }
                 }
+                break;
             }
+            default:
+                break;
         }
     }
 
@@ -459,15 +685,15 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     map->reduce();
     map->setWalkLayer(resman->getWalkLayer(fileName, map));
     unloadTempLayers();
-    BLOCK_END("MapReader::readMap xml")
+    BLOCK_END("MapReader::buildMap")
     return map;
 }
 
 void MapReader::readProperties(const XmlNodePtrConst node,
-                               Properties *const props)
+                               std::vector<MapPropertyData> &props)
 {
     BLOCK_START("MapReader::readProperties")
-    if (!node || !props)
+    if (!node)
     {
         BLOCK_END("MapReader::readProperties")
         return;
@@ -483,7 +709,7 @@ void MapReader::readProperties(const XmlNodePtrConst node,
         const std::string value = XML::getProperty(childNode, "value", "");
 
         if (!name.empty() && !value.empty())
-            props->setProperty(name, value);
+            props.push_back(MapPropertyData(name, value));
     }
     BLOCK_END("MapReader::readProperties")
 }
@@ -577,18 +803,15 @@ inline static void setTile(Map *const map, MapLayer *const layer,
     } \
 
 bool MapReader::readBase64Layer(const XmlNodePtrConst childNode,
-                                Map *const map,
-                                MapLayer *const layer,
-                                const MapLayer::Type &layerType,
-                                MapHeights *const heights,
                                 const std::string &compression,
-                                int &restrict x, int &restrict y,
-                                const int w, const int h)
+                                int *restrict const tiles,
+                                const int size,
+                                int &restrict pos)
 {
     if (!compression.empty() && compression != "gzip"
         && compression != "zlib")
     {
-        logger->log1("Warning: only gzip and zlib layer"
+        logger->log_r("Warning: only gzip and zlib layer"
             " compression supported!");
         return false;
     }
@@ -646,33 +869,19 @@ bool MapReader::readBase64Layer(const XmlNodePtrConst childNode,
 
             if (!inflated)
             {
-                logger->log1("Error: Could not decompress layer!");
+                logger->log_r("Error: Could not decompress layer!");
                 return false;
             }
         }
 
-        const std::map<int, TileAnimation*> &tileAnimations
-            = map->getTileAnimations();
-
-        const bool hasAnimations = !tileAnimations.empty();
-        for (int i = 0; i < binLen - 3; i += 4)
+        // When we're done, don't crash on too much data
+        for (int i = 0; i < binLen - 3 && pos < size; i += 4)
         {
-            const int gid = binData[i] |
+            tiles[pos] = binData[i] |
                 binData[i + 1] << 8 |
                 binData[i + 2] << 16 |
                 binData[i + 3] << 24;
-
-            addTile();
-
-            x++;
-            if (x == w)
-            {
-                x = 0; y++;
-
-                // When we're done, don't crash on too much data
-                if (y == h)
-                    break;
-            }
+            pos ++;
         }
         free(binData);
     }
@@ -680,12 +889,9 @@ bool MapReader::readBase64Layer(const XmlNodePtrConst childNode,
 }
 
 bool MapReader::readCsvLayer(const XmlNodePtrConst childNode,
-                             Map *const map,
-                             MapLayer *const layer,
-                             const MapLayer::Type &layerType,
-                             MapHeights *const heights,
-                             int &restrict x, int &restrict y,
-                             const int w, const int h)
+                             int *restrict const tiles,
+                             const int size,
+                             int &restrict pos)
 {
     XmlNodePtrConst dataChild = childNode->xmlChildrenNode;
     if (!dataChild)
@@ -697,66 +903,57 @@ bool MapReader::readCsvLayer(const XmlNodePtrConst childNode,
         return false;
 
     std::string csv(data);
+    xmlFree(xmlChars);
     size_t oldPos = 0;
 
-    const std::map<int, TileAnimation*> &tileAnimations
-        = map->getTileAnimations();
-    const bool hasAnimations = !tileAnimations.empty();
-
     while (oldPos != csv.npos)
     {
-        const size_t pos = csv.find_first_of(",", oldPos);
-        if (pos == csv.npos)
+        const size_t commaPos = csv.find_first_of(",", oldPos);
+        if (commaPos == csv.npos || pos >= size)
             return false;
 
-        const int gid = atoi(csv.substr(oldPos, pos - oldPos).c_str());
-        addTile();
+        tiles[pos] = atoi(csv.substr(oldPos, commaPos - oldPos).c_str());
+        pos ++;
 
-        x++;
-        if (x == w)
-        {
-            x = 0; y++;
-
-            // When we're done, don't crash on too much data
-            if (y == h)
-                return false;
-        }
+        // When we're done, don't crash on too much data
+        if (pos == size)
+            return false;
 
-        oldPos = pos + 1;
+        oldPos = commaPos + 1;
     }
-    xmlFree(xmlChars);
     return true;
 }
 
 void MapReader::readLayer(const XmlNodePtr node, Map *const map)
+{
+    MapLayerData layer;
+    decodeLayer(node, &layer, map->getWidth(), map->getHeight());
+    addLayer(layer, map);
+}
+
+void MapReader::decodeLayer(XmlNodePtrConst node,
+                            MapLayerData *const layer,
+                            const int mapWidth,
+                            const int mapHeight)
 {
     // Layers are not necessarily the same size as the map
-    const int w = XML::getProperty(node, "width", map->getWidth());
-    const int h = XML::getProperty(node, "height", map->getHeight());
-    const int offsetX = XML::getProperty(node, "x", 0);
-    const int offsetY = XML::getProperty(node, "y", 0);
+    const int w = XML::getProperty(node, "width", mapWidth);
+    const int h = XML::getProperty(node, "height", mapHeight);
+    layer->width = w;
+    layer->height = h;
+    layer->offsetX = XML::getProperty(node, "x", 0);
+    layer->offsetY = XML::getProperty(node, "y", 0);
     std::string name = XML::getProperty(node, "name", "");
     name = toLower(name);
+    layer->name = name;
 
-    const bool isFringeLayer = (name.substr(0, 6) == "fringe");
-    const bool isCollisionLayer = (name.substr(0, 9) == "collision");
-    const bool isHeightLayer = (name.substr(0, 7) == "heights");
-    int mask = 1;
-
-    MapLayer::Type layerType = MapLayer::TILES;
-    if (isCollisionLayer)
-        layerType = MapLayer::COLLISION;
-    else if (isHeightLayer)
-        layerType = MapLayer::HEIGHTS;
-
-    map->indexTilesets();
-
-    MapLayer *layer = nullptr;
-    MapHeights *heights = nullptr;
-
-    logger->log("- Loading layer \"%s\"", name.c_str());
-    int x = 0;
-    int y = 0;
+    layer->isFringe = (name.substr(0, 6) == "fringe");
+    if (name.substr(0, 9) == "collision")
+        layer->type = MapLayer::COLLISION;
+    else if (name.substr(0, 7) == "heights")
+        layer->type = MapLayer::HEIGHTS;
+    else
+        layer->type = MapLayer::TILES;
 
     // Load the tile data
     for_each_xml_child_node(childNode, node)
@@ -787,7 +984,7 @@ void MapReader::readLayer(const XmlNodePtr node, Map *const map)
                 }
                 else if (pname == "Mask")
                 {
-                    mask = atoi(value.c_str());
+                    layer->mask = atoi(value.c_str());
                 }
             }
         }
@@ -795,16 +992,13 @@ void MapReader::readLayer(const XmlNodePtr node, Map *const map)
         if (!xmlNameEqual(childNode, "data"))
             continue;
 
-        if (layerType == MapLayer::TILES)
-        {
-            layer = new MapLayer(offsetX, offsetY, w, h, isFringeLayer, mask);
-            map->addLayer(layer);
-        }
-        else if (layerType == MapLayer::HEIGHTS)
-        {
-            heights = new MapHeights(w, h);
-            map->addHeights(heights);
-        }
+        // missing tiles left as gid 0
+        layer->hasData = true;
+        const int size = (w > 0 && h > 0) ? w * h : 0;
+        layer->tiles.resize(size, 0);
+        int *const tiles = size ? &layer->tiles[0] : nullptr;
+        layer->gids = tiles;
+        int pos = 0;
 
         const std::string encoding =
             XML::getProperty(childNode, "encoding", "");
@@ -813,56 +1007,30 @@ void MapReader::readLayer(const XmlNodePtr node, Map *const map)
 
         if (encoding == "base64")
         {
-            if (readBase64Layer(childNode, map, layer, layerType,
-                heights, compression, x, y, w, h))
-            {
-                continue;
-            }
-            else
-            {
+            if (!readBase64Layer(childNode, compression, tiles, size, pos))
                 return;
-            }
         }
         else if (encoding == "csv")
         {
-            if (readCsvLayer(childNode, map, layer, layerType,
-                heights, x, y, w, h))
-            {
-                continue;
-            }
-            else
-            {
+            if (!readCsvLayer(childNode, tiles, size, pos))
                 return;
-            }
         }
         else
         {
-            const std::map<int, TileAnimation*> &tileAnimations
-                = map->getTileAnimations();
-            const bool hasAnimations = !tileAnimations.empty();
-
             // Read plain XML map file
             for_each_xml_child_node(childNode2, childNode)
             {
+                if (pos >= size)
+                    break;
                 if (!xmlNameEqual(childNode2, "tile"))
                     continue;
 
-                const int gid = XML::getProperty(childNode2, "gid", -1);
-                addTile();
-
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
-                    if (y >= h)
-                        break;
-                }
+                tiles[pos] = XML::getProperty(childNode2, "gid", -1);
+                pos ++;
             }
         }
 
-        if (y < h)
-            std::cerr << "TOO SMALL!\n";
-        if (x)
+        if (pos < size)
             std::cerr << "TOO SMALL!\n";
 
         // There can be only one data element
@@ -870,6 +1038,59 @@ void MapReader::readLayer(const XmlNodePtr node, Map *const map)
     }
 }
 
+void MapReader::addLayer(const MapLayerData &layerData, Map *const map)
+{
+    BLOCK_START("MapReader::addLayer")
+    map->indexTilesets();
+
+    logger->log("- Loading layer \"%s\"", layerData.name.c_str());
+    if (!layerData.hasData)
+    {
+        BLOCK_END("MapReader::addLayer")
+        return;
+    }
+
+    const MapLayer::Type layerType = layerData.type;
+    const int w = layerData.width;
+    const int h = layerData.height;
+    MapLayer *layer = nullptr;
+    MapHeights *heights = nullptr;
+
+    if (layerType == MapLayer::TILES)
+    {
+        layer = new MapLayer(layerData.offsetX, layerData.offsetY,
+            w, h, layerData.isFringe, layerData.mask);
+        map->addLayer(layer);
+    }
+    else if (layerType == MapLayer::HEIGHTS)
+    {
+        heights = new MapHeights(w, h);
+        map->addHeights(heights);
+    }
+
+    const int *const gids = layerData.gids;
+    if (!gids || w <= 0 || h <= 0)
+    {
+        BLOCK_END("MapReader::addLayer")
+        return;
+    }
+
+    const std::map<int, TileAnimation*> &tileAnimations
+        = map->getTileAnimations();
+    const bool hasAnimations = !tileAnimations.empty();
+
+    for (int y = 0; y < h; y ++)
+    {
+        const int *const row = gids + y * w;
+        for (int x = 0; x < w; x ++)
+        {
+            const int gid = row[x];
+            addTile();
+        }
+    }
+    BLOCK_END("MapReader::addLayer")
+}
+
 Tileset *MapReader::readTileset(XmlNodePtr node,
                                 const std::string &path,
                                 Map *const map)
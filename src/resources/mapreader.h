@@ -25,14 +25,15 @@
 
 #include "utils/xml.h"
 
-#include "resources/map/maplayer.h"
+#include "resources/map/mapdata.h"
 
 class Map;
-class MapHeights;
-class MapLayer;
-class Properties;
 class Tileset;
 
+struct LayerDecodeQueue;
+
+typedef std::pair<XmlNodePtr, MapLayerData*> LayerDecodeJob;
+
 /**
  * Reader for XML map files (*.tmx)
  */
@@ -62,33 +63,59 @@ class MapReader final
          */
         static void readLayer(const XmlNodePtr node, Map *const map);
 
+        friend int decodeLayersThread(void *data);
+
     private:
+        /**
+         * Parses map xml and decodes all layers, in parallel if enabled.
+         * Result does not depend on loaded resources and can be stored in
+         * map cache.
+         */
+        static MapData *compileMap(XmlNodePtrConst node,
+                                   const std::string &path) A_WARN_UNUSED;
+
+        /**
+         * Creates map from compiled data, loading tilesets and replace
+         * layers.
+         */
+        static Map *buildMap(const MapData &data,
+                             const std::string &path) A_WARN_UNUSED;
+
         /**
          * Reads the properties element.
          *
          * @param node  The <code>properties</code> element.
-         * @param props The Properties instance to which the properties will
-         *              be assigned.
+         * @param props The list to which the properties will be added.
          */
         static void readProperties(const XmlNodePtrConst node,
-                                   Properties *const props);
+                                   std::vector<MapPropertyData> &props);
+
+        /**
+         * Decodes layer tile gids without touching map.
+         */
+        static void decodeLayer(XmlNodePtrConst node,
+                                MapLayerData *const layer,
+                                const int mapWidth,
+                                const int mapHeight);
+
+        /**
+         * Decodes layers from queue until it empty. Called from worker
+         * threads and main thread.
+         */
+        static void decodeLayers(LayerDecodeQueue *const queue);
+
+        static void addLayer(const MapLayerData &layerData, Map *const map);
 
         static bool readBase64Layer(const XmlNodePtrConst childNode,
-                                    Map *const map,
-                                    MapLayer *const layer,
-                                    const MapLayer::Type &layerType,
-                                    MapHeights *const heights,
                                     const std::string &compression,
-                                    int &restrict x, int &restrict y,
-                                    const int w, const int h);
+                                    int *restrict const tiles,
+                                    const int size,
+                                    int &restrict pos);
 
         static bool readCsvLayer(const XmlNodePtrConst childNode,
-                                 Map *const map,
-                                 MapLayer *const layer,
-                                 const MapLayer::Type &layerType,
-                                 MapHeights *const heights,
-                                 int &restrict x, int &restrict y,
-                                 const int w, const int h);
+                                 int *restrict const tiles,
+                                 const int size,
+                                 int &restrict pos);
 
         /**
          * Reads a tile set.
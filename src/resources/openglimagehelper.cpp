@@ -56,12 +56,13 @@ OpenGLImageHelper::~OpenGLImageHelper()
         &mTextures[mFreeTextureIndex]);
 }
 
-Image *OpenGLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
+SDL_Surface *OpenGLImageHelper::loadDyedSurface(SDL_RWops *const rw,
+                                                Dye const &dye) const
 {
     SDL_Surface *const tmpImage = loadPng(rw);
     if (!tmpImage)
     {
-        logger->log("Error, image load failed: %s", IMG_GetError());
+        logger->log_r("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
@@ -95,9 +96,7 @@ Image *OpenGLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         }
     }
 
-    Image *const image = load(surf);
-    MSDL_FreeSurface(surf);
-    return image;
+    return surf;
 }
 
 Image *OpenGLImageHelper::load(SDL_Surface *const tmpImage)
@@ -68,7 +68,7 @@ class OpenGLImageHelper final : public ImageHelper
         ~OpenGLImageHelper();
 
         /**
-         * Loads an image from an SDL_RWops structure and recolors it.
+         * Decodes image from an SDL_RWops structure and recolors it.
          *
          * @param rw         The SDL_RWops to load the image from.
          * @param dye        The dye used to recolor the image.
@@ -76,8 +76,9 @@ class OpenGLImageHelper final : public ImageHelper
          * @return <code>NULL</code> if an error occurred, a valid pointer
          *         otherwise.
          */
-        Image *load(SDL_RWops *const rw,
-                    Dye const &dye) override final A_WARN_UNUSED;
+        SDL_Surface *loadDyedSurface(SDL_RWops *const rw,
+                                     Dye const &dye)
+                                     const override final A_WARN_UNUSED;
 
         /**
          * Loads an image from an SDL surface.
@@ -130,6 +131,9 @@ class OpenGLImageHelper final : public ImageHelper
                                 SDL_Surface *surface) const override final;
 
     protected:
+        char getDyeFormat() const override final A_WARN_UNUSED
+        { return 'G'; }
+
         /**
          * Returns the first power of two equal or bigger than the input.
          */
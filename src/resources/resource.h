@@ -42,6 +42,11 @@ class Resource notfinal
             mIdPath(),
             mSource(),
             mTimeStamp(0),
+            mPrevOrphan(nullptr),
+            mNextOrphan(nullptr),
+            mOrphanMemory(0),
+            mOrphanVideoMemory(0),
+            mIdHash(0U),
             mRefCount(0),
             mProtected(false),
 #ifdef DEBUG_DUMP_LEAKS
@@ -96,6 +101,18 @@ class Resource notfinal
         void setNotCount(const bool b)
         { mNotCount = b; }
 
+        /**
+         * Returns bytes of system memory owned by this resource.
+         */
+        virtual int getMemorySize() const A_WARN_UNUSED
+        { return 0; }
+
+        /**
+         * Returns bytes of texture memory owned by this resource.
+         */
+        virtual int getVideoMemorySize() const A_WARN_UNUSED
+        { return 0; }
+
 #ifdef DEBUG_DUMP_LEAKS
         bool getDumped() const A_WARN_UNUSED
         { return mDumped; }
@@ -115,6 +132,14 @@ class Resource notfinal
 
     private:
         time_t mTimeStamp;   /**< Time at which the resource was orphaned. */
+        // neighbours in orphans list, ordered by release time
+        Resource *mPrevOrphan;
+        Resource *mNextOrphan;
+        // sizes counted in orphans totals
+        int mOrphanMemory;
+        int mOrphanVideoMemory;
+        // hash of mIdPath in ResourceManager table
+        unsigned int mIdHash;
         unsigned int mRefCount;  /**< Reference count. */
         bool mProtected;
         bool mNotCount;
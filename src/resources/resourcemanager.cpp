@@ -29,6 +29,7 @@
 #include "resources/map/walklayer.h"
 
 #ifdef USE_OPENGL
+#include "resources/asyncresourceloader.h"
 #include "resources/atlasmanager.h"
 #include "resources/atlasresource.h"
 #endif
@@ -57,14 +58,44 @@
 
 #include "debug.h"
 
+namespace
+{
+    void appendInt(std::string &str, const int value)
+    {
+        char buf[16];
+        char *ptr = buf + sizeof(buf);
+        unsigned int val = value < 0
+            ? 0U - static_cast<unsigned int>(value)
+            : static_cast<unsigned int>(value);
+        do
+        {
+            *--ptr = static_cast<char>('0' + val % 10);
+            val /= 10;
+        }
+        while (val);
+        if (value < 0)
+            *--ptr = '-';
+        str.append(ptr, buf + sizeof(buf) - ptr);
+    }
+}  // namespace
+
 ResourceManager *ResourceManager::instance = nullptr;
 
 ResourceManager::ResourceManager() :
     deletedSurfaces(),
     mResources(),
     mOrphanedResources(),
+    mResourceTable(),
+    mKeyBuffer(),
     mDeletedResources(),
-    mOldestOrphan(0),
+    mOrphansHead(nullptr),
+    mOrphansTail(nullptr),
+    mOrphanedMemory(0),
+    mOrphanedVideoMemory(0),
+    mMemoryBudget(static_cast<size_t>(
+        config.getIntValue("orphanedResourcesMemory")) * 1024 * 1024),
+    mVideoMemoryBudget(static_cast<size_t>(
+        config.getIntValue("orphanedResourcesVideoMemory")) * 1024 * 1024),
     mDestruction(0),
     mUseLongLiveSprites(config.getBoolValue("uselonglivesprites"))
 {
@@ -75,6 +106,9 @@ ResourceManager::~ResourceManager()
 {
     mDestruction = true;
     mResources.insert(mOrphanedResources.begin(), mOrphanedResources.end());
+    mOrphansHead = nullptr;
+    mOrphansTail = nullptr;
+    mResourceTable.clear();
 
     // Release any remaining spritedefs first because they depend on image sets
     ResourceIterator iter = mResources.begin();
@@ -218,43 +252,92 @@ bool ResourceManager::cleanOrphans(const bool always)
     timeval tv;
     gettimeofday(&tv, nullptr);
     // Delete orphaned resources after 30 seconds.
-    time_t oldest = static_cast<time_t>(tv.tv_sec);
-    const time_t threshold = oldest - 30;
-
-    if (mOrphanedResources.empty() || (!always && mOldestOrphan >= threshold))
-        return false;
+    const time_t threshold = static_cast<time_t>(tv.tv_sec) - 30;
 
     bool status(false);
-    ResourceIterator iter = mOrphanedResources.begin();
-    while (iter != mOrphanedResources.end())
+    // orphans released by deleted resources appended to tail,
+    // and checked in same loop
+    while (mOrphansHead)
     {
-        Resource *const res = iter->second;
-        if (!res)
+        Resource *const res = mOrphansHead;
+        if (!always && res->mTimeStamp >= threshold
+            && (!mMemoryBudget || mOrphanedMemory <= mMemoryBudget)
+            && (!mVideoMemoryBudget
+            || mOrphanedVideoMemory <= mVideoMemoryBudget))
         {
-            ++iter;
-            continue;
-        }
-        const time_t t = res->mTimeStamp;
-        if (!always && t >= threshold)
-        {
-            if (t < oldest)
-                oldest = t;
-            ++ iter;
+            break;
         }
-        else
+
+        logResource(res);
+        removeOrphan(res);
+        mResourceTable.remove(res, res->mIdHash);
+        const ResourceIterator iter = mOrphanedResources.find(res->mIdPath);
+        if (iter != mOrphanedResources.end() && iter->second == res)
+            mOrphanedResources.erase(iter);
+        delete res;  // delete only after removal from list,
+                     // to avoid issues in recursion
+        status = true;
+    }
+    return status;
+}
+
+void ResourceManager::addOrphan(Resource *const res)
+{
+    res->mOrphanMemory = res->getMemorySize();
+    res->mOrphanVideoMemory = res->getVideoMemorySize();
+    mOrphanedMemory += res->mOrphanMemory;
+    mOrphanedVideoMemory += res->mOrphanVideoMemory;
+
+    res->mPrevOrphan = mOrphansTail;
+    res->mNextOrphan = nullptr;
+    if (mOrphansTail)
+        mOrphansTail->mNextOrphan = res;
+    else
+        mOrphansHead = res;
+    mOrphansTail = res;
+}
+
+void ResourceManager::removeOrphan(Resource *const res)
+{
+    if (!res)
+        return;
+
+    mOrphanedMemory -= res->mOrphanMemory;
+    mOrphanedVideoMemory -= res->mOrphanVideoMemory;
+    res->mOrphanMemory = 0;
+    res->mOrphanVideoMemory = 0;
+
+    if (res->mPrevOrphan)
+        res->mPrevOrphan->mNextOrphan = res->mNextOrphan;
+    else if (mOrphansHead == res)
+        mOrphansHead = res->mNextOrphan;
+    if (res->mNextOrphan)
+        res->mNextOrphan->mPrevOrphan = res->mPrevOrphan;
+    else if (mOrphansTail == res)
+        mOrphansTail = res->mPrevOrphan;
+    res->mPrevOrphan = nullptr;
+    res->mNextOrphan = nullptr;
+}
+
+bool ResourceManager::isOrphan(const Resource *const res) const
+{
+    return res->mPrevOrphan || mOrphansHead == res;
+}
+
+void ResourceManager::calcMemoryUsage(size_t &memory,
+                                      size_t &videoMemory) const
+{
+    memory = 0;
+    videoMemory = 0;
+    FOR_EACH (ResourceCIterator, it, mResources)
+    {
+        const Resource *const res = (*it).second;
+        if (res)
         {
-            logResource(res);
-            const ResourceIterator toErase = iter;
-            ++iter;
-            mOrphanedResources.erase(toErase);
-            delete res;  // delete only after removal from list,
-                         // to avoid issues in recursion
-            status = true;
+            memory += res->getMemorySize();
+            videoMemory += res->getVideoMemorySize();
         }
     }
-
-    mOldestOrphan = oldest;
-    return status;
 }
 
 void ResourceManager::logResource(const Resource *const res)
@@ -405,59 +488,70 @@ bool ResourceManager::addResource(const std::string &idPath,
             resource->mIdPath.c_str());
 #endif
         mResources[idPath] = resource;
+        addToTable(resource);
         return true;
     }
     return false;
 }
 
+void ResourceManager::addToTable(Resource *const res)
+{
+    res->mIdHash = ResourceTable::hashId(res->mIdPath);
+    mResourceTable.add(res, res->mIdHash);
+}
+
+const std::string &ResourceManager::buildKey(const std::string &path,
+                                             const int variant)
+{
+    mKeyBuffer.assign(path);
+    mKeyBuffer.append("[");
+    appendInt(mKeyBuffer, variant);
+    mKeyBuffer.append("]");
+    return mKeyBuffer;
+}
+
 Resource *ResourceManager::getFromCache(const std::string &filename,
                                         const int variant)
 {
-    std::stringstream ss;
-    ss << filename << "[" << variant << "]";
-    return getFromCache(ss.str());
+    return getFromCache(buildKey(filename, variant));
 }
 
 bool ResourceManager::isInCache(const std::string &idPath) const
 {
-    const ResourceCIterator &resIter = mResources.find(idPath);
-    return (resIter != mResources.end() && resIter->second);
+    const Resource *const res = mResourceTable.find(idPath,
+        ResourceTable::hashId(idPath));
+    return res && !isOrphan(res);
 }
 
 Resource *ResourceManager::getTempResource(const std::string &idPath)
 {
-    const ResourceCIterator &resIter = mResources.find(idPath);
-    if (resIter != mResources.end())
-    {
-        Resource *const res = resIter->second;
-        if (resIter->second)
-            return res;
-    }
+    Resource *const res = mResourceTable.find(idPath,
+        ResourceTable::hashId(idPath));
+    if (res && !isOrphan(res))
+        return res;
     return nullptr;
 }
 
 Resource *ResourceManager::getFromCache(const std::string &idPath)
 {
     // Check if the id exists, and return the value if it does.
-    ResourceIterator resIter = mResources.find(idPath);
-    if (resIter != mResources.end())
-    {
-        if (resIter->second)
-            resIter->second->incRef();
-        return resIter->second;
-    }
+    Resource *const res = mResourceTable.find(idPath,
+        ResourceTable::hashId(idPath));
+    if (!res)
+        return nullptr;
 
-    resIter = mOrphanedResources.find(idPath);
-    if (resIter != mOrphanedResources.end())
+    if (isOrphan(res))
     {
-        Resource *const res = resIter->second;
-        mResources.insert(*resIter);
-        mOrphanedResources.erase(resIter);
-        if (res)
-            res->incRef();
-        return res;
+        const ResourceIterator resIter = mOrphanedResources.find(idPath);
+        if (resIter != mOrphanedResources.end())
+        {
+            mResources.insert(*resIter);
+            mOrphanedResources.erase(resIter);
+        }
+        removeOrphan(res);
     }
-    return nullptr;
+    res->incRef();
+    return res;
 }
 
 Resource *ResourceManager::get(const std::string &idPath, const generator fun,
@@ -478,6 +572,7 @@ Resource *ResourceManager::get(const std::string &idPath, const generator fun,
             resource->mIdPath.c_str());
 #endif
         mResources[idPath] = resource;
+        addToTable(resource);
         cleanOrphans();
     }
     else
@@ -563,6 +658,20 @@ struct DyedImageLoader final
             return nullptr;
         }
 
+        if (asyncResourceLoader)
+        {
+            SDL_Surface *const surface = asyncResourceLoader->takeSurface(
+                rl->path);
+            if (surface)
+            {
+                // decoded and dyed by loader thread, only upload left
+                Resource *const res = imageHelper->load(surface);
+                MSDL_FreeSurface(surface);
+                BLOCK_END("DyedImageLoader::load")
+                return res;
+            }
+        }
+
         std::string path1 = rl->path;
         const size_t p = path1.find('|');
         Dye *d = nullptr;
@@ -588,6 +697,10 @@ struct DyedImageLoader final
 
 Image *ResourceManager::getImage(const std::string &idPath)
 {
+    Resource *const res = getFromCache(idPath);
+    if (res)
+        return static_cast<Image*>(res);
+
     DyedImageLoader rl = { this, idPath };
     return static_cast<Image*>(get(idPath, &DyedImageLoader::load, &rl));
 }
@@ -619,10 +732,20 @@ struct ImageSetLoader final
 ImageSet *ResourceManager::getImageSet(const std::string &imagePath,
                                        const int w, const int h)
 {
+    mKeyBuffer.assign(imagePath);
+    mKeyBuffer.append("[");
+    appendInt(mKeyBuffer, w);
+    mKeyBuffer.append("x");
+    appendInt(mKeyBuffer, h);
+    mKeyBuffer.append("]");
+    Resource *const res = getFromCache(mKeyBuffer);
+    if (res)
+        return static_cast<ImageSet*>(res);
+
+    // key buffer is reused by nested loads
     ImageSetLoader rl = { this, imagePath, w, h };
-    std::stringstream ss;
-    ss << imagePath << "[" << w << "x" << h << "]";
-    return static_cast<ImageSet*>(get(ss.str(), &ImageSetLoader::load, &rl));
+    return static_cast<ImageSet*>(get(std::string(mKeyBuffer),
+        &ImageSetLoader::load, &rl));
 }
 
 
@@ -654,10 +777,18 @@ ImageSet *ResourceManager::getSubImageSet(Image *const parent,
     if (!parent)
         return nullptr;
 
+    mKeyBuffer.assign(parent->getIdPath());
+    mKeyBuffer.append(", set[");
+    appendInt(mKeyBuffer, width);
+    mKeyBuffer.append("x");
+    appendInt(mKeyBuffer, height);
+    mKeyBuffer.append("]");
+    Resource *const res = getFromCache(mKeyBuffer);
+    if (res)
+        return static_cast<ImageSet*>(res);
+
     const SubImageSetLoader rl = { this, parent, width, height };
-    std::stringstream ss;
-    ss << parent->getIdPath() << ", set[" << width << "x" << height << "]";
-    return static_cast<ImageSet*>(get(ss.str(),
+    return static_cast<ImageSet*>(get(std::string(mKeyBuffer),
         &SubImageSetLoader::load, &rl));
 }
 
@@ -690,12 +821,23 @@ Image *ResourceManager::getSubImage(Image *const parent,
     if (!parent)
         return nullptr;
 
-    const SubImageLoader rl = { this, parent, x, y, width, height};
+    mKeyBuffer.assign(parent->getIdPath());
+    mKeyBuffer.append(",[");
+    appendInt(mKeyBuffer, x);
+    mKeyBuffer.append(",");
+    appendInt(mKeyBuffer, y);
+    mKeyBuffer.append(",");
+    appendInt(mKeyBuffer, width);
+    mKeyBuffer.append("x");
+    appendInt(mKeyBuffer, height);
+    mKeyBuffer.append("]");
+    Resource *const res = getFromCache(mKeyBuffer);
+    if (res)
+        return static_cast<Image*>(res);
 
-    std::stringstream ss;
-    ss << parent->getIdPath() << ",[" << x << "," << y << ","
-        << width << "x" << height << "]";
-    return static_cast<Image*>(get(ss.str(), &SubImageLoader::load, &rl));
+    const SubImageLoader rl = { this, parent, x, y, width, height};
+    return static_cast<Image*>(get(std::string(mKeyBuffer),
+        &SubImageLoader::load, &rl));
 }
 
 #ifdef USE_OPENGL
@@ -822,10 +964,13 @@ struct SpriteDefLoader final
 SpriteDef *ResourceManager::getSprite(const std::string &path,
                                       const int variant)
 {
+    Resource *const res = getFromCache(buildKey(path, variant));
+    if (res)
+        return static_cast<SpriteDef*>(res);
+
     SpriteDefLoader rl = { path, variant, mUseLongLiveSprites };
-    std::stringstream ss;
-    ss << path << "[" << variant << "]";
-    return static_cast<SpriteDef*>(get(ss.str(), &SpriteDefLoader::load, &rl));
+    return static_cast<SpriteDef*>(get(std::string(mKeyBuffer),
+        &SpriteDefLoader::load, &rl));
 }
 
 void ResourceManager::release(Resource *const res)
@@ -863,8 +1008,7 @@ void ResourceManager::release(Resource *const res)
     const time_t timestamp = static_cast<time_t>(tv.tv_sec);
 
     res->mTimeStamp = timestamp;
-    if (mOrphanedResources.empty())
-        mOldestOrphan = timestamp;
+    addOrphan(res);
 
     mOrphanedResources.insert(*resIter);
     mResources.erase(resIter);
@@ -895,11 +1039,13 @@ void ResourceManager::moveToDeleted(Resource *const res)
         if (resIter != mOrphanedResources.end() && resIter->second == res)
         {
             mOrphanedResources.erase(resIter);
+            removeOrphan(res);
             found = true;
         }
     }
     if (found)
     {
+        mResourceTable.remove(res, res->mIdHash);
         if (count > 1)
             mDeletedResources.insert(res);
         else
@@ -926,8 +1072,12 @@ void ResourceManager::decRefDelete(Resource *const res)
         {
             resIter = mOrphanedResources.find(res->mIdPath);
             if (resIter != mOrphanedResources.end() && resIter->second == res)
+            {
                 mOrphanedResources.erase(resIter);
+                removeOrphan(res);
+            }
         }
+        mResourceTable.remove(res, res->mIdHash);
 
         delete res;
     }
@@ -23,6 +23,8 @@
 #ifndef RESOURCES_RESOURCEMANAGER_H
 #define RESOURCES_RESOURCEMANAGER_H
 
+#include "resources/resourcetable.h"
+
 #include "utils/stringvector.h"
 
 #include <map>
@@ -246,8 +248,24 @@ class ResourceManager final
         { return &mOrphanedResources; }
 #endif
 
+        /**
+         * Deletes orphaned resources released more than 30 seconds ago,
+         * and least recently released ones while orphans exceed memory
+         * budgets.
+         */
         bool cleanOrphans(const bool always = false);
 
+        /**
+         * Counts memory and texture memory of resources in use.
+         */
+        void calcMemoryUsage(size_t &memory, size_t &videoMemory) const;
+
+        size_t getOrphanedMemory() const A_WARN_UNUSED
+        { return mOrphanedMemory; }
+
+        size_t getOrphanedVideoMemory() const A_WARN_UNUSED
+        { return mOrphanedVideoMemory; }
+
         void cleanProtected();
 
         bool isInCache(const std::string &idPath) const A_WARN_UNUSED;
@@ -262,12 +280,42 @@ class ResourceManager final
          */
         static void cleanUp(Resource *const resource);
 
+        /**
+         * Appends resource to orphans list and memory totals.
+         */
+        void addOrphan(Resource *const res);
+
+        /**
+         * Removes resource from orphans list and memory totals.
+         */
+        void removeOrphan(Resource *const res);
+
+        bool isOrphan(const Resource *const res) const A_WARN_UNUSED;
+
+        void addToTable(Resource *const res);
+
+        /**
+         * Builds path[variant] key in key buffer.
+         */
+        const std::string &buildKey(const std::string &path,
+                                    const int variant) A_WARN_UNUSED;
+
         static ResourceManager *instance;
         std::set<SDL_Surface*> deletedSurfaces;
         Resources mResources;
         Resources mOrphanedResources;
+        // all resources from mResources and mOrphanedResources
+        ResourceTable mResourceTable;
+        // reused for building composite keys without allocations
+        std::string mKeyBuffer;
         std::set<Resource*> mDeletedResources;
-        time_t mOldestOrphan;
+        // orphans list, least recently released first
+        Resource *mOrphansHead;
+        Resource *mOrphansTail;
+        size_t mOrphanedMemory;
+        size_t mOrphanedVideoMemory;
+        size_t mMemoryBudget;
+        size_t mVideoMemoryBudget;
         bool mDestruction;
         bool mUseLongLiveSprites;
 };
@@ -0,0 +1,146 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/resourcetable.h"
+
+#include "resources/resource.h"
+
+#include "debug.h"
+
+namespace
+{
+    const unsigned int minCapacity = 1024U;
+}  // namespace
+
+ResourceTable::ResourceTable() :
+    mEntries(minCapacity),
+    mMask(minCapacity - 1),
+    mCount(0U)
+{
+}
+
+unsigned int ResourceTable::hashId(const std::string &idPath)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261U;
+    const size_t sz = idPath.size();
+    const char *const str = idPath.data();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        hash ^= static_cast<unsigned char>(str[f]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+void ResourceTable::add(Resource *const resource, const unsigned int hash)
+{
+    if (!resource)
+        return;
+
+    // keep load factor below half
+    if ((mCount + 1) * 2 > mEntries.size())
+        rehash(static_cast<unsigned int>(mEntries.size()) * 2);
+
+    const std::string &idPath = resource->getIdPath();
+    unsigned int pos = hash & mMask;
+    while (mEntries[pos].resource)
+    {
+        Entry &entry = mEntries[pos];
+        if (entry.hash == hash && entry.resource->getIdPath() == idPath)
+        {
+            entry.resource = resource;
+            return;
+        }
+        pos = (pos + 1) & mMask;
+    }
+    mEntries[pos].resource = resource;
+    mEntries[pos].hash = hash;
+    mCount ++;
+}
+
+void ResourceTable::remove(const Resource *const resource,
+                           const unsigned int hash)
+{
+    if (!resource)
+        return;
+
+    unsigned int pos = hash & mMask;
+    while (mEntries[pos].resource != resource)
+    {
+        if (!mEntries[pos].resource)
+            return;
+        pos = (pos + 1) & mMask;
+    }
+
+    // shift back entries of same probe chain, so no tombstones needed
+    unsigned int next = (pos + 1) & mMask;
+    while (mEntries[next].resource)
+    {
+        const unsigned int ideal = mEntries[next].hash & mMask;
+        if (((next - ideal) & mMask) >= ((next - pos) & mMask))
+        {
+            mEntries[pos] = mEntries[next];
+            pos = next;
+        }
+        next = (next + 1) & mMask;
+    }
+    mEntries[pos] = Entry();
+    mCount --;
+}
+
+Resource *ResourceTable::find(const std::string &idPath,
+                              const unsigned int hash) const
+{
+    unsigned int pos = hash & mMask;
+    while (mEntries[pos].resource)
+    {
+        const Entry &entry = mEntries[pos];
+        if (entry.hash == hash && entry.resource->getIdPath() == idPath)
+            return entry.resource;
+        pos = (pos + 1) & mMask;
+    }
+    return nullptr;
+}
+
+void ResourceTable::clear()
+{
+    mEntries.clear();
+    mEntries.resize(minCapacity);
+    mMask = minCapacity - 1;
+    mCount = 0U;
+}
+
+void ResourceTable::rehash(const unsigned int capacity)
+{
+    std::vector<Entry> oldEntries(capacity);
+    oldEntries.swap(mEntries);
+    mMask = capacity - 1;
+    FOR_EACH (std::vector<Entry>::const_iterator, it, oldEntries)
+    {
+        const Entry &entry = *it;
+        if (!entry.resource)
+            continue;
+        unsigned int pos = entry.hash & mMask;
+        while (mEntries[pos].resource)
+            pos = (pos + 1) & mMask;
+        mEntries[pos] = entry;
+    }
+}
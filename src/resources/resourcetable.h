@@ -0,0 +1,79 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_RESOURCETABLE_H
+#define RESOURCES_RESOURCETABLE_H
+
+#include <string>
+#include <vector>
+
+#include "localconsts.h"
+
+class Resource;
+
+/**
+ * Open addressing hash table of resources by id path. Resources are not
+ * owned, id path hashes computed by caller with hashId.
+ */
+class ResourceTable final
+{
+    public:
+        ResourceTable();
+
+        A_DELETE_COPY(ResourceTable)
+
+        static unsigned int hashId(const std::string &idPath) A_WARN_UNUSED;
+
+        /**
+         * Adds resource, replacing resource with same id path.
+         */
+        void add(Resource *const resource, const unsigned int hash);
+
+        void remove(const Resource *const resource, const unsigned int hash);
+
+        Resource *find(const std::string &idPath,
+                       const unsigned int hash) const A_WARN_UNUSED;
+
+        void clear();
+
+        unsigned int size() const A_WARN_UNUSED
+        { return mCount; }
+
+    private:
+        struct Entry final
+        {
+            Entry() :
+                resource(nullptr),
+                hash(0U)
+            {
+            }
+
+            Resource *resource;
+            unsigned int hash;
+        };
+
+        void rehash(const unsigned int capacity);
+
+        std::vector<Entry> mEntries;
+        unsigned int mMask;
+        unsigned int mCount;
+};
+
+#endif  // RESOURCES_RESOURCETABLE_H
@@ -40,12 +40,13 @@
 
 bool SDLImageHelper::mEnableAlphaCache = false;
 
-Image *SDLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
+SDL_Surface *SDLImageHelper::loadDyedSurface(SDL_RWops *const rw,
+                                             Dye const &dye) const
 {
     SDL_Surface *const tmpImage = loadPng(rw);
     if (!tmpImage)
     {
-        logger->log("Error, image load failed: %s", IMG_GetError());
+        logger->log_r("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
@@ -99,9 +100,7 @@ Image *SDLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         }
     }
 
-    Image *const image = load(surf);
-    MSDL_FreeSurface(surf);
-    return image;
+    return surf;
 }
 
 Image *SDLImageHelper::load(SDL_Surface *const tmpImage)
@@ -30,6 +30,7 @@
 
 #include "resources/action.h"
 #include "resources/animation.h"
+#include "resources/asyncresourceloader.h"
 #include "resources/dye.h"
 #include "resources/imageset.h"
 #include "resources/resourcemanager.h"
@@ -87,12 +88,13 @@ SpriteDef *SpriteDef::load(const std::string &animationFile,
     if (pos != std::string::npos)
         palettes = animationFile.substr(pos + 1);
 
-    XML::Document doc(animationFile.substr(0, pos), true, false);
-    XmlNodePtrConst rootNode = doc.rootNode();
+    XML::Document *const doc = loadDocument(animationFile.substr(0, pos));
+    XmlNodePtrConst rootNode = doc->rootNode();
 
     if (!rootNode || !xmlNameEqual(rootNode, "sprite"))
     {
         logger->log("Error, failed to parse %s", animationFile.c_str());
+        delete doc;
 
         const std::string errorFile = paths.getStringValue("sprites").append(
             paths.getStringValue("spriteErrorFile"));
@@ -109,6 +111,7 @@ SpriteDef *SpriteDef::load(const std::string &animationFile,
     def->substituteActions();
     if (settings.fixDeadAnimation)
         def->fixDeadAction();
+    delete doc;
     if (prot)
     {
         def->incRef();
@@ -434,16 +437,30 @@ void SpriteDef::includeSprite(const XmlNodePtr includeNode, const int variant)
     }
     mProcessedFiles.insert(filename);
 
-    XML::Document doc(filename, true, false);
-    const XmlNodePtr rootNode = doc.rootNode();
+    XML::Document *const doc = loadDocument(filename);
+    const XmlNodePtr rootNode = doc->rootNode();
 
     if (!rootNode || !xmlNameEqual(rootNode, "sprite"))
     {
         logger->log("Error, no sprite root node in %s", filename.c_str());
+        delete doc;
         return;
     }
 
     loadSprite(rootNode, variant);
+    delete doc;
+}
+
+XML::Document *SpriteDef::loadDocument(const std::string &fileName)
+{
+    if (asyncResourceLoader)
+    {
+        XML::Document *const doc = asyncResourceLoader->takeDocument(
+            fileName);
+        if (doc)
+            return doc;
+    }
+    return new XML::Document(fileName, true, false);
 }
 
 SpriteDef::~SpriteDef()
@@ -127,6 +127,13 @@ class SpriteDef final : public Resource
          */
         void includeSprite(const XmlNodePtr includeNode, const int variant);
 
+        /**
+         * Returns document prepared by resource loader thread or loads it.
+         * Caller owns document.
+         */
+        static XML::Document *loadDocument(const std::string &fileName)
+                                           A_WARN_UNUSED;
+
         /**
          * Complete missing actions by copying existing ones.
          */
@@ -82,6 +82,15 @@ class SubImage final : public Image
         void decRef() override final;
 #endif
 
+        /**
+         * Pixels are owned by parent image.
+         */
+        int getMemorySize() const override final A_WARN_UNUSED
+        { return 0; }
+
+        int getVideoMemorySize() const override final A_WARN_UNUSED
+        { return 0; }
+
         SDL_Rect mInternalBounds;
 
     private:
@@ -33,8 +33,6 @@
 #include "resources/imageset.h"
 #include "resources/resourcemanager.h"
 
-#include "utils/delete2.h"
-
 #include "debug.h"
 
 SimpleAnimation::SimpleAnimation(Animation *const animation) :
@@ -43,29 +41,44 @@ SimpleAnimation::SimpleAnimation(Animation *const animation) :
     mAnimationPhase(0),
     mCurrentFrame(&mAnimation->mFrames[0]),
     mInitialized(true),
+    mOwnAnimation(true),
+    mImageSet(nullptr)
+{
+}
+
+SimpleAnimation::SimpleAnimation(const Animation &animation) :
+    mAnimation(&animation),
+    mAnimationTime(0),
+    mAnimationPhase(0),
+    mCurrentFrame(animation.mFrames.empty()
+        ? nullptr : &animation.mFrames[0]),
+    mInitialized(true),
+    mOwnAnimation(false),
     mImageSet(nullptr)
 {
 }
 
 SimpleAnimation::SimpleAnimation(const XmlNodePtr animationNode,
                                  const std::string& dyePalettes) :
-    mAnimation(new Animation),
+    mAnimation(nullptr),
     mAnimationTime(0),
     mAnimationPhase(0),
     mCurrentFrame(nullptr),
     mInitialized(false),
+    mOwnAnimation(true),
     mImageSet(nullptr)
 {
-    initializeAnimation(animationNode, dyePalettes);
-    if (mAnimation)
-        mCurrentFrame = &mAnimation->mFrames[0];
-    else
-        mCurrentFrame = nullptr;
+    Animation *const animation = new Animation;
+    mAnimation = animation;
+    initializeAnimation(animation, animationNode, dyePalettes);
+    mCurrentFrame = &mAnimation->mFrames[0];
 }
 
 SimpleAnimation::~SimpleAnimation()
 {
-    delete2(mAnimation);
+    if (mOwnAnimation)
+        delete mAnimation;
+    mAnimation = nullptr;
     if (mImageSet)
     {
         mImageSet->decRef();
@@ -143,7 +156,8 @@ Image *SimpleAnimation::getCurrentImage() const
         return nullptr;
 }
 
-void SimpleAnimation::initializeAnimation(const XmlNodePtr animationNode,
+void SimpleAnimation::initializeAnimation(Animation *const animation,
+                                          const XmlNodePtr animationNode,
                                           const std::string &dyePalettes)
 {
     mInitialized = false;
@@ -158,11 +172,12 @@ void SimpleAnimation::initializeAnimation(const XmlNodePtr animationNode,
     if (!imagePath.empty() && !dyePalettes.empty())
         Dye::instantiate(imagePath, dyePalettes);
 
-    const ImageSet *const imageset = ResourceManager::getInstance()
-        ->getImageSet(XML::getProperty(animationNode, "imageset", ""),
+    // keep reference to imageset while frames point to its images
+    mImageSet = ResourceManager::getInstance()->getImageSet(imagePath,
         XML::getProperty(animationNode, "width", 0),
         XML::getProperty(animationNode, "height", 0));
 
+    const ImageSet *const imageset = mImageSet;
     if (!imageset)
         return;
 
@@ -197,8 +212,7 @@ void SimpleAnimation::initializeAnimation(const XmlNodePtr animationNode,
                 continue;
             }
 
-            if (mAnimation)
-                mAnimation->addFrame(img, delay, offsetX, offsetY, rand);
+            animation->addFrame(img, delay, offsetX, offsetY, rand);
         }
         else if (xmlNameEqual(frameNode, "sequence"))
         {
@@ -221,15 +235,13 @@ void SimpleAnimation::initializeAnimation(const XmlNodePtr animationNode,
                     continue;
                 }
 
-                if (mAnimation)
-                    mAnimation->addFrame(img, delay, offsetX, offsetY, rand);
+                animation->addFrame(img, delay, offsetX, offsetY, rand);
                 start++;
             }
         }
         else if (xmlNameEqual(frameNode, "end"))
         {
-            if (mAnimation)
-                mAnimation->addTerminator(rand);
+            animation->addTerminator(rand);
         }
     }
 
@@ -47,6 +47,12 @@ class SimpleAnimation final
          */
         explicit SimpleAnimation(Animation *const animation);
 
+        /**
+         * Creates a simple animation that plays \a animation without
+         * taking ownership. The animation must outlive this object.
+         */
+        explicit SimpleAnimation(const Animation &animation);
+
         /**
          * Creates a simple animation that creates its animation from XML Data.
          */
@@ -73,13 +79,17 @@ class SimpleAnimation final
 
         Image *getCurrentImage() const A_WARN_UNUSED;
 
+        const Animation *getAnimation() const A_WARN_UNUSED
+        { return mAnimation; }
+
     private:
-        void initializeAnimation(const XmlNodePtr animationNode,
+        void initializeAnimation(Animation *const animation,
+                                 const XmlNodePtr animationNode,
                                  const std::string&
                                  dyePalettes = std::string());
 
         /** The hosted animation. */
-        Animation *mAnimation;
+        const Animation *mAnimation;
 
         /** Time in game ticks the current frame is shown. */
         int mAnimationTime;
@@ -93,6 +103,9 @@ class SimpleAnimation final
         /**  Tell whether the animation is ready */
         bool mInitialized;
 
+        /** Tell whether the animation deleted with this object */
+        bool mOwnAnimation;
+
         ImageSet *mImageSet;
 };
 
@@ -24,6 +24,14 @@
 
 #include "utils/stringutils.h"
 
+#ifdef USE_SDL2
+#include <SDL_cpuinfo.h>
+#elif defined(WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "debug.h"
 
 int mCpuFlags = 0;
@@ -44,6 +52,8 @@ void Cpu::detect()
         mCpuFlags |= FEATURE_SSE4;
     if (__builtin_cpu_supports ("sse4.2"))
         mCpuFlags |= FEATURE_SSE42;
+    if (__builtin_cpu_supports ("avx2"))
+        mCpuFlags |= FEATURE_AVX2;
     printFlags();
 #elif defined(__linux__) || defined(__linux)
     FILE *file = fopen("/proc/cpuinfo", "r");
@@ -77,6 +87,8 @@ void Cpu::detect()
                     mCpuFlags |= FEATURE_SSE4;
                 else if (flag == "sse4_2")
                     mCpuFlags |= FEATURE_SSE42;
+                else if (flag == "avx2")
+                    mCpuFlags |= FEATURE_AVX2;
             }
             fclose(file);
             printFlags();
@@ -103,5 +115,28 @@ void Cpu::printFlags()
         str.append(" sse4");
     if (mCpuFlags & FEATURE_SSE42)
         str.append(" sse4_2");
+    if (mCpuFlags & FEATURE_AVX2)
+        str.append(" avx2");
     logger->log(str);
 }
+
+int Cpu::getFlags()
+{
+    return mCpuFlags;
+}
+
+int Cpu::getCount()
+{
+#ifdef USE_SDL2
+    const int count = SDL_GetCPUCount();
+#elif defined(WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const int count = static_cast<int>(info.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+    const int count = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#else
+    const int count = 1;
+#endif
+    return count > 0 ? count : 1;
+}
@@ -33,12 +33,20 @@ namespace Cpu
         FEATURE_SSE2  = 4,
         FEATURE_SSSE3 = 8,
         FEATURE_SSE4  = 16,
-        FEATURE_SSE42 = 32
+        FEATURE_SSE42 = 32,
+        FEATURE_AVX2  = 64
     };
 
     void detect();
 
     void printFlags();
+
+    int getFlags() A_WARN_UNUSED;
+
+    /**
+     * Returns number of online logical cpus, at least 1.
+     */
+    int getCount() A_WARN_UNUSED;
 }  // namespace CPU
 
 #endif  // UTILS_CPU_H
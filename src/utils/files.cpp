@@ -31,11 +31,20 @@
 #include "utils/mkdir.h"
 #include "utils/paths.h"
 #include "utils/physfstools.h"
+#include "utils/stringutils.h"
 
 #include <dirent.h>
 #include <fstream>
 #include <sstream>
 
+#include <SDL_thread.h>
+
+#ifdef WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif  // WIN32
+
 #include "debug.h"
 
 #ifdef ANDROID
@@ -173,6 +182,17 @@ int Files::renameFile(const std::string &restrict srcName,
 #endif
 }
 
+std::string Files::getTempName(const std::string &fileName)
+{
+#ifdef WIN32
+    const unsigned long pid = static_cast<unsigned long>(_getpid());
+#else
+    const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif  // WIN32
+    return strprintf("%s.%lu.%lu", fileName.c_str(), pid,
+        static_cast<unsigned long>(SDL_ThreadID()));
+}
+
 int Files::copyFile(const std::string &restrict srcName,
                     const std::string &restrict dstName)
 {
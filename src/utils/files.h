@@ -53,6 +53,12 @@ namespace Files
     int copyFile(const std::string &restrict pFrom,
                  const std::string &restrict pTo);
 
+    /**
+     * Returns name for temp file near fileName, unique for process and
+     * thread. File written there can be renamed to fileName later.
+     */
+    std::string getTempName(const std::string &fileName);
+
     void getFiles(const std::string &path, StringVect &list);
 
     void getDirs(const std::string &path, StringVect &list);
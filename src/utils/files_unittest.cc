@@ -69,3 +69,12 @@ TEST(Files, renameFile)
     delete [] buf;
     delete [] buf2;
 }
+
+TEST(Files, getTempName)
+{
+    const std::string name = "dir/file.test";
+    const std::string tempName = Files::getTempName(name);
+    EXPECT_NE(name, tempName);
+    EXPECT_EQ(0U, tempName.find(name + "."));
+    EXPECT_EQ(tempName, Files::getTempName(name));
+}
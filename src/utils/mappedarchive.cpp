@@ -0,0 +1,396 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/mappedarchive.h"
+
+#include "utils/delete2.h"
+#include "utils/dtor.h"
+
+#include <SDL_mutex.h>
+
+#include <algorithm>
+#include <cstring>
+#include <physfs.h>
+
+#include <sys/stat.h>
+
+#include "debug.h"
+
+namespace
+{
+    const uint32_t zipEndSignature = 0x06054b50U;
+    const uint32_t zipDirSignature = 0x02014b50U;
+    const uint32_t zipHeaderSignature = 0x04034b50U;
+    const size_t zipEndSize = 22;
+    const size_t zipDirSize = 46;
+    const size_t zipHeaderSize = 30;
+    // end record followed by comment up to 64k
+    const size_t zipMaxCommentSize = 65535;
+
+    uint16_t readShort(const char *const ptr)
+    {
+        const unsigned char *const p =
+            reinterpret_cast<const unsigned char*>(ptr);
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    uint32_t readInt(const char *const ptr)
+    {
+        const unsigned char *const p =
+            reinterpret_cast<const unsigned char*>(ptr);
+        return static_cast<uint32_t>(p[0])
+            | (static_cast<uint32_t>(p[1]) << 8)
+            | (static_cast<uint32_t>(p[2]) << 16)
+            | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint32_t hashName(const char *const name, const size_t size)
+    {
+        // FNV-1a
+        uint32_t hash = 2166136261U;
+        for (size_t f = 0; f < size; f ++)
+        {
+            hash ^= static_cast<unsigned char>(name[f]);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    // takes mapping of unchanged archive from list
+    MappedArchive *takeArchive(std::vector<MappedArchive*> &archives,
+                               const std::string &path)
+    {
+        FOR_EACH (std::vector<MappedArchive*>::iterator, it, archives)
+        {
+            MappedArchive *const archive = *it;
+            if (archive
+                && archive->getFileName() == path
+                && !archive->isChanged())
+            {
+                archives.erase(it);
+                return archive;
+            }
+        }
+        return nullptr;
+    }
+
+    bool mEnabled = false;
+    SDL_mutex *mMutex = nullptr;
+    // same order as PhysFS search path, nullptr for not mapped entries
+    std::vector<MappedArchive*> mArchives;
+    // directories of not mapped entries, empty for other archive types
+    std::vector<std::string> mDirs;
+    std::vector<MappedArchive*> mRetired;
+
+    bool isDirectory(const std::string &path)
+    {
+        struct stat statbuf;
+        return !stat(path.c_str(), &statbuf) && S_ISDIR(statbuf.st_mode);
+    }
+
+    bool existsInDir(const std::string &dir,
+                     const std::string &fileName)
+    {
+        std::string path = dir;
+        const char last = path.empty() ? 0 : path[path.size() - 1];
+        if (last != '/' && last != '\\')
+            path.append("/");
+        path.append(fileName);
+        struct stat statbuf;
+        return !stat(path.c_str(), &statbuf);
+    }
+}  // namespace
+
+bool operator<(const MappedArchive::Entry &e1, const MappedArchive::Entry &e2)
+{
+    return e1.hash < e2.hash;
+}
+
+bool operator<(const MappedArchive::Entry &e1, const uint32_t hash)
+{
+    return e1.hash < hash;
+}
+
+MappedArchive::MappedArchive() :
+    mFile(),
+    mFileName(),
+    mEntries(),
+    mTime(0)
+{
+}
+
+bool MappedArchive::open(const std::string &fileName)
+{
+    mFileName = fileName;
+    mEntries.clear();
+    struct stat statbuf;
+    if (stat(fileName.c_str(), &statbuf))
+        return false;
+    mTime = statbuf.st_mtime;
+    if (!mFile.open(fileName))
+        return false;
+    if (!mFile.isMapped() || mFile.getSize() < zipEndSize)
+    {
+        mFile.close();
+        return false;
+    }
+
+    const char *const data = mFile.getData();
+    const size_t fileSize = mFile.getSize();
+
+    // search end of central directory record from end of file
+    const size_t minPos = fileSize > zipEndSize + zipMaxCommentSize
+        ? fileSize - zipEndSize - zipMaxCommentSize : 0;
+    size_t endPos = fileSize - zipEndSize + 1;
+    do
+    {
+        endPos --;
+        if (readInt(data + endPos) == zipEndSignature)
+            break;
+    }
+    while (endPos > minPos);
+
+    const char *const end = data + endPos;
+    if (readInt(end) != zipEndSignature
+        || readShort(end + 4) != 0
+        || readShort(end + 6) != 0)
+    {
+        // not zip or multi disk archive
+        mFile.close();
+        return false;
+    }
+
+    const size_t count = readShort(end + 10);
+    const size_t dirSize = readInt(end + 12);
+    const size_t dirOffset = readInt(end + 16);
+    if (count == 0xffffU
+        || dirOffset == 0xffffffffU
+        || dirOffset > endPos
+        || dirSize > endPos - dirOffset)
+    {
+        // zip64 or broken archive
+        mFile.close();
+        return false;
+    }
+
+    mEntries.reserve(count);
+    size_t pos = dirOffset;
+    const size_t dirEnd = dirOffset + dirSize;
+    for (size_t f = 0; f < count; f ++)
+    {
+        const char *const ptr = data + pos;
+        if (dirEnd - pos < zipDirSize
+            || readInt(ptr) != zipDirSignature)
+        {
+            mEntries.clear();
+            mFile.close();
+            return false;
+        }
+
+        const uint16_t flags = readShort(ptr + 8);
+        const uint16_t method = readShort(ptr + 10);
+        const uint32_t packedSize = readInt(ptr + 20);
+        const uint32_t size = readInt(ptr + 24);
+        const uint16_t nameSize = readShort(ptr + 28);
+        const size_t recordSize = zipDirSize + nameSize
+            + readShort(ptr + 30) + readShort(ptr + 32);
+        const uint32_t headerOffset = readInt(ptr + 42);
+        if (dirEnd - pos < recordSize)
+        {
+            mEntries.clear();
+            mFile.close();
+            return false;
+        }
+
+        const char *const name = ptr + zipDirSize;
+        // skip directories
+        if (nameSize > 0 && name[nameSize - 1] != '/')
+        {
+            Entry entry;
+            entry.hash = hashName(name, nameSize);
+            entry.nameOffset = static_cast<uint32_t>(pos + zipDirSize);
+            entry.headerOffset = headerOffset;
+            entry.size = size;
+            entry.nameSize = nameSize;
+            // encrypted entries left to PhysFS
+            // encrypted and empty entries left to PhysFS
+            entry.stored = method == 0
+                && (flags & 1) == 0
+                && packedSize == size
+                && size > 0
+                && headerOffset < dirOffset;
+            mEntries.push_back(entry);
+        }
+        pos += recordSize;
+    }
+
+    std::stable_sort(mEntries.begin(), mEntries.end());
+    return true;
+}
+
+bool MappedArchive::find(const std::string &name,
+                         const char *&data,
+                         size_t &size) const
+{
+    const char *const base = mFile.getData();
+    const uint32_t hash = hashName(name.data(), name.size());
+    std::vector<Entry>::const_iterator it = std::lower_bound(
+        mEntries.begin(), mEntries.end(), hash);
+    for (; it != mEntries.end() && (*it).hash == hash; ++ it)
+    {
+        const Entry &entry = *it;
+        if (entry.nameSize != name.size()
+            || memcmp(base + entry.nameOffset, name.data(), name.size()))
+        {
+            continue;
+        }
+
+        data = nullptr;
+        size = entry.size;
+        if (!entry.stored)
+            return true;
+
+        // local header can have own extra field
+        const size_t fileSize = mFile.getSize();
+        const size_t offset = entry.headerOffset;
+        if (fileSize - offset < zipHeaderSize
+            || readInt(base + offset) != zipHeaderSignature)
+        {
+            return true;
+        }
+        const size_t dataOffset = offset + zipHeaderSize
+            + readShort(base + offset + 26) + readShort(base + offset + 28);
+        if (dataOffset > fileSize || fileSize - dataOffset < entry.size)
+            return true;
+
+        data = base + dataOffset;
+        return true;
+    }
+    return false;
+}
+
+bool MappedArchive::isChanged() const
+{
+    struct stat statbuf;
+    return stat(mFileName.c_str(), &statbuf)
+        || statbuf.st_mtime != mTime
+        || static_cast<size_t>(statbuf.st_size) != mFile.getSize();
+}
+
+void MappedArchives::init(const bool enabled)
+{
+    mEnabled = enabled;
+    if (!mEnabled)
+        return;
+    if (!mMutex)
+        mMutex = SDL_CreateMutex();
+    update();
+}
+
+void MappedArchives::update()
+{
+    if (!mEnabled)
+        return;
+
+    char **const list = PHYSFS_getSearchPath();
+    if (!list)
+        return;
+
+    std::vector<MappedArchive*> archives;
+    std::vector<std::string> dirs;
+    std::vector<MappedArchive*> oldArchives = mArchives;
+    for (char **i = list; *i; i ++)
+    {
+        const std::string path = *i;
+        MappedArchive *archive = takeArchive(oldArchives, path);
+        // archive added again, for example after server switch
+        if (!archive)
+            archive = takeArchive(mRetired, path);
+        if (!archive && !isDirectory(path))
+        {
+            archive = new MappedArchive;
+            if (!archive->open(path))
+                delete2(archive);
+            dirs.push_back(std::string());
+        }
+        else
+        {
+            dirs.push_back(archive ? std::string() : path);
+        }
+        archives.push_back(archive);
+    }
+    PHYSFS_freeList(list);
+
+    SDL_mutexP(mMutex);
+    mArchives.swap(archives);
+    mDirs.swap(dirs);
+    FOR_EACH (std::vector<MappedArchive*>::iterator, it, oldArchives)
+    {
+        if (*it)
+            mRetired.push_back(*it);
+    }
+    SDL_mutexV(mMutex);
+}
+
+bool MappedArchives::getView(const std::string &fileName,
+                             const char *&data,
+                             size_t &size)
+{
+    if (!mEnabled)
+        return false;
+
+    bool found = false;
+    SDL_mutexP(mMutex);
+    const size_t sz = mArchives.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const MappedArchive *const archive = mArchives[f];
+        if (!archive)
+        {
+            const std::string &dir = mDirs[f];
+            // other archive type or file in directory, leave it to PhysFS
+            if (dir.empty() || existsInDir(dir, fileName))
+                break;
+            continue;
+        }
+        if (archive->find(fileName, data, size))
+        {
+            found = data != nullptr;
+            break;
+        }
+    }
+    SDL_mutexV(mMutex);
+    return found;
+}
+
+void MappedArchives::clear()
+{
+    mEnabled = false;
+    delete_all(mArchives);
+    mArchives.clear();
+    mDirs.clear();
+    delete_all(mRetired);
+    mRetired.clear();
+    if (mMutex)
+    {
+        SDL_DestroyMutex(mMutex);
+        mMutex = nullptr;
+    }
+}
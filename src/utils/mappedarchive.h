@@ -0,0 +1,116 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_MAPPEDARCHIVE_H
+#define UTILS_MAPPEDARCHIVE_H
+
+#include "utils/mappedfile.h"
+
+#include <ctime>
+#include <stdint.h>
+#include <vector>
+
+#include "localconsts.h"
+
+/**
+ * Memory mapped zip archive with hash index of entries.
+ */
+class MappedArchive final
+{
+    public:
+        MappedArchive();
+
+        A_DELETE_COPY(MappedArchive)
+
+        /**
+         * Maps and indexes zip file. Returns false for other files, zip64
+         * archives and if memory mapping not supported.
+         */
+        bool open(const std::string &fileName);
+
+        /**
+         * Returns false if archive have no such entry. For entries stored
+         * without compression and encryption sets data pointer to entry
+         * contents inside mapping, for others sets it to nullptr.
+         */
+        bool find(const std::string &name,
+                  const char *&data,
+                  size_t &size) const A_WARN_UNUSED;
+
+        const std::string &getFileName() const A_WARN_UNUSED
+        { return mFileName; }
+
+        /**
+         * Returns true if file size or modification time differs from
+         * mapped file.
+         */
+        bool isChanged() const A_WARN_UNUSED;
+
+    private:
+        struct Entry final
+        {
+            uint32_t hash;
+            // offsets of name and local header in mapping
+            uint32_t nameOffset;
+            uint32_t headerOffset;
+            uint32_t size;
+            uint16_t nameSize;
+            bool stored;
+        };
+
+        friend bool operator<(const Entry &e1, const Entry &e2);
+        friend bool operator<(const Entry &e1, const uint32_t hash);
+
+        MappedFile mFile;
+        std::string mFileName;
+        std::vector<Entry> mEntries;
+        time_t mTime;
+};
+
+/**
+ * Mirror of PhysFS search path, what can serve files from mapped zip
+ * archives without PhysFS lookup and copying. Directories skipped if they
+ * have no such file. Lookup stops on first directory with file or unknown
+ * archive in search path, so same file wins as in PhysFS.
+ * Removed archives kept mapped until clear, so views stay valid. They
+ * reused if same unchanged archive added to search path again.
+ */
+namespace MappedArchives
+{
+    void init(const bool enabled);
+
+    /**
+     * Syncs archives with PhysFS search path. Called after search path
+     * changes.
+     */
+    void update();
+
+    /**
+     * Returns true and zero copy view of file if it stored without
+     * compression in archive what PhysFS would use for it.
+     */
+    bool getView(const std::string &fileName,
+                 const char *&data,
+                 size_t &size) A_WARN_UNUSED;
+
+    void clear();
+}  // namespace MappedArchives
+
+#endif  // UTILS_MAPPEDARCHIVE_H
@@ -0,0 +1,165 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/mappedarchive.h"
+
+#include "utils/mkdir.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <physfs.h>
+#include <zlib.h>
+
+#include "debug.h"
+
+static void writeShort(std::string &str, const unsigned int val)
+{
+    str.append(1, static_cast<char>(val & 0xff));
+    str.append(1, static_cast<char>((val >> 8) & 0xff));
+}
+
+static void writeInt(std::string &str, const unsigned int val)
+{
+    writeShort(str, val & 0xffff);
+    writeShort(str, (val >> 16) & 0xffff);
+}
+
+// writes zip with stored entries
+static void writeZip(const std::string &fileName,
+                     const std::vector<std::string> &names,
+                     const std::vector<std::string> &contents)
+{
+    std::string zip;
+    std::string dir;
+    for (size_t f = 0; f < names.size(); f ++)
+    {
+        const std::string &name = names[f];
+        const std::string &content = contents[f];
+        const unsigned int crc = static_cast<unsigned int>(crc32(0,
+            reinterpret_cast<const Bytef*>(content.data()),
+            static_cast<uInt>(content.size())));
+        const unsigned int offset = static_cast<unsigned int>(zip.size());
+
+        writeInt(zip, 0x04034b50U);
+        writeShort(zip, 10);
+        writeShort(zip, 0);
+        writeShort(zip, 0);
+        writeShort(zip, 0);
+        writeShort(zip, 0x21);
+        writeInt(zip, crc);
+        writeInt(zip, static_cast<unsigned int>(content.size()));
+        writeInt(zip, static_cast<unsigned int>(content.size()));
+        writeShort(zip, static_cast<unsigned int>(name.size()));
+        writeShort(zip, 0);
+        zip.append(name).append(content);
+
+        writeInt(dir, 0x02014b50U);
+        writeShort(dir, 10);
+        writeShort(dir, 10);
+        writeShort(dir, 0);
+        writeShort(dir, 0);
+        writeShort(dir, 0);
+        writeShort(dir, 0x21);
+        writeInt(dir, crc);
+        writeInt(dir, static_cast<unsigned int>(content.size()));
+        writeInt(dir, static_cast<unsigned int>(content.size()));
+        writeShort(dir, static_cast<unsigned int>(name.size()));
+        writeShort(dir, 0);
+        writeShort(dir, 0);
+        writeShort(dir, 0);
+        writeShort(dir, 0);
+        writeInt(dir, 0);
+        writeInt(dir, offset);
+        dir.append(name);
+    }
+    const unsigned int dirOffset = static_cast<unsigned int>(zip.size());
+    zip.append(dir);
+    writeInt(zip, 0x06054b50U);
+    writeShort(zip, 0);
+    writeShort(zip, 0);
+    writeShort(zip, static_cast<unsigned int>(names.size()));
+    writeShort(zip, static_cast<unsigned int>(names.size()));
+    writeInt(zip, static_cast<unsigned int>(dir.size()));
+    writeInt(zip, dirOffset);
+    writeShort(zip, 0);
+
+    FILE *const file = fopen(fileName.c_str(), "wb");
+    fwrite(zip.data(), 1, zip.size(), file);
+    fclose(file);
+}
+
+static void writeFile(const std::string &fileName,
+                      const std::string &content)
+{
+    FILE *const file = fopen(fileName.c_str(), "wb");
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+}
+
+TEST(MappedArchives, directoryBeforeArchive)
+{
+    PHYSFS_init("manaplus");
+    const std::string dirName = "mappedarchive.dir";
+    const std::string zipName = "mappedarchive.zip";
+    mkdir_r(dirName.c_str());
+    writeFile(dirName + "/mappedarchive_dir.txt", "from directory");
+
+    std::vector<std::string> names;
+    std::vector<std::string> contents;
+    names.push_back("mappedarchive_zip.txt");
+    contents.push_back("from archive");
+    names.push_back("mappedarchive_dir.txt");
+    contents.push_back("hidden by directory");
+    names.push_back("mappedarchive_empty.txt");
+    contents.push_back("");
+    writeZip(zipName, names, contents);
+
+    // directory ahead of archive, like updates local directory
+    EXPECT_NE(0, PHYSFS_addToSearchPath(zipName.c_str(), 0));
+    EXPECT_NE(0, PHYSFS_addToSearchPath(dirName.c_str(), 0));
+    MappedArchives::init(true);
+
+    const char *data = nullptr;
+    size_t size = 0;
+    EXPECT_TRUE(MappedArchives::getView("mappedarchive_zip.txt",
+        data, size));
+    EXPECT_EQ(12U, size);
+    EXPECT_EQ(0, memcmp("from archive", data, size));
+
+    // file in directory wins, leave it to PhysFS
+    EXPECT_FALSE(MappedArchives::getView("mappedarchive_dir.txt",
+        data, size));
+
+    // empty entries left to PhysFS
+    EXPECT_FALSE(MappedArchives::getView("mappedarchive_empty.txt",
+        data, size));
+
+    EXPECT_FALSE(MappedArchives::getView("mappedarchive_none.txt",
+        data, size));
+
+    MappedArchives::clear();
+    PHYSFS_removeFromSearchPath(dirName.c_str());
+    PHYSFS_removeFromSearchPath(zipName.c_str());
+    ::remove((dirName + "/mappedarchive_dir.txt").c_str());
+    ::remove(dirName.c_str());
+    ::remove(zipName.c_str());
+}
@@ -0,0 +1,120 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/mappedfile.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include "debug.h"
+
+MappedFile::MappedFile() :
+    mData(nullptr),
+    mSize(0),
+    mMapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &fileName)
+{
+    close();
+#ifndef WIN32
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf)
+        || !S_ISREG(statbuf.st_mode)
+        || statbuf.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(statbuf.st_size);
+    void *const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping stays valid after descriptor closed
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    mData = static_cast<const char*>(data);
+    mSize = size;
+    mMapped = true;
+    return true;
+#else  // WIN32
+
+    FILE *const file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    char *const data = static_cast<char*>(malloc(size));
+    if (!data || fread(data, 1, size, file) != static_cast<size_t>(size))
+    {
+        free(data);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    mData = data;
+    mSize = static_cast<size_t>(size);
+    mMapped = false;
+    return true;
+#endif  // WIN32
+}
+
+void MappedFile::close()
+{
+    if (!mData)
+        return;
+#ifndef WIN32
+    if (mMapped)
+        munmap(const_cast<char*>(mData), mSize);
+    else
+#endif  // WIN32
+        free(const_cast<char*>(mData));
+    mData = nullptr;
+    mSize = 0;
+    mMapped = false;
+}
@@ -0,0 +1,69 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_MAPPEDFILE_H
+#define UTILS_MAPPEDFILE_H
+
+#include <string>
+
+#include "localconsts.h"
+
+/**
+ * Read only view of whole local file. Memory mapped where supported,
+ * other platforms read file to memory.
+ */
+class MappedFile final
+{
+    public:
+        MappedFile();
+
+        A_DELETE_COPY(MappedFile)
+
+        ~MappedFile();
+
+        /**
+         * Opens regular file. Returns false for missing or empty files.
+         */
+        bool open(const std::string &fileName);
+
+        void close();
+
+        const char *getData() const A_WARN_UNUSED
+        { return mData; }
+
+        size_t getSize() const A_WARN_UNUSED
+        { return mSize; }
+
+        bool isOpen() const A_WARN_UNUSED
+        { return mData != nullptr; }
+
+        /**
+         * Returns true if file memory mapped, not copied to memory.
+         */
+        bool isMapped() const A_WARN_UNUSED
+        { return mMapped; }
+
+    private:
+        const char *mData;
+        size_t mSize;
+        bool mMapped;
+};
+
+#endif  // UTILS_MAPPEDFILE_H
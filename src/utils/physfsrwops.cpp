@@ -27,6 +27,7 @@
 #include "logger.h"
 
 #include "utils/fuzzer.h"
+#include "utils/mappedarchive.h"
 #include "utils/physfscheckutils.h"
 
 #include "debug.h"
@@ -209,6 +210,36 @@ static SDL_RWops *create_rwops(PHYSFS_file *const handle)
     return retval;
 } /* create_rwops */
 
+static int mappedrwops_close(SDL_RWops *const rw)
+{
+    SDL_FreeRW(rw);
+#ifdef DUMP_LEAKED_RESOURCES
+    if (openedRWops <= 0)
+        logger->log("closing already closed RWops");
+    openedRWops --;
+#endif
+#ifdef DEBUG_PHYSFS
+    FakePhysFSClose(rw);
+#endif
+    return 0;
+} /* mappedrwops_close */
+
+/* zero copy reader for files stored in mapped archives */
+static SDL_RWops *create_mapped_rwops(const char *const data,
+                                      const size_t size)
+{
+    SDL_RWops *const retval = SDL_RWFromConstMem(data,
+        static_cast<int>(size));
+    if (retval)
+    {
+        retval->close = &mappedrwops_close;
+#ifdef DUMP_LEAKED_RESOURCES
+        openedRWops ++;
+#endif
+    }
+    return retval;
+} /* create_mapped_rwops */
+
 SDL_RWops *PHYSFSRWOPS_makeRWops(PHYSFS_file *const handle)
 {
     SDL_RWops *retval = nullptr;
@@ -242,6 +273,14 @@ SDL_RWops *PHYSFSRWOPS_openRead(const char *const fname)
     if (Fuzzer::conditionTerminate(fname))
         return nullptr;
 #endif
+    const char *data = nullptr;
+    size_t size = 0;
+    if (fname && MappedArchives::getView(fname, data, size))
+    {
+        SDL_RWops *const ret = create_mapped_rwops(data, size);
+        BLOCK_END("PHYSFSRWOPS_openRead")
+        return ret;
+    }
 #ifdef USE_PROFILER
     SDL_RWops *const ret = create_rwops(PhysFs::openRead(fname));
     BLOCK_END("PHYSFSRWOPS_openRead")
@@ -22,6 +22,9 @@
 
 #include "logger.h"
 
+#include "utils/mappedarchive.h"
+
+#include <cstring>
 #include <iostream>
 #include <unistd.h>
 
@@ -119,12 +122,18 @@ namespace PhysFs
 
     bool addToSearchPath(const char *const newDir, const int appendToPath)
     {
-        return PHYSFS_addToSearchPath(newDir, appendToPath);
+        const bool ret = PHYSFS_addToSearchPath(newDir, appendToPath);
+        if (ret)
+            MappedArchives::update();
+        return ret;
     }
 
     bool removeFromSearchPath(const char *const oldDir)
     {
-        return PHYSFS_removeFromSearchPath(oldDir);
+        const bool ret = PHYSFS_removeFromSearchPath(oldDir);
+        if (ret)
+            MappedArchives::update();
+        return ret;
     }
 
     const char *getRealDir(const char *const filename)
@@ -139,6 +148,18 @@ namespace PhysFs
 
     void *loadFile(const std::string &fileName, int &fileSize)
     {
+        const char *data = nullptr;
+        size_t size = 0;
+        if (MappedArchives::getView(fileName, data, size))
+        {
+            logger->log("Loaded %s from mapped archive", fileName.c_str());
+            fileSize = static_cast<int>(size);
+            void *const buffer = calloc(fileSize, 1);
+            if (buffer)
+                memcpy(buffer, data, size);
+            return buffer;
+        }
+
         // Attempt to open the specified file using PhysicsFS
         PHYSFS_file *const file = PhysFs::openRead(fileName.c_str());
 
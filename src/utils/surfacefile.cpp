@@ -0,0 +1,178 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2015  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/surfacefile.h"
+
+#include "utils/sdlcheckutils.h"
+
+#include <SDL_video.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+#include "debug.h"
+
+namespace
+{
+    const uint32_t surfaceMagic = 0x4653504DU;  // "MPSF"
+    const uint32_t surfaceVersion = 1U;
+    const uint32_t flagCompressed = 1U;
+
+    struct SurfaceHeader final
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t rMask;
+        uint32_t gMask;
+        uint32_t bMask;
+        uint32_t aMask;
+        uint32_t flags;
+        uint32_t dataSize;
+    };
+}  // namespace
+
+SDL_Surface *SurfaceFile::read(FILE *const file)
+{
+    if (!file)
+        return nullptr;
+
+    SurfaceHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || header.magic != surfaceMagic
+        || header.version != surfaceVersion
+        || header.width == 0U
+        || header.height == 0U
+        || header.width > 16384U
+        || header.height > 16384U)
+    {
+        return nullptr;
+    }
+
+    const size_t rowSize = header.width * 4;
+    const size_t rawSize = rowSize * header.height;
+    const bool compressed = (header.flags & flagCompressed) != 0U;
+    if ((!compressed && header.dataSize != rawSize)
+        || header.dataSize > rawSize * 2 + 1024)
+    {
+        return nullptr;
+    }
+
+    char *const data = static_cast<char*>(malloc(header.dataSize));
+    if (!data || fread(data, 1, header.dataSize, file) != header.dataSize)
+    {
+        free(data);
+        return nullptr;
+    }
+
+    char *raw = data;
+    if (compressed)
+    {
+        raw = static_cast<char*>(malloc(rawSize));
+        uLongf destSize = static_cast<uLongf>(rawSize);
+        if (!raw || uncompress(reinterpret_cast<Bytef*>(raw), &destSize,
+            reinterpret_cast<Bytef*>(data), header.dataSize) != Z_OK
+            || destSize != rawSize)
+        {
+            free(raw);
+            free(data);
+            return nullptr;
+        }
+        free(data);
+    }
+
+    SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+        header.width, header.height, 32,
+        header.rMask, header.gMask, header.bMask, header.aMask);
+    if (surface)
+    {
+        char *const pixels = static_cast<char*>(surface->pixels);
+        for (uint32_t y = 0; y < header.height; y ++)
+        {
+            memcpy(pixels + y * surface->pitch,
+                raw + y * rowSize,
+                rowSize);
+        }
+    }
+    free(raw);
+    return surface;
+}
+
+bool SurfaceFile::write(FILE *const file,
+                        const SDL_Surface *const surface,
+                        const bool compress)
+{
+    if (!file
+        || !surface
+        || surface->format->BytesPerPixel != 4
+        || surface->w <= 0
+        || surface->h <= 0)
+    {
+        return false;
+    }
+
+    SurfaceHeader header;
+    header.magic = surfaceMagic;
+    header.version = surfaceVersion;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.rMask = surface->format->Rmask;
+    header.gMask = surface->format->Gmask;
+    header.bMask = surface->format->Bmask;
+    header.aMask = surface->format->Amask;
+    header.flags = 0U;
+
+    const size_t rowSize = surface->w * 4;
+    const size_t rawSize = rowSize * surface->h;
+    char *const raw = static_cast<char*>(malloc(rawSize));
+    if (!raw)
+        return false;
+    const char *const pixels = static_cast<const char*>(surface->pixels);
+    for (int y = 0; y < surface->h; y ++)
+        memcpy(raw + y * rowSize, pixels + y * surface->pitch, rowSize);
+
+    char *data = raw;
+    size_t dataSize = rawSize;
+    char *packed = nullptr;
+    if (compress)
+    {
+        uLongf packedSize = compressBound(static_cast<uLong>(rawSize));
+        packed = static_cast<char*>(malloc(packedSize));
+        // fast level, reading cache must be cheaper than building again
+        if (packed && compress2(reinterpret_cast<Bytef*>(packed),
+            &packedSize, reinterpret_cast<Bytef*>(raw),
+            static_cast<uLong>(rawSize), 1) == Z_OK
+            && packedSize < rawSize)
+        {
+            data = packed;
+            dataSize = packedSize;
+            header.flags |= flagCompressed;
+        }
+    }
+    header.dataSize = static_cast<uint32_t>(dataSize);
+
+    const bool written = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(data, 1, dataSize, file) == dataSize;
+    free(packed);
+    free(raw);
+    return written;
+}
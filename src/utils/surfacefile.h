@@ -1,8 +1,6 @@
 /*
  *  The ManaPlus Client
- *  Copyright (C) 2004-2009  The Mana World Development Team
- *  Copyright (C) 2009-2010  The Mana Developers
- *  Copyright (C) 2011-2015  The ManaPlus Developers
+ *  Copyright (C) 2015  The ManaPlus Developers
  *
  *  This file is part of The ManaPlus Client.
  *
@@ -20,35 +18,30 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef RESOURCES_MAP_LOCATION_H
-#define RESOURCES_MAP_LOCATION_H
+#ifndef UTILS_SURFACEFILE_H
+#define UTILS_SURFACEFILE_H
 
-#include "resources/map/metatile.h"
+#include <cstdio>
 
 #include "localconsts.h"
 
+struct SDL_Surface;
+
 /**
- * A location on a tile map. Used for pathfinding, open list.
+ * Raw 32 bit surfaces in local cache files, optionally zlib compressed.
+ * Files written in native byte order and not portable.
  */
-struct Location final
+namespace SurfaceFile
 {
     /**
-     * Constructor.
-     */
-    Location(const int px, const int py, MetaTile *const ptile) :
-        x(px), y(py), tile(ptile)
-    {}
-
-    /**
-     * Comparison operator.
+     * Reads surface from current file position. Returns nullptr on error,
+     * caller must free surface.
      */
-    bool operator< (const Location &loc) const
-    {
-        return tile->Fcost > loc.tile->Fcost;
-    }
+    SDL_Surface *read(FILE *const file) A_WARN_UNUSED;
 
-    int x, y;
-    MetaTile *tile;
-};
+    bool write(FILE *const file,
+               const SDL_Surface *const surface,
+               const bool compress);
+}  // namespace SurfaceFile
 
-#endif  // RESOURCES_MAP_LOCATION_H
+#endif  // UTILS_SURFACEFILE_H
@@ -25,6 +25,7 @@
 #include "logger.h"
 
 #include "utils/fuzzer.h"
+#include "utils/mappedarchive.h"
 #include "utils/physfstools.h"
 #include "utils/stringutils.h"
 
@@ -91,6 +92,18 @@ namespace XML
         valid = true;
         if (useResman)
         {
+            const char *view = nullptr;
+            size_t viewSize = 0;
+            if (MappedArchives::getView(filename, view, viewSize))
+            {
+                // parse without copy from mapped archive
+                mDoc = xmlParseMemory(view, static_cast<int>(viewSize));
+                if (!mDoc)
+                    logger->log("Error parsing XML file %s", filename.c_str());
+                mIsValid = valid;
+                BLOCK_END("XML::Document::Document")
+                return;
+            }
             data = static_cast<char*>(PhysFs::loadFile(
                 filename.c_str(), size));
         }